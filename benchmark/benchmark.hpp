@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+namespace env::benchmark {
+
+// Prevents the compiler from optimizing away the computation of 'value'.
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+// Minimal benchmark harness: each benchmark is calibrated to run for at least the minimum time per sample, and the
+// median and minimum time per iteration over all samples are reported as JSON.
+//
+// Command line options:
+//  --filter=<substring>  Only run benchmarks whose name contains the substring.
+//  --min-time-ms=<ms>    Minimum time per sample, defaults to 20ms.
+//  --samples=<n>         Number of samples per benchmark, defaults to 5.
+//  --output=<path>       Write the JSON results to a file instead of stdout.
+class runner {
+  public:
+	runner(const int argc, const char* const* argv)
+	{
+		for (int i = 1; i < argc; ++i) {
+			const auto arg = std::string_view(argv[i]);
+			if (const auto value = option_value(arg, "--filter="); !value.empty()) {
+				m_filter = value;
+			} else if (const auto value = option_value(arg, "--min-time-ms="); !value.empty()) {
+				m_min_sample_time = std::chrono::milliseconds(std::atoi(std::string(value).c_str()));
+			} else if (const auto value = option_value(arg, "--samples="); !value.empty()) {
+				m_samples = std::max(1, std::atoi(std::string(value).c_str()));
+			} else if (const auto value = option_value(arg, "--output="); !value.empty()) {
+				m_output = value;
+			} else {
+				std::cerr << "Unknown option '" << arg << "'" << std::endl;
+				std::exit(EXIT_FAILURE);
+			}
+		}
+	}
+
+	// Runs 'fn(state)' repeatedly, where each iteration gets its own state created by 'setup()'. Creating the state is
+	// not included in the measured time, which allows benchmarking operations that consume their input.
+	template <typename SetupFn, typename Fn>
+	void run(const std::string& name, SetupFn&& setup, Fn&& fn)
+	{
+		if (name.find(m_filter) == std::string::npos) {
+			return;
+		}
+
+		using state_t = decltype(setup());
+		const auto time_batch = [&](const std::size_t iterations) {
+			auto states = std::vector<state_t>{};
+			states.reserve(iterations);
+			for (std::size_t i = 0; i < iterations; ++i) {
+				states.push_back(setup());
+			}
+			const auto start = clock::now();
+			for (auto& state : states) {
+				fn(state);
+			}
+			return clock::now() - start;
+		};
+
+		auto iterations = std::size_t{1};
+		while (time_batch(iterations) < m_min_sample_time && iterations < max_iterations) {
+			iterations *= 2;
+		}
+
+		auto ns_per_iteration = std::vector<double>{};
+		for (int sample = 0; sample < m_samples; ++sample) {
+			const auto elapsed = std::chrono::duration<double, std::nano>(time_batch(iterations)).count();
+			ns_per_iteration.push_back(elapsed / static_cast<double>(iterations));
+		}
+		std::sort(ns_per_iteration.begin(), ns_per_iteration.end());
+
+		auto result = benchmark_result{name, iterations, ns_per_iteration[ns_per_iteration.size() / 2],
+		                               ns_per_iteration.front()};
+		std::cerr << fmt::format("{:<64} {:>14.1f} ns {:>12} iterations\n", result.m_name, result.m_median_ns,
+		                         result.m_iterations);
+		m_results.push_back(std::move(result));
+	}
+
+	template <typename Fn>
+	void run(const std::string& name, Fn&& fn)
+	{
+		run(name, [] { return 0; }, [&fn](int) { fn(); });
+	}
+
+	// Writes the results, returns the exit code of the benchmark program.
+	[[nodiscard]] int finish() const
+	{
+		auto json = std::string("{\n\t\"benchmarks\": [");
+		for (std::size_t i = 0; i < m_results.size(); ++i) {
+			const auto& result = m_results[i];
+			json += fmt::format("{}\n\t\t{{\"name\": \"{}\", \"iterations\": {}, \"samples\": {}, "
+			                    "\"median_ns\": {:.3f}, \"min_ns\": {:.3f}}}",
+			                    i == 0 ? "" : ",", result.m_name, result.m_iterations, m_samples, result.m_median_ns,
+			                    result.m_min_ns);
+		}
+		json += "\n\t]\n}\n";
+
+		if (m_output.empty()) {
+			std::cout << json;
+			return EXIT_SUCCESS;
+		}
+		auto file = std::ofstream(m_output, std::ios::binary | std::ios::trunc);
+		file << json;
+		if (!file) {
+			std::cerr << "Failed to write '" << m_output << "'" << std::endl;
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
+
+  private:
+	using clock = std::chrono::steady_clock;
+
+	static constexpr auto max_iterations = std::size_t{1} << 24;
+
+	struct benchmark_result {
+		std::string m_name;
+		std::size_t m_iterations;
+		double m_median_ns;
+		double m_min_ns;
+	};
+
+	[[nodiscard]] static std::string_view option_value(const std::string_view arg, const std::string_view option)
+	{
+		return arg.substr(0, option.size()) == option ? arg.substr(option.size()) : std::string_view();
+	}
+
+	std::string m_filter;
+	std::chrono::nanoseconds m_min_sample_time = std::chrono::milliseconds(20);
+	int m_samples = 5;
+	std::string m_output;
+	std::vector<benchmark_result> m_results;
+};
+
+} // namespace env::benchmark
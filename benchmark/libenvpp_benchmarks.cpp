@@ -0,0 +1,152 @@
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <libenvpp/detail/levenshtein.hpp>
+#include <libenvpp/detail/parser.hpp>
+#include <libenvpp/env.hpp>
+
+#include "benchmark.hpp"
+
+namespace {
+
+using environment_t = std::unordered_map<std::string, std::string>;
+
+constexpr auto PREFIX_NAME = std::string_view("LIBENVPP_BENCHMARK");
+
+[[nodiscard]] std::string variable_name(const std::size_t i)
+{
+	return fmt::format("VARIABLE_{}", i);
+}
+
+// Environment containing values for the first 'var_count' variables of the prefix, filled up with unrelated variables
+// to 'env_size' entries. If 'with_typos' is set, the names of the prefix variables are misspelled instead.
+[[nodiscard]] environment_t make_environment(const std::size_t var_count, const std::size_t env_size,
+                                             const bool with_typos = false)
+{
+	auto environment = environment_t{};
+	for (std::size_t i = 0; i < var_count && i < env_size; ++i) {
+		auto name = fmt::format("{}_{}", PREFIX_NAME, variable_name(i));
+		if (with_typos) {
+			std::swap(name[PREFIX_NAME.size() + 1], name[PREFIX_NAME.size() + 2]);
+		}
+		environment.emplace(std::move(name), std::to_string(i));
+	}
+	for (auto i = environment.size(); i < env_size; ++i) {
+		environment.emplace(fmt::format("UNRELATED_ENVIRONMENT_VARIABLE_{}", i), "/usr/local/bin:/usr/bin:/bin");
+	}
+	return environment;
+}
+
+[[nodiscard]] env::prefix make_prefix(const std::size_t var_count, const bool required = false)
+{
+	auto pre = env::prefix(PREFIX_NAME);
+	for (std::size_t i = 0; i < var_count; ++i) {
+		if (required) {
+			[[maybe_unused]] const auto id = pre.register_required_variable<int>(variable_name(i));
+		} else {
+			[[maybe_unused]] const auto id = pre.register_variable<int>(variable_name(i));
+		}
+	}
+	return pre;
+}
+
+void benchmark_parse_and_validate(env::benchmark::runner& runner)
+{
+	for (const auto var_count : {1, 10, 100, 1000}) {
+		for (const auto env_size : {10, 100, 1000, 10000}) {
+			const auto environment = make_environment(var_count, env_size);
+			runner.run(
+			    fmt::format("parse_and_validate/vars:{}/env:{}", var_count, env_size),
+			    [&] { return make_prefix(var_count); },
+			    [&](env::prefix& pre) { env::benchmark::do_not_optimize(pre.parse_and_validate(environment)); });
+		}
+	}
+
+	for (const auto var_count : {1, 10, 100}) {
+		for (const auto env_size : {100, 1000, 10000}) {
+			const auto environment = make_environment(var_count, env_size, true);
+			runner.run(
+			    fmt::format("parse_and_validate_typos/vars:{}/env:{}", var_count, env_size),
+			    [&] { return make_prefix(var_count, true); },
+			    [&](env::prefix& pre) { env::benchmark::do_not_optimize(pre.parse_and_validate(environment)); });
+		}
+	}
+
+	for (const auto var_count : {1, 10, 100, 1000}) {
+		runner.run(fmt::format("register_variable/vars:{}", var_count),
+		           [&] { env::benchmark::do_not_optimize(make_prefix(var_count)); });
+	}
+}
+
+void benchmark_get(env::benchmark::runner& runner)
+{
+	for (const auto env_size : {10, 100, 1000, 10000}) {
+		const auto _ = env::scoped_test_environment(make_environment(1, env_size));
+		const auto name = fmt::format("{}_{}", PREFIX_NAME, variable_name(0));
+		const auto typo_name = fmt::format("{}_{}", PREFIX_NAME, "VARAIBLE_0");
+		runner.run(fmt::format("get/env:{}", env_size),
+		           [&] { env::benchmark::do_not_optimize(env::get<int>(name)); });
+		runner.run(fmt::format("get_typo/env:{}", env_size),
+		           [&] { env::benchmark::do_not_optimize(env::get<int>(typo_name)); });
+		runner.run(fmt::format("get_or/env:{}", env_size),
+		           [&] { env::benchmark::do_not_optimize(env::get_or<int>(name, 0)); });
+	}
+}
+
+template <typename T>
+void benchmark_construct_from_string(env::benchmark::runner& runner, const std::string_view type_name,
+                                     const std::string_view input)
+{
+	runner.run(fmt::format("construct_from_string/{}", type_name),
+	           [&] { env::benchmark::do_not_optimize(env::detail::construct_from_string<T>(input)); });
+}
+
+void benchmark_construct_from_string(env::benchmark::runner& runner)
+{
+	benchmark_construct_from_string<bool>(runner, "bool", "true");
+	benchmark_construct_from_string<bool>(runner, "bool_word", "yes");
+	benchmark_construct_from_string<char>(runner, "char", "c");
+	benchmark_construct_from_string<short>(runner, "short", "-1234");
+	benchmark_construct_from_string<int>(runner, "int", "-123456");
+	benchmark_construct_from_string<unsigned int>(runner, "unsigned_int", "123456");
+	benchmark_construct_from_string<long long>(runner, "long_long", "-1234567890123");
+	benchmark_construct_from_string<unsigned long long>(runner, "unsigned_long_long", "1234567890123");
+	benchmark_construct_from_string<float>(runner, "float", "3.1415");
+	benchmark_construct_from_string<double>(runner, "double", "2.718281828459045");
+	benchmark_construct_from_string<std::string>(runner, "string", "Hello World");
+	benchmark_construct_from_string<std::filesystem::path>(runner, "path", "/usr/local/share/libenvpp/config");
+}
+
+void benchmark_levenshtein(env::benchmark::runner& runner)
+{
+	for (const auto length : {8, 32, 128}) {
+		const auto lhs = std::string(static_cast<std::size_t>(length), 'a');
+		auto rhs = lhs;
+		rhs[rhs.size() / 2] = 'b';
+		const auto unrelated = std::string(static_cast<std::size_t>(length), 'z');
+		runner.run(fmt::format("levenshtein_distance/length:{}", length),
+		           [&] { env::benchmark::do_not_optimize(levenshtein::distance(lhs, rhs)); });
+		runner.run(fmt::format("levenshtein_distance_cutoff/length:{}", length),
+		           [&] { env::benchmark::do_not_optimize(levenshtein::distance(lhs, unrelated, 3)); });
+	}
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	auto runner = env::benchmark::runner(argc, argv);
+
+	benchmark_parse_and_validate(runner);
+	benchmark_get(runner);
+	benchmark_construct_from_string(runner);
+	benchmark_levenshtein(runner);
+
+	return runner.finish();
+}
@@ -0,0 +1,58 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include <libenvpp/env.hpp>
+
+#if LIBENVPP_COROUTINES_ENABLED
+
+// Stands in for a validator querying a remote service, e.g. checking that a license key is valid, which spends most of
+// its time waiting and can therefore run concurrently with other validators on a single thread.
+env::task<std::string> license_key(const std::string_view str)
+{
+	co_await env::sleep_for(std::chrono::milliseconds(100));
+	if (str.size() != 16) {
+		throw env::validation_error{"License key must be 16 characters long"};
+	}
+	co_return std::string(str);
+}
+
+int main()
+{
+	auto pre = env::prefix("MYPROG");
+
+	const auto license_key_id = pre.register_required_variable<std::string>("LICENSE_KEY", license_key);
+	const auto backup_license_key_id = pre.register_variable<std::string>("BACKUP_LICENSE_KEY", license_key);
+	const auto num_threads_id = pre.register_required_range<unsigned int>("NUM_THREADS", 1, 64);
+
+	pre.set_timeout(backup_license_key_id, std::chrono::seconds(1));
+
+	const auto parsed_and_validated_pre = pre.parse_and_validate_async(std::chrono::seconds(2));
+
+	if (parsed_and_validated_pre.ok()) {
+		const auto license_key = parsed_and_validated_pre.get(license_key_id);
+		const auto backup_license_key = parsed_and_validated_pre.get_or(backup_license_key_id, "none");
+		const auto num_threads = parsed_and_validated_pre.get(num_threads_id);
+
+		std::cout << "License key       : " << license_key << std::endl;
+		std::cout << "Backup license key: " << backup_license_key << std::endl;
+		std::cout << "Num threads       : " << num_threads << std::endl;
+	} else {
+		std::cout << parsed_and_validated_pre.warning_message();
+		std::cout << parsed_and_validated_pre.error_message();
+	}
+
+	return EXIT_SUCCESS;
+}
+
+#else
+
+int main()
+{
+	std::cout << "Asynchronous validation requires a compiler supporting C++20 coroutines" << std::endl;
+	return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,31 @@
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+
+#include <libenvpp/env.hpp>
+
+int main()
+{
+	auto pre = env::prefix("MYPROG");
+
+	const auto num_threads_id = pre.register_required_range<unsigned int>("NUM_THREADS", 1, 64);
+	const auto log_level_id = pre.register_option<std::string>("LOG_LEVEL", {"debug", "info", "error"});
+
+	// The cache belongs in a directory only the user can write to, as the cached values are used without being parsed.
+	const auto* const home = std::getenv("HOME");
+	const auto cache = env::config_cache(std::filesystem::path(home ? home : ".") / ".myprog_config.cache");
+	const auto parsed_and_validated_pre = pre.parse_and_validate(cache);
+
+	if (parsed_and_validated_pre.ok()) {
+		const auto num_threads = parsed_and_validated_pre.get(num_threads_id);
+		const auto log_level = parsed_and_validated_pre.get_or(log_level_id, "info");
+
+		std::cout << "Num threads: " << num_threads << std::endl;
+		std::cout << "Log level:   " << log_level << std::endl;
+	} else {
+		std::cout << parsed_and_validated_pre.warning_message();
+		std::cout << parsed_and_validated_pre.error_message();
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,20 @@
+#include <cstdlib>
+#include <iostream>
+
+#include <myprog_config.hpp>
+
+int main()
+{
+	const auto parsed_config = myprog::parse_config();
+
+	if (parsed_config.ok()) {
+		const auto& config = parsed_config.get();
+		std::cout << "Log path   : " << config.log_file_path.value_or("/default/log/path").string() << std::endl;
+		std::cout << "Num threads: " << config.num_threads << std::endl;
+	} else {
+		std::cout << parsed_config.warning_message();
+		std::cout << parsed_config.error_message();
+	}
+
+	return EXIT_SUCCESS;
+}
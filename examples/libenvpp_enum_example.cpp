@@ -0,0 +1,33 @@
+#include <cstdlib>
+#include <iostream>
+
+#include <libenvpp/env.hpp>
+
+enum class compression {
+	none,
+	fast,
+	best,
+};
+
+int main()
+{
+	auto pre = env::prefix("MYPROG");
+
+	// E.g. 'MYPROG_COMPRESSION=fast', or 'MYPROG_COMPRESSION=FAST' since the names are case-insensitive.
+	const auto compression_id = pre.register_enum<compression>(
+	    "COMPRESSION", {{"none", compression::none}, {"fast", compression::fast}, {"best", compression::best}},
+	    env::case_sensitivity::insensitive);
+
+	const auto parsed_and_validated_pre = pre.parse_and_validate();
+
+	if (parsed_and_validated_pre.ok()) {
+		const auto level = parsed_and_validated_pre.get_or(compression_id, compression::fast);
+
+		std::cout << "Compression: " << static_cast<int>(level) << std::endl;
+	} else {
+		std::cout << parsed_and_validated_pre.warning_message();
+		std::cout << parsed_and_validated_pre.error_message();
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,43 @@
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string_view>
+
+#include <libenvpp/env.hpp>
+
+// Validation which accesses the file system, and is therefore worth running concurrently.
+std::filesystem::path existing_directory(const std::string_view str)
+{
+	const auto path = std::filesystem::path(str);
+	if (!std::filesystem::is_directory(path)) {
+		throw env::validation_error{"Path must be an existing directory"};
+	}
+	return path;
+}
+
+int main()
+{
+	auto pre = env::prefix("MYPROG");
+
+	const auto data_dir_id = pre.register_required_variable<std::filesystem::path>("DATA_DIR", existing_directory);
+	const auto cache_dir_id = pre.register_variable<std::filesystem::path>("CACHE_DIR", existing_directory);
+	const auto num_threads_id = pre.register_required_range<unsigned int>("NUM_THREADS", 1, 64);
+
+	auto pool = env::thread_pool(4);
+	const auto parsed_and_validated_pre = pre.parse_and_validate(pool);
+
+	if (parsed_and_validated_pre.ok()) {
+		const auto data_dir = parsed_and_validated_pre.get(data_dir_id);
+		const auto cache_dir = parsed_and_validated_pre.get_or(cache_dir_id, std::filesystem::temp_directory_path());
+		const auto num_threads = parsed_and_validated_pre.get(num_threads_id);
+
+		std::cout << "Data dir   : " << data_dir << std::endl;
+		std::cout << "Cache dir  : " << cache_dir << std::endl;
+		std::cout << "Num threads: " << num_threads << std::endl;
+	} else {
+		std::cout << parsed_and_validated_pre.warning_message();
+		std::cout << parsed_and_validated_pre.error_message();
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string_view>
+
+#include <fmt/core.h>
+
+#include <libenvpp/env.hpp>
+
+#if LIBENVPP_INSTRUMENTATION_ENABLED
+void print_phase(const std::string_view phase, const env::phase_stats& stats)
+{
+	std::cout << fmt::format("  {:<24} {:>10} ns {:>6} allocations\n", phase, stats.duration.count(),
+	                         stats.allocations);
+}
+
+void print_stats(const env::parse_stats& stats)
+{
+	std::cout << fmt::format("Parsed prefix '{}'{}:\n", stats.prefix_name, stats.cache_hit ? " from cache" : "");
+	print_phase("environment", stats.environment);
+	print_phase("cache", stats.cache);
+	print_phase("parse", stats.parse);
+	print_phase("typo detection", stats.typo_detection);
+	print_phase("unused detection", stats.unused_detection);
+	print_phase("total", stats.total);
+	for (const auto& var_stats : stats.variables) {
+		print_phase(var_stats.name, var_stats.parse);
+	}
+}
+#endif
+
+int main()
+{
+#if LIBENVPP_INSTRUMENTATION_ENABLED
+	env::set_parse_observer(print_stats);
+#else
+	std::cout << "Configure with LIBENVPP_INSTRUMENTATION=ON to print the statistics of parsing" << std::endl;
+#endif
+
+	auto pre = env::prefix("MYPROG");
+
+	const auto log_path_id = pre.register_variable<std::filesystem::path>("LOG_FILE_PATH");
+	const auto num_threads_id = pre.register_required_range<unsigned int>("NUM_THREADS", 1, 64);
+
+	const auto parsed_and_validated_pre = pre.parse_and_validate();
+
+	if (parsed_and_validated_pre.ok()) {
+		const auto log_path = parsed_and_validated_pre.get_or(log_path_id, "/default/log/path");
+		const auto num_threads = parsed_and_validated_pre.get(num_threads_id);
+
+		std::cout << "Log path   : " << log_path << std::endl;
+		std::cout << "Num threads: " << num_threads << std::endl;
+	} else {
+		std::cout << parsed_and_validated_pre.warning_message();
+		std::cout << parsed_and_validated_pre.error_message();
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,33 @@
+#include <cstdlib>
+#include <iostream>
+
+#include <libenvpp/env.hpp>
+
+int main(int argc, char* argv[])
+{
+	auto pre = env::prefix("MYPROG");
+
+	const auto num_threads_id = pre.register_required_variable<unsigned int>("NUM_THREADS");
+	const auto log_level_id = pre.register_required_variable<std::string>("LOG_LEVEL");
+
+	const auto cmd_line = env::command_line_source(argc, argv);
+	const auto environment = env::environment_source();
+	const auto defaults = env::map_source("defaults", {{"NUM_THREADS", "4"}, {"LOG_LEVEL", "info"}});
+
+	const auto parsed_and_validated_pre = pre.parse_and_validate({cmd_line, environment, defaults});
+
+	if (parsed_and_validated_pre.ok()) {
+		const auto num_threads = parsed_and_validated_pre.get(num_threads_id);
+		const auto log_level = parsed_and_validated_pre.get(log_level_id);
+
+		std::cout << "Num threads: " << num_threads << " (from " << *parsed_and_validated_pre.get_source(num_threads_id)
+		          << ")" << std::endl;
+		std::cout << "Log level  : " << log_level << " (from " << *parsed_and_validated_pre.get_source(log_level_id)
+		          << ")" << std::endl;
+	} else {
+		std::cout << parsed_and_validated_pre.warning_message();
+		std::cout << parsed_and_validated_pre.error_message();
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,37 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <libenvpp/env.hpp>
+
+int main()
+{
+	auto pre = env::prefix("MYPROG");
+
+	// E.g. 'MYPROG_PEERS=a:1,b:2,c:3' and 'MYPROG_CPU_SET=0,2,4-7'.
+	const auto peers_id = pre.register_variable<std::vector<std::string>>("PEERS");
+	const auto cpu_set_id = pre.register_variable<std::vector<unsigned int>>("CPU_SET");
+	// E.g. 'MYPROG_PLUGIN_PATH=/usr/lib/myprog:/opt/myprog'.
+	const auto plugin_path_id =
+	    pre.register_variable<std::vector<std::string>>("PLUGIN_PATH", env::list_parser<std::string, ':'>{});
+
+	const auto parsed_and_validated_pre = pre.parse_and_validate();
+
+	if (parsed_and_validated_pre.ok()) {
+		for (const auto& peer : parsed_and_validated_pre.get_or(peers_id, {})) {
+			std::cout << "Peer: " << peer << std::endl;
+		}
+		for (const auto cpu : parsed_and_validated_pre.get_or(cpu_set_id, {0})) {
+			std::cout << "CPU: " << cpu << std::endl;
+		}
+		for (const auto& path : parsed_and_validated_pre.get_or(plugin_path_id, {})) {
+			std::cout << "Plugin path: " << path << std::endl;
+		}
+	} else {
+		std::cout << parsed_and_validated_pre.warning_message();
+		std::cout << parsed_and_validated_pre.error_message();
+	}
+
+	return EXIT_SUCCESS;
+}
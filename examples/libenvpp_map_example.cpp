@@ -0,0 +1,33 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+#include <libenvpp/env.hpp>
+
+int main()
+{
+	auto pre = env::prefix("MYPROG");
+
+	// E.g. 'MYPROG_LABELS=region=eu,tier=gold'.
+	const auto labels_id = pre.register_variable<std::unordered_map<std::string, std::string>>("LABELS");
+	// E.g. 'MYPROG_TENANT_LIMITS=tenant_a:10;tenant_b:5'.
+	const auto limits_id = pre.register_variable<env::flat_map<std::string, unsigned int>>(
+	    "TENANT_LIMITS", env::flat_map_parser<std::string, unsigned int, ';', ':'>{});
+
+	const auto parsed_and_validated_pre = pre.parse_and_validate();
+
+	if (parsed_and_validated_pre.ok()) {
+		for (const auto& [key, value] : parsed_and_validated_pre.get_or(labels_id, {})) {
+			std::cout << "Label " << key << ": " << value << std::endl;
+		}
+		const auto limits = parsed_and_validated_pre.get_or(limits_id, {});
+		const auto* const limit = env::flat_map_find(limits, "tenant_a");
+		std::cout << "Limit of tenant_a: " << (limit ? *limit : 1) << std::endl;
+	} else {
+		std::cout << parsed_and_validated_pre.warning_message();
+		std::cout << parsed_and_validated_pre.error_message();
+	}
+
+	return EXIT_SUCCESS;
+}
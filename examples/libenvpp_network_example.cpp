@@ -0,0 +1,36 @@
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <libenvpp/env.hpp>
+
+int main()
+{
+	auto pre = env::prefix("MYPROG");
+
+	// E.g. 'MYPROG_LISTEN=[::1]:8443', 'MYPROG_UPSTREAM=10.0.0.5:9000' and 'MYPROG_ALLOWED=10.0.0.0/8,fd00::/8'.
+	const auto listen_id = pre.register_required_variable<env::endpoint>("LISTEN");
+	const auto upstream_id = pre.register_variable<env::endpoint>("UPSTREAM");
+	const auto allowed_id = pre.register_variable<std::vector<env::cidr>>("ALLOWED");
+
+	const auto parsed_and_validated_pre = pre.parse_and_validate();
+
+	if (parsed_and_validated_pre.ok()) {
+		const auto listen = parsed_and_validated_pre.get(listen_id);
+		const auto upstream =
+		    parsed_and_validated_pre.get_or(upstream_id, env::endpoint{env::ip_address::v4({127, 0, 0, 1}), 9000});
+		const auto allowed = parsed_and_validated_pre.get_or(allowed_id, {});
+
+		std::cout << fmt::format("Listening on {}, forwarding to {}", listen, upstream) << std::endl;
+		for (const auto& network : allowed) {
+			std::cout << fmt::format("Allowing {}", network) << std::endl;
+		}
+	} else {
+		std::cout << parsed_and_validated_pre.warning_message();
+		std::cout << parsed_and_validated_pre.error_message();
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,29 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <libenvpp/env.hpp>
+
+int main()
+{
+	auto pre = env::prefix("MYPROG");
+
+	// The patterns are compiled once, here, and not on every parse.
+	const auto tenant_id = pre.register_required_pattern("TENANT", "tenant-\\d{4}");
+	const auto role_arn_id = pre.register_pattern("ROLE_ARN", "arn:aws:iam::\\d{12}:role/[\\w+=,.@-]+");
+
+	const auto parsed_and_validated_pre = pre.parse_and_validate();
+
+	if (parsed_and_validated_pre.ok()) {
+		const auto tenant = parsed_and_validated_pre.get(tenant_id);
+		const auto role_arn = parsed_and_validated_pre.get_or(role_arn_id, "none");
+
+		std::cout << "Tenant: " << tenant << std::endl;
+		std::cout << "Role: " << role_arn << std::endl;
+	} else {
+		std::cout << parsed_and_validated_pre.warning_message();
+		std::cout << parsed_and_validated_pre.error_message();
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,28 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <libenvpp/env.hpp>
+
+int main()
+{
+	auto pre = env::prefix("MYPROG");
+
+	const auto db_user_id = pre.register_required_variable<std::string>("DB_USER");
+	const auto db_password_id = pre.register_required_secret<std::string>("DB_PASSWORD");
+
+	const auto parsed_and_validated_pre = pre.parse_and_validate();
+
+	if (parsed_and_validated_pre.ok()) {
+		const auto db_user = parsed_and_validated_pre.get(db_user_id);
+		const auto db_password = parsed_and_validated_pre.get(db_password_id);
+
+		std::cout << "Connecting as '" << db_user << "' with a " << db_password.size() << " character password"
+		          << std::endl;
+	} else {
+		std::cout << parsed_and_validated_pre.warning_message();
+		std::cout << parsed_and_validated_pre.error_message();
+	}
+
+	return EXIT_SUCCESS;
+}
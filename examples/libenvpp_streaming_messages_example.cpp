@@ -0,0 +1,39 @@
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+
+#include <fmt/format.h>
+
+#include <libenvpp/env.hpp>
+
+int main()
+{
+	auto pre = env::prefix("MYPROG");
+
+	const auto log_path_id = pre.register_variable<std::filesystem::path>("LOG_FILE_PATH");
+	const auto num_threads_id = pre.register_required_variable<unsigned int>("NUM_THREADS");
+
+	const auto parsed_and_validated_pre = pre.parse_and_validate();
+
+	if (parsed_and_validated_pre.ok()) {
+		const auto log_path = parsed_and_validated_pre.get_or(log_path_id, "/default/log/path");
+		const auto num_threads = parsed_and_validated_pre.get(num_threads_id);
+
+		std::cout << "Log path   : " << log_path << std::endl;
+		std::cout << "Num threads: " << num_threads << std::endl;
+	} else {
+		// Collect all messages in one buffer, which is grown at most once per message.
+		auto buffer = fmt::memory_buffer();
+		parsed_and_validated_pre.warning_message(buffer);
+		parsed_and_validated_pre.error_message(buffer);
+		std::fwrite(buffer.data(), 1, buffer.size(), stderr);
+
+		// Stream the help message to stderr without building it in memory first.
+		parsed_and_validated_pre.help_message(std::ostreambuf_iterator<char>(std::cerr));
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,42 @@
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string_view>
+
+#include <libenvpp/env.hpp>
+
+// Parses the configuration and returns the certificate, which remains valid after the parsed and validated prefix is
+// destroyed.
+std::optional<env::string_ref> read_config()
+{
+	auto pre = env::prefix("MYPROG");
+
+	const auto certificate_id = pre.register_required_variable<env::string_ref>("CERTIFICATE");
+	const auto config_id = pre.register_variable<std::string_view>("CONFIG");
+
+	const auto parsed_and_validated_pre = pre.parse_and_validate();
+
+	if (!parsed_and_validated_pre.ok()) {
+		std::cout << parsed_and_validated_pre.warning_message();
+		std::cout << parsed_and_validated_pre.error_message();
+		return std::nullopt;
+	}
+
+	// The view is only valid as long as 'parsed_and_validated_pre'.
+	const auto config = parsed_and_validated_pre.get_or(config_id, "{}");
+	std::cout << "Config: " << config << std::endl;
+
+	return parsed_and_validated_pre.get(certificate_id);
+}
+
+int main()
+{
+	const auto certificate = read_config();
+	if (!certificate.has_value()) {
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "Certificate of " << certificate->size() << " bytes" << std::endl;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,31 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include <libenvpp/env.hpp>
+
+using namespace std::chrono_literals;
+
+int main()
+{
+	auto pre = env::prefix("MYPROG");
+
+	// E.g. 'MYPROG_TIMEOUT=250ms' and 'MYPROG_CACHE=4GiB'.
+	const auto timeout_id = pre.register_range<std::chrono::milliseconds>("TIMEOUT", 1ms, 1min);
+	const auto cache_id = pre.register_variable<env::byte_size>("CACHE");
+
+	const auto parsed_and_validated_pre = pre.parse_and_validate();
+
+	if (parsed_and_validated_pre.ok()) {
+		const auto timeout = parsed_and_validated_pre.get_or(timeout_id, 500ms);
+		const auto cache = parsed_and_validated_pre.get_or(cache_id, env::byte_size{64 << 20});
+
+		std::cout << "Timeout: " << timeout.count() << " ms" << std::endl;
+		std::cout << "Cache: " << cache.count() << " bytes" << std::endl;
+	} else {
+		std::cout << parsed_and_validated_pre.warning_message();
+		std::cout << parsed_and_validated_pre.error_message();
+	}
+
+	return EXIT_SUCCESS;
+}
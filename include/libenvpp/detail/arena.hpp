@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace env::detail {
+
+// Stores strings back to back in large blocks. Blocks are never reallocated, so views of stored strings remain valid
+// until the arena is destroyed, also if it is moved.
+class string_arena {
+  public:
+	static constexpr auto BLOCK_SIZE = std::size_t{4096};
+
+	string_arena() = default;
+
+	string_arena(const string_arena&) = delete;
+	string_arena(string_arena&&) = default;
+
+	string_arena& operator=(const string_arena&) = delete;
+	string_arena& operator=(string_arena&&) = default;
+
+	// Stores the concatenation of 'parts' and returns a view of it.
+	[[nodiscard]] std::string_view store(const std::initializer_list<std::string_view> parts)
+	{
+		auto size = std::size_t{0};
+		for (const auto part : parts) {
+			size += part.size();
+		}
+		if (m_blocks.empty() || m_used + size > m_block_size) {
+			m_block_size = std::max(BLOCK_SIZE, size);
+			m_blocks.push_back(std::make_unique<char[]>(m_block_size));
+			m_used = 0;
+		}
+		auto* const str = m_blocks.back().get() + m_used;
+		auto* end = str;
+		for (const auto part : parts) {
+			end = std::copy(part.begin(), part.end(), end);
+		}
+		m_used += size;
+		return {str, size};
+	}
+
+  private:
+	std::vector<std::unique_ptr<char[]>> m_blocks;
+	std::size_t m_block_size = 0;
+	std::size_t m_used = 0;
+};
+
+} // namespace env::detail
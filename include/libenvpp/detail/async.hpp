@@ -0,0 +1,464 @@
+#pragma once
+
+#include <chrono>
+#include <type_traits>
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+#define LIBENVPP_COROUTINES_ENABLED 1
+#else
+#define LIBENVPP_COROUTINES_ENABLED 0
+#endif
+
+#if LIBENVPP_COROUTINES_ENABLED
+#include <algorithm>
+#include <any>
+#include <climits>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if LIBENVPP_PLATFORM_UNIX
+#include <cerrno>
+
+#include <poll.h>
+#endif
+
+#include <libenvpp/detail/errors.hpp>
+#endif
+
+namespace env {
+
+// Time after which the asynchronous validation of a variable fails, unless set per variable with 'set_timeout'.
+inline constexpr auto default_async_timeout = std::chrono::milliseconds{5000};
+
+namespace detail {
+
+// Detects asynchronous parsers and validators in every language mode, so that registering a variable is the same code
+// whether or not coroutines are enabled. Only 'env::task' is a task, which requires them.
+template <typename>
+struct is_task : std::false_type {};
+
+template <typename T>
+inline constexpr auto is_task_v = is_task<T>::value;
+
+} // namespace detail
+
+#if LIBENVPP_COROUTINES_ENABLED
+
+template <typename T>
+class task;
+
+namespace detail {
+
+struct task_access;
+
+// Single-threaded event loop, which resumes coroutines once the time or file descriptor they wait for is ready.
+// Every coroutine belongs to an owner, which is the task it was started from, so that all waits of a task can be
+// cancelled when it times out.
+class event_loop {
+  public:
+	using clock = std::chrono::steady_clock;
+
+	event_loop() : m_previous(t_current) { t_current = this; }
+
+	event_loop(const event_loop&) = delete;
+	event_loop(event_loop&&) = delete;
+
+	event_loop& operator=(const event_loop&) = delete;
+	event_loop& operator=(event_loop&&) = delete;
+
+	~event_loop() { t_current = m_previous; }
+
+	// The innermost event loop of the calling thread.
+	[[nodiscard]] static event_loop& current()
+	{
+		if (!t_current) {
+			throw std::logic_error("Awaiting outside of an event loop, tasks must be run by libenvpp");
+		}
+		return *t_current;
+	}
+
+	void schedule(const std::coroutine_handle<> handle, const std::size_t owner) { m_ready.push_back({handle, owner}); }
+
+	void wait_until(const clock::time_point time, const std::coroutine_handle<> handle)
+	{
+		m_timers.push_back({{handle, m_current_owner}, time});
+	}
+
+#if LIBENVPP_PLATFORM_UNIX
+	void wait_for_fd(const int fd, const short events, const std::coroutine_handle<> handle)
+	{
+		m_fd_waits.push_back({{handle, m_current_owner}, fd, events});
+	}
+#endif
+
+	void cancel(const std::size_t owner)
+	{
+		const auto is_owned = [owner](const waiter& w) { return w.m_owner == owner; };
+		m_ready.erase(std::remove_if(m_ready.begin(), m_ready.end(), is_owned), m_ready.end());
+		m_timers.erase(std::remove_if(m_timers.begin(), m_timers.end(), is_owned), m_timers.end());
+#if LIBENVPP_PLATFORM_UNIX
+		m_fd_waits.erase(std::remove_if(m_fd_waits.begin(), m_fd_waits.end(), is_owned), m_fd_waits.end());
+#endif
+	}
+
+	// Resumes all ready coroutines, waiting for at least one to become ready until 'deadline' if there are none.
+	void run_once(const clock::time_point deadline)
+	{
+		if (m_ready.empty()) {
+			wait(deadline);
+		}
+		auto ready = std::vector<waiter>{};
+		ready.swap(m_ready);
+		for (const auto& entry : ready) {
+			m_current_owner = entry.m_owner;
+			entry.m_handle.resume();
+		}
+	}
+
+  private:
+	struct waiter {
+		std::coroutine_handle<> m_handle;
+		std::size_t m_owner;
+	};
+
+	struct timer : waiter {
+		clock::time_point m_time;
+	};
+
+#if LIBENVPP_PLATFORM_UNIX
+	struct fd_wait : waiter {
+		int m_fd;
+		short m_events;
+	};
+#endif
+
+	void wait(const clock::time_point deadline)
+	{
+		auto wake_up = deadline;
+		for (const auto& entry : m_timers) {
+			wake_up = std::min(wake_up, entry.m_time);
+		}
+
+#if LIBENVPP_PLATFORM_UNIX
+		if (!m_fd_waits.empty()) {
+			auto fds = std::vector<pollfd>{};
+			for (const auto& entry : m_fd_waits) {
+				fds.push_back({entry.m_fd, entry.m_events, 0});
+			}
+			const auto timeout = std::chrono::ceil<std::chrono::milliseconds>(wake_up - clock::now()).count();
+			const auto res = ::poll(fds.data(), fds.size(), static_cast<int>(std::clamp<decltype(timeout)>(
+			                                                    timeout, wake_up == clock::time_point::max() ? -1 : 0,
+			                                                    INT_MAX)));
+			if (res < 0 && errno != EINTR) {
+				throw std::system_error(errno, std::generic_category(), "Failed to poll file descriptors");
+			}
+			// Errors and hang-ups are reported as ready as well, the resumed coroutine finds out by using the file
+			// descriptor.
+			for (std::size_t i = fds.size(); res > 0 && i > 0; --i) {
+				if (fds[i - 1].revents != 0) {
+					m_ready.push_back(m_fd_waits[i - 1]);
+					m_fd_waits.erase(m_fd_waits.begin() + static_cast<std::ptrdiff_t>(i - 1));
+				}
+			}
+		} else
+#endif
+		    if (wake_up != clock::time_point::max()) {
+			std::this_thread::sleep_until(wake_up);
+		}
+
+		const auto now = clock::now();
+		for (auto it = m_timers.begin(); it != m_timers.end();) {
+			if (it->m_time <= now) {
+				m_ready.push_back(*it);
+				it = m_timers.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	static inline thread_local event_loop* t_current = nullptr;
+
+	std::vector<waiter> m_ready;
+	std::vector<timer> m_timers;
+#if LIBENVPP_PLATFORM_UNIX
+	std::vector<fd_wait> m_fd_waits;
+#endif
+	std::size_t m_current_owner = 0;
+	event_loop* m_previous;
+};
+
+} // namespace detail
+
+// Lazily started coroutine returning a value of type 'T'. Returning a 'task' from a parser and validator makes it
+// asynchronous, and awaiting a 'task' in another one runs it to completion on the same event loop.
+template <typename T>
+class [[nodiscard]] task {
+  public:
+	struct promise_type {
+		[[nodiscard]] task get_return_object() noexcept
+		{
+			return task{std::coroutine_handle<promise_type>::from_promise(*this)};
+		}
+
+		[[nodiscard]] std::suspend_always initial_suspend() const noexcept { return {}; }
+
+		[[nodiscard]] auto final_suspend() const noexcept
+		{
+			struct final_awaiter {
+				[[nodiscard]] bool await_ready() const noexcept { return false; }
+
+				[[nodiscard]] std::coroutine_handle<>
+				await_suspend(const std::coroutine_handle<promise_type> handle) const noexcept
+				{
+					const auto continuation = handle.promise().m_continuation;
+					return continuation ? continuation : std::noop_coroutine();
+				}
+
+				void await_resume() const noexcept {}
+			};
+			return final_awaiter{};
+		}
+
+		template <typename U>
+		void return_value(U&& value)
+		{
+			m_value.emplace(std::forward<U>(value));
+		}
+
+		void unhandled_exception() noexcept { m_exception = std::current_exception(); }
+
+		std::optional<T> m_value;
+		std::exception_ptr m_exception;
+		std::coroutine_handle<> m_continuation;
+	};
+
+	task(const task&) = delete;
+	task(task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+	task& operator=(const task&) = delete;
+	task& operator=(task&& other) noexcept
+	{
+		if (this != &other) {
+			destroy();
+			m_handle = std::exchange(other.m_handle, nullptr);
+		}
+		return *this;
+	}
+
+	~task() { destroy(); }
+
+	[[nodiscard]] auto operator co_await() const noexcept
+	{
+		struct awaiter {
+			[[nodiscard]] bool await_ready() const noexcept { return false; }
+
+			[[nodiscard]] std::coroutine_handle<> await_suspend(const std::coroutine_handle<> awaiting) const noexcept
+			{
+				m_handle.promise().m_continuation = awaiting;
+				return m_handle;
+			}
+
+			T await_resume() const { return task::result(m_handle); }
+
+			std::coroutine_handle<promise_type> m_handle;
+		};
+		return awaiter{m_handle};
+	}
+
+  private:
+	explicit task(const std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+	[[nodiscard]] static T result(const std::coroutine_handle<promise_type> handle)
+	{
+		auto& promise = handle.promise();
+		if (promise.m_exception) {
+			std::rethrow_exception(promise.m_exception);
+		}
+		return std::move(*promise.m_value);
+	}
+
+	void destroy() noexcept
+	{
+		if (m_handle) {
+			m_handle.destroy();
+			m_handle = nullptr;
+		}
+	}
+
+	std::coroutine_handle<promise_type> m_handle;
+
+	friend detail::task_access;
+};
+
+namespace detail {
+
+struct task_access {
+	template <typename T>
+	[[nodiscard]] static std::coroutine_handle<> handle(const task<T>& t) noexcept
+	{
+		return t.m_handle;
+	}
+
+	template <typename T>
+	[[nodiscard]] static bool done(const task<T>& t) noexcept
+	{
+		return !t.m_handle || t.m_handle.done();
+	}
+
+	template <typename T>
+	[[nodiscard]] static T result(const task<T>& t)
+	{
+		return task<T>::result(t.m_handle);
+	}
+
+	template <typename T>
+	static void destroy(task<T>& t) noexcept
+	{
+		t.destroy();
+	}
+};
+
+class sleep_awaiter {
+  public:
+	explicit sleep_awaiter(const event_loop::clock::time_point time) noexcept : m_time(time) {}
+
+	[[nodiscard]] bool await_ready() const noexcept { return event_loop::clock::now() >= m_time; }
+
+	void await_suspend(const std::coroutine_handle<> handle) const { event_loop::current().wait_until(m_time, handle); }
+
+	void await_resume() const noexcept {}
+
+  private:
+	event_loop::clock::time_point m_time;
+};
+
+#if LIBENVPP_PLATFORM_UNIX
+class fd_awaiter {
+  public:
+	fd_awaiter(const int fd, const short events) noexcept : m_fd(fd), m_events(events) {}
+
+	[[nodiscard]] bool await_ready() const noexcept { return false; }
+
+	void await_suspend(const std::coroutine_handle<> handle) const
+	{
+		event_loop::current().wait_for_fd(m_fd, m_events, handle);
+	}
+
+	void await_resume() const noexcept {}
+
+  private:
+	int m_fd;
+	short m_events;
+};
+#endif
+
+template <typename T>
+struct is_task<task<T>> : std::true_type {
+	using value_type = T;
+};
+
+using async_parser_and_validator_fn = std::function<task<std::any>(const std::string_view)>;
+
+template <typename T, typename U>
+[[nodiscard]] task<std::any> erase_task_type(task<U> typed_task)
+{
+	co_return std::any(static_cast<T>(co_await std::move(typed_task)));
+}
+
+// Runs a task to completion on an event loop of the calling thread. Throws 'async_timeout' if it did not finish within
+// 'timeout', in which case the task is destroyed.
+template <typename T>
+[[nodiscard]] T run_task(task<T> t, const std::chrono::milliseconds timeout)
+{
+	const auto deadline = event_loop::clock::now() + timeout;
+	auto loop = event_loop{};
+	loop.schedule(task_access::handle(t), 0);
+	while (!task_access::done(t)) {
+		if (event_loop::clock::now() >= deadline) {
+			loop.cancel(0);
+			task_access::destroy(t);
+			throw async_timeout{timeout};
+		}
+		loop.run_once(deadline);
+	}
+	return task_access::result(t);
+}
+
+struct timed_task {
+	task<std::any> m_task;
+	event_loop::clock::time_point m_deadline;
+	bool m_timed_out = false;
+};
+
+// Runs all tasks concurrently on an event loop of the calling thread, until each of them either finished or timed out.
+// Timed out tasks are destroyed.
+inline void run_timed_tasks(std::vector<timed_task>& tasks)
+{
+	auto loop = event_loop{};
+	for (std::size_t i = 0; i < tasks.size(); ++i) {
+		loop.schedule(task_access::handle(tasks[i].m_task), i);
+	}
+
+	while (true) {
+		const auto now = event_loop::clock::now();
+		auto next_deadline = event_loop::clock::time_point::max();
+		for (std::size_t i = 0; i < tasks.size(); ++i) {
+			auto& entry = tasks[i];
+			if (entry.m_timed_out || task_access::done(entry.m_task)) {
+				continue;
+			}
+			if (now >= entry.m_deadline) {
+				loop.cancel(i);
+				task_access::destroy(entry.m_task);
+				entry.m_timed_out = true;
+			} else {
+				next_deadline = std::min(next_deadline, entry.m_deadline);
+			}
+		}
+		if (next_deadline == event_loop::clock::time_point::max()) {
+			return;
+		}
+		loop.run_once(next_deadline);
+	}
+}
+
+} // namespace detail
+
+// Suspends the calling task for 'duration'.
+template <typename Rep, typename Period>
+[[nodiscard]] detail::sleep_awaiter sleep_for(const std::chrono::duration<Rep, Period> duration)
+{
+	return detail::sleep_awaiter{detail::event_loop::clock::now()
+	                             + std::chrono::ceil<detail::event_loop::clock::duration>(duration)};
+}
+
+#if LIBENVPP_PLATFORM_UNIX
+// Suspends the calling task until 'fd' is readable, or an error or hang-up occurred on it.
+[[nodiscard]] inline detail::fd_awaiter wait_readable(const int fd)
+{
+	return detail::fd_awaiter{fd, POLLIN};
+}
+
+// Suspends the calling task until 'fd' is writable, e.g. a non-blocking connect finished, or an error or hang-up
+// occurred on it.
+[[nodiscard]] inline detail::fd_awaiter wait_writable(const int fd)
+{
+	return detail::fd_awaiter{fd, POLLOUT};
+}
+#endif
+
+#endif
+
+} // namespace env
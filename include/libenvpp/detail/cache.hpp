@@ -0,0 +1,191 @@
+#pragma once
+
+#include <any>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <libenvpp/detail/hash.hpp>
+#include <libenvpp/detail/parser.hpp>
+
+namespace env {
+
+// Opt-in cache of parsed and validated values, stored in a binary file. If the schema of the prefix and the relevant
+// environment match the cached state, the values are loaded directly and no parser or validator is invoked.
+class config_cache {
+  public:
+	config_cache() = delete;
+	explicit config_cache(std::filesystem::path path) : m_path(std::move(path)) {}
+
+	[[nodiscard]] const std::filesystem::path& path() const noexcept { return m_path; }
+
+  private:
+	std::filesystem::path m_path;
+};
+
+namespace detail {
+
+// Every representation of the underlying type of a scoped enumeration is a valid value of it.
+template <typename T, bool = std::is_enum_v<T>>
+struct is_scoped_enum : std::false_type {
+};
+
+template <typename T>
+struct is_scoped_enum<T, true> : std::negation<std::is_convertible<T, std::underlying_type_t<T>>> {
+};
+
+// Values are cached as their object representation, which must not refer to memory of the process that wrote the cache
+// (e.g. pointers or string views), and must be checked to be a valid value when read from the cache, as not every
+// representation is (e.g. of 'bool'). Library types opt in by specializing this trait.
+template <typename T, typename = void>
+struct cached_representation {
+	static constexpr bool is_cacheable = false;
+};
+
+template <typename T>
+struct cached_representation<T, std::enable_if_t<std::is_arithmetic_v<T> || is_scoped_enum<T>::value>> {
+	static constexpr bool is_cacheable = true;
+
+	[[nodiscard]] static bool is_valid(const std::string_view representation) noexcept
+	{
+		if constexpr (std::is_same_v<T, bool>) {
+			constexpr auto false_value = false;
+			constexpr auto true_value = true;
+			return std::memcmp(representation.data(), &false_value, sizeof(bool)) == 0
+			       || std::memcmp(representation.data(), &true_value, sizeof(bool)) == 0;
+		} else {
+			return true;
+		}
+	}
+};
+
+template <typename Rep, typename Period>
+struct cached_representation<std::chrono::duration<Rep, Period>> {
+	static constexpr bool is_cacheable = cached_representation<Rep>::is_cacheable;
+
+	[[nodiscard]] static bool is_valid(const std::string_view representation) noexcept
+	{
+		return cached_representation<Rep>::is_valid(representation);
+	}
+};
+
+template <typename T>
+struct is_cacheable
+    : std::disjunction<std::bool_constant<cached_representation<T>::is_cacheable>, std::is_same<T, std::string>> {
+};
+
+template <typename T>
+inline constexpr auto is_cacheable_v = is_cacheable<T>::value;
+
+using cache_serializer_fn = void (*)(const std::any&, std::string&);
+using cache_deserializer_fn = std::optional<std::any> (*)(const std::string_view);
+
+template <typename T>
+void serialize_cached_value(const std::any& value, std::string& out)
+{
+	const auto& typed_value = std::any_cast<const T&>(value);
+	if constexpr (std::is_same_v<T, std::string>) {
+		out.append(typed_value);
+	} else {
+		out.append(reinterpret_cast<const char*>(&typed_value), sizeof(T));
+	}
+}
+
+// Returns no value if the bytes are not a valid value, or if the value is rejected by the default validator of T.
+// The parser and validator the variable was registered with are not invoked.
+template <typename T>
+[[nodiscard]] std::optional<std::any> deserialize_cached_value(const std::string_view bytes)
+{
+	auto value = std::any();
+	if constexpr (std::is_same_v<T, std::string>) {
+		value = std::string(bytes);
+	} else {
+		if (bytes.size() != sizeof(T) || !cached_representation<T>::is_valid(bytes)) {
+			return std::nullopt;
+		}
+		value.emplace<T>();
+		std::memcpy(static_cast<void*>(std::any_cast<T>(&value)), bytes.data(), sizeof(T));
+	}
+	try {
+		default_validator<T>{}(*std::any_cast<T>(&value));
+	} catch (...) {
+		return std::nullopt;
+	}
+	return value;
+}
+
+// Describes how the values of a variable are stored in the cache, and identifies its type and parser in the schema.
+struct cache_codec {
+	std::uint64_t schema_hash;
+	cache_serializer_fn serialize = nullptr;
+	cache_deserializer_fn deserialize = nullptr;
+};
+
+// The parser and validator is identified by its type only, which does not identify any state it holds, e.g. the
+// captures of a lambda. Variables with a stateful one are therefore only cached if 'schema_seed' identifies that state,
+// as it does for the bounds of ranges and the options of option variables.
+template <typename T, typename ParserAndValidatorFn>
+[[nodiscard]] cache_codec make_cache_codec(const std::optional<std::uint64_t> schema_seed)
+{
+	const auto schema_hash = hash_combine(hash_combine(schema_seed.value_or(0), fnv1a(typeid(T).name())),
+	                                      fnv1a(typeid(ParserAndValidatorFn).name()));
+	if constexpr (is_cacheable_v<T>) {
+		if (std::is_empty_v<ParserAndValidatorFn> || schema_seed.has_value()) {
+			return {schema_hash, &serialize_cached_value<T>, &deserialize_cached_value<T>};
+		}
+	}
+	return {schema_hash};
+}
+
+// Hashes the object representation of values, to include values given at registration (e.g. the bounds of a range) in
+// the schema. Values that cannot be cached yield an arbitrary hash, as the variable is never cached in that case.
+template <typename T>
+[[nodiscard]] std::uint64_t hash_cached_value(const T& value)
+{
+	if constexpr (std::is_same_v<T, std::string>) {
+		return fnv1a(value);
+	} else if constexpr (is_cacheable_v<T>) {
+		return fnv1a(std::string_view(reinterpret_cast<const char*>(&value), sizeof(T)));
+	} else {
+		return 0;
+	}
+}
+
+// Read-only view of a cache file, memory-mapped where supported. Where file ownership is supported, files which are not
+// owned by the current user or which others can write to are treated as empty, as their values cannot be trusted.
+class mapped_cache_file {
+  public:
+	explicit mapped_cache_file(const std::filesystem::path& path);
+
+	mapped_cache_file(const mapped_cache_file&) = delete;
+	mapped_cache_file& operator=(const mapped_cache_file&) = delete;
+
+	~mapped_cache_file();
+
+	// Returns one entry per variable, empty for variables without value, if the file is well-formed, stores exactly
+	// 'count' entries, was written with the same 'key', and the entries match their checksum.
+	[[nodiscard]] std::optional<std::vector<std::optional<std::string_view>>> entries(const std::uint64_t key,
+	                                                                                    const std::size_t count) const;
+
+  private:
+	std::string_view m_data;
+	void* m_mapping = nullptr;
+	std::string m_buffer;
+};
+
+// Writes the cache file atomically, by writing to a temporary file only accessible by the current user first and then
+// renaming it. Failures are ignored, as they only result in a cache miss for subsequent parses.
+void store_cache_file(const std::filesystem::path& path, const std::uint64_t key,
+                      const std::vector<std::optional<std::string>>& entries) noexcept;
+
+} // namespace detail
+
+} // namespace env
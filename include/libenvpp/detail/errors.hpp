@@ -1,11 +1,18 @@
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
-#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <libenvpp/detail/message.hpp>
+#include <libenvpp/detail/testing.hpp>
 
 namespace env {
 
@@ -33,6 +40,12 @@ class invalid_range : public std::invalid_argument {
 	invalid_range(const std::string_view message) : std::invalid_argument(std::string(message)) {}
 };
 
+class invalid_pattern : public std::invalid_argument {
+  public:
+	invalid_pattern() = delete;
+	invalid_pattern(const std::string_view message) : std::invalid_argument(std::string(message)) {}
+};
+
 class parser_error : public std::runtime_error {
   public:
 	parser_error() = delete;
@@ -75,11 +88,70 @@ class test_environment_error : public std::runtime_error {
 	test_environment_error(const std::string_view message) : std::runtime_error(std::string(message)) {}
 };
 
+class source_error : public std::runtime_error {
+  public:
+	source_error() = delete;
+	source_error(const std::string_view message) : std::runtime_error(std::string(message)) {}
+};
+
+class write_error : public std::runtime_error {
+  public:
+	write_error() = delete;
+	write_error(const std::string_view message) : std::runtime_error(std::string(message)) {}
+};
+
+// What went wrong, which an 'error' stores instead of its message.
+enum class error_kind {
+	// A 'parser_error', 'validation_error', 'range_error' or 'option_error' was thrown while parsing or validating.
+	parser,
+	validation,
+	range,
+	option,
+	// Any other exception was thrown while parsing or validating.
+	exception,
+	unknown_exception,
+	// The variable is not set.
+	unset,
+	// The variable is not set, but a similar, presumably misspelled, variable is.
+	misspelled,
+	// A variable with the prefix is set, but not registered.
+	unused,
+	// A secret is set both directly and through its '_FILE' suffixed variable.
+	mutually_exclusive,
+	// The file referenced by the '_FILE' suffixed variable of a secret could not be read.
+	secret_file,
+	// An asynchronous parser and validator did not finish within its timeout.
+	timeout,
+	// The error was constructed with a message.
+	custom,
+};
+
+namespace detail {
+
+// The kind of an error together with its details, which are rendered into the message, e.g. the message of the
+// exception thrown by a parser. Becomes an 'error' once the variable it belongs to is known.
+struct error_details {
+	error_kind kind;
+	std::string detail;
+};
+
+// Thrown when an asynchronous parser and validator, which is run to completion without an event loop, did not finish
+// within its timeout. Reported like a timeout on an event loop.
+struct async_timeout {
+	std::chrono::milliseconds timeout;
+};
+
+struct error_access;
+
+} // namespace detail
+
+// Errors only reference the names of their variables, which are owned by the result they are part of, and render their
+// message on demand. Collecting errors is therefore cheap, e.g. when only their number and kinds are of interest.
 class error {
   public:
 	error() = delete;
 	error(const std::size_t var_idx, const std::string_view var_name, const std::string_view error_message)
-	    : m_var_idx(var_idx), m_var_name(var_name), m_error_message(error_message)
+	    : m_var_idx(var_idx), m_kind(error_kind::custom), m_owned_name(var_name), m_detail(error_message)
 	{
 	}
 
@@ -91,23 +163,152 @@ class error {
 
 	[[nodiscard]] std::size_t get_id() const noexcept { return m_var_idx; }
 
-	[[nodiscard]] const std::string& get_name() const noexcept { return m_var_name; }
+	[[nodiscard]] error_kind kind() const noexcept { return m_kind; }
 
-	[[nodiscard]] const std::string& what() const noexcept { return m_error_message; }
+	[[nodiscard]] std::string_view get_name() const noexcept
+	{
+		return m_owned_name.empty() ? m_var_name : std::string_view(m_owned_name);
+	}
+
+	[[nodiscard]] std::string what() const;
 
   private:
+	error(const error_kind kind, const std::size_t var_idx, const std::string_view var_name,
+	      const std::string_view env_var_name, const std::string_view env_var_suffix, std::string detail)
+	    : m_var_idx(var_idx), m_kind(kind), m_var_name(var_name), m_env_var_name(env_var_name),
+	      m_env_var_suffix(env_var_suffix), m_detail(std::move(detail))
+	{
+	}
+
 	std::size_t m_var_idx;
-	std::string m_var_name;
-	std::string m_error_message;
+	error_kind m_kind;
+	std::string_view m_var_name;
+	// Name of the environment variable the error is about, which is the name of the error if empty.
+	std::string_view m_env_var_name;
+	std::string_view m_env_var_suffix;
+	// Only used for names which are not owned by anything the error is part of.
+	std::string m_owned_name;
+	std::string m_detail;
+
+	friend detail::error_access;
 };
 
 namespace detail {
 
-[[nodiscard]] std::optional<error> get_similar_env_var_error(const std::size_t id, const std::string_view env_var_name,
-                                                             const int edit_dist_cutoff,
-                                                             std::unordered_map<std::string, std::string>& environment);
+struct error_access {
+	[[nodiscard]] static error make(const std::size_t id, const std::string_view var_name,
+	                                const std::string_view env_var_name, error_details details,
+	                                const std::string_view env_var_suffix)
+	{
+		return error(details.kind, id, var_name, env_var_name, env_var_suffix, std::move(details.detail));
+	}
+
+	[[nodiscard]] static error make_owned(const std::size_t id, const std::string_view env_var_name,
+	                                      error_details details)
+	{
+		auto err = error(details.kind, id, {}, {}, {}, std::move(details.detail));
+		err.m_owned_name = env_var_name;
+		return err;
+	}
+
+	// Calls 'fn' with the format string and arguments of every part of the message of 'err', see 'message.hpp'.
+	template <typename Fn>
+	static void visit_message(const error& err, Fn& fn);
+};
+
+// The names must outlive the error. 'env_var_suffix' is appended to the name of the environment variable, e.g. if it
+// is the '_FILE' suffixed variable of a secret.
+[[nodiscard]] inline error make_error(const std::size_t id, const std::string_view var_name,
+                                      const std::string_view env_var_name, error_details details,
+                                      const std::string_view env_var_suffix = {})
+{
+	return error_access::make(id, var_name, env_var_name, std::move(details), env_var_suffix);
+}
+
+// Error about the environment variable 'env_var_name', which is also its name and owned by the error.
+[[nodiscard]] inline error make_owned_error(const std::size_t id, const std::string_view env_var_name,
+                                            error_details details)
+{
+	return error_access::make_owned(id, env_var_name, std::move(details));
+}
+
+// Returns the details of an error about the unset variable 'env_var_name' if a similar variable is set in
+// 'environment', which is then consumed.
+[[nodiscard]] std::optional<error_details> get_similar_env_var_error(const std::string_view env_var_name,
+                                                                     const int edit_dist_cutoff,
+                                                                     testing_environment_view& environment);
+
+template <typename Fn>
+void error_access::visit_message(const error& err, Fn& fn)
+{
+	const auto name = err.m_env_var_name.empty() ? err.get_name() : err.m_env_var_name;
+	const auto suffix = err.m_env_var_suffix;
+	const auto detail = std::string_view(err.m_detail);
+	switch (err.m_kind) {
+	case error_kind::parser:
+		fn("Parser error for environment variable '{}{}': {}", name, suffix, detail);
+		break;
+	case error_kind::validation:
+		fn("Validation error for environment variable '{}{}': {}", name, suffix, detail);
+		break;
+	case error_kind::range:
+		fn("Range error for environment variable '{}{}': {}", name, suffix, detail);
+		break;
+	case error_kind::option:
+		fn("Option error for environment variable '{}{}': {}", name, suffix, detail);
+		break;
+	case error_kind::exception:
+		fn("Failed to parse or validate environment variable '{}{}' with: {}", name, suffix, detail);
+		break;
+	case error_kind::unknown_exception:
+		fn("Failed to parse or validate environment variable '{}{}' with unknown error", name, suffix);
+		break;
+	case error_kind::unset:
+		fn("Environment variable '{}' not set", name);
+		break;
+	case error_kind::misspelled:
+		fn("Unrecognized environment variable '{}' set, did you mean '{}'?", detail, name);
+		break;
+	case error_kind::unused:
+		fn("Prefix environment variable '{}' specified but unused", name);
+		break;
+	case error_kind::mutually_exclusive:
+		fn("Environment variables '{}' and '{}{}' are mutually exclusive", name, name, suffix);
+		break;
+	case error_kind::timeout:
+		fn("Parser and validator of environment variable '{}{}' timed out after {}ms", name, suffix, detail);
+		break;
+	case error_kind::secret_file:
+	case error_kind::custom:
+		fn("{}", detail);
+		break;
+	}
+}
+
+// Calls 'fn' with the parts of the messages of all 'errors_or_warnings', each prefixed with 'message_type'.
+template <typename Fn>
+void visit_messages(Fn& fn, const std::string_view message_type, const std::vector<error>& errors_or_warnings)
+{
+	for (const auto& error_or_warning : errors_or_warnings) {
+		fn("{:<7}: ", message_type);
+		error_access::visit_message(error_or_warning, fn);
+		fn("\n");
+	}
+}
+
+[[nodiscard]] std::string format_messages(const std::string_view message_type,
+                                          const std::vector<error>& errors_or_warnings);
+
+void format_messages(fmt::memory_buffer& buffer, const std::string_view message_type,
+                     const std::vector<error>& errors_or_warnings);
 
-[[nodiscard]] error get_unset_env_var_error(const std::size_t id, const std::string_view env_var_name);
+// Writes the messages to the output iterator 'out' and returns the iterator past them.
+template <typename OutputIt>
+[[nodiscard]] OutputIt format_messages(OutputIt out, const std::string_view message_type,
+                                       const std::vector<error>& errors_or_warnings)
+{
+	return format_message(std::move(out), [&](auto& fn) { visit_messages(fn, message_type, errors_or_warnings); });
+}
 
 } // namespace detail
 
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace env {
+
+// Runs the parsers and validators of 'parse_and_validate' when passed to it. Tasks may run concurrently and in any
+// order, on any thread including the calling one, and must all eventually be run.
+class executor {
+  public:
+	virtual ~executor() = default;
+
+	virtual void execute(std::function<void()> task) = 0;
+};
+
+// Executor running tasks on a fixed number of threads, which are joined on destruction after running all remaining
+// tasks.
+class thread_pool final : public executor {
+  public:
+	explicit thread_pool(const std::size_t thread_count = std::thread::hardware_concurrency());
+
+	thread_pool(const thread_pool&) = delete;
+	thread_pool(thread_pool&&) = delete;
+
+	thread_pool& operator=(const thread_pool&) = delete;
+	thread_pool& operator=(thread_pool&&) = delete;
+
+	~thread_pool() override;
+
+	void execute(std::function<void()> task) override;
+
+	[[nodiscard]] std::size_t thread_count() const noexcept { return m_threads.size(); }
+
+  private:
+	void run();
+
+	std::mutex m_mutex;
+	std::condition_variable m_task_available;
+	std::deque<std::function<void()>> m_tasks;
+	bool m_stopping = false;
+	std::vector<std::thread> m_threads;
+};
+
+} // namespace env
@@ -1,55 +1,92 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 
 #include <libenvpp/detail/edit_distance.hpp>
 #include <libenvpp/detail/environment.hpp>
 #include <libenvpp/detail/errors.hpp>
 #include <libenvpp/detail/expected.hpp>
+#include <libenvpp/detail/list.hpp>
+#include <libenvpp/detail/map.hpp>
+#include <libenvpp/detail/network.hpp>
 #include <libenvpp/detail/parser.hpp>
 #include <libenvpp/detail/testing.hpp>
+#include <libenvpp/detail/units.hpp>
 
 namespace env {
 
+namespace detail {
+
+// Looks up a single variable, reading through the testing environment in effect for the calling thread before the
+// system environment, without retrieving or merging complete environments.
+[[nodiscard]] inline std::optional<std::string> find_variable(const std::string_view env_var_name)
+{
+	if (const auto testing_value = find_testing_variable(env_var_name); testing_value.has_value()) {
+		return std::string(*testing_value);
+	}
+	return get_environment_variable(env_var_name);
+}
+
+} // namespace detail
+
 template <typename T>
 [[nodiscard]] expected<T, error> get(const std::string_view env_var_name,
                                      const edit_distance edit_distance_cutoff = default_edit_distance)
 {
+	static_assert(!std::is_same_v<T, std::string_view>,
+	              "The value would reference a temporary copy of the environment, use 'env::string_ref' instead");
+
 	using expected_t = expected<T, error>;
 	using unexpected_t = typename expected_t::unexpected_type;
 
-	// Merges the global testing environment into the environment considered for parsing and validating,
-	// giving precedence to variables set in the testing environment.
-	auto environment = detail::merge_environments(detail::g_testing_environment, detail::get_environment());
-
-	if (const auto env_var_it = environment.find(std::string(env_var_name)); env_var_it != environment.end()) {
-		auto res = detail::parse_or_error<T>(env_var_name, env_var_it->second, default_parser_and_validator<T>{});
+	if (auto env_var_value = detail::find_variable(env_var_name); env_var_value.has_value()) {
+		if constexpr (std::is_same_v<T, string_ref>) {
+			// The value owns the string it references.
+			const auto owner = std::make_shared<const std::string>(std::move(*env_var_value));
+			auto res = detail::parse_or_error<T>(*owner, default_parser_and_validator<T>{});
+			if (res.has_value()) {
+				detail::share_ownership(*res, owner);
+				return expected_t{std::move(res).value()};
+			}
+			const auto id = static_cast<std::size_t>(-1);
+			return expected_t{unexpected_t{detail::make_owned_error(id, env_var_name, std::move(res).error())}};
+		}
+		auto res = detail::parse_or_error<T>(*env_var_value, default_parser_and_validator<T>{});
 		if (res.has_value()) {
 			return expected_t{std::move(res).value()};
 		}
-		return expected_t{unexpected_t{error(static_cast<std::size_t>(-1), env_var_name, std::move(res).error())}};
+		const auto id = static_cast<std::size_t>(-1);
+		return expected_t{unexpected_t{detail::make_owned_error(id, env_var_name, std::move(res).error())}};
 	}
 
+	// Typo detection considers the testing environment as well as the environment.
+	const auto system_environment = detail::get_environment();
+	auto environment = detail::testing_environment_view(system_environment);
+
 	const auto id = static_cast<std::size_t>(-1);
 	const auto edit_dist_cutoff = edit_distance_cutoff.get_or_default(env_var_name.length());
-	auto similar_env_var_error = detail::get_similar_env_var_error(id, env_var_name, edit_dist_cutoff, environment);
+	auto similar_env_var_error = detail::get_similar_env_var_error(env_var_name, edit_dist_cutoff, environment);
 	if (similar_env_var_error.has_value()) {
-		return expected_t{unexpected_t{std::move(similar_env_var_error).value()}};
+		auto err = detail::make_owned_error(id, env_var_name, std::move(similar_env_var_error).value());
+		return expected_t{unexpected_t{std::move(err)}};
 	}
-	return expected_t{unexpected_t{detail::get_unset_env_var_error(id, env_var_name)}};
+	return expected_t{unexpected_t{detail::make_owned_error(id, env_var_name, {error_kind::unset, {}})}};
 }
 
 template <typename T, typename U = T>
 [[nodiscard]] T get_or(const std::string_view env_var_name, U&& default_value)
 {
-	// Merges the global testing environment into the environment considered for parsing and validating,
-	// giving precedence to variables set in the testing environment.
-	const auto environment = detail::merge_environments(detail::g_testing_environment, detail::get_environment());
+	static_assert(!detail::is_string_reference_v<T>,
+	              "The value would reference a temporary copy of the environment, use 'env::get' instead");
 
-	if (const auto env_var_it = environment.find(std::string(env_var_name)); env_var_it != environment.end()) {
-		auto res = detail::parse_or_error<T>(env_var_name, env_var_it->second, default_parser_and_validator<T>{});
+	if (const auto env_var_value = detail::find_variable(env_var_name); env_var_value.has_value()) {
+		auto res = detail::parse_or_error<T>(*env_var_value, default_parser_and_validator<T>{});
 		if (res.has_value()) {
 			return std::move(res).value();
 		}
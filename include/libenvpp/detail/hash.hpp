@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace env::detail {
+
+inline constexpr auto FNV1A_OFFSET_BASIS = std::uint64_t{14695981039346656037ull};
+inline constexpr auto FNV1A_PRIME = std::uint64_t{1099511628211ull};
+
+// 64-bit FNV-1a hash, 'seed' allows chaining multiple strings into one hash.
+[[nodiscard]] constexpr std::uint64_t fnv1a(const std::string_view str,
+                                           std::uint64_t seed = FNV1A_OFFSET_BASIS) noexcept
+{
+	for (const auto c : str) {
+		seed ^= static_cast<std::uint8_t>(c);
+		seed *= FNV1A_PRIME;
+	}
+	return seed;
+}
+
+// Final avalanche step of MurmurHash3, spreads the entropy of all input bits over all output bits.
+[[nodiscard]] constexpr std::uint64_t mix(std::uint64_t value) noexcept
+{
+	value ^= value >> 33;
+	value *= 0xff51afd7ed558ccdull;
+	value ^= value >> 33;
+	value *= 0xc4ceb9fe1a85ec53ull;
+	value ^= value >> 33;
+	return value;
+}
+
+[[nodiscard]] constexpr std::uint64_t hash_combine(const std::uint64_t seed, const std::uint64_t value) noexcept
+{
+	return mix(seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2)));
+}
+
+} // namespace env::detail
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace env {
+
+// Wall time and number of heap allocations of one phase of parsing and validating a prefix. Allocations are counted
+// for the calling thread only.
+struct phase_stats {
+	std::chrono::nanoseconds duration{0};
+	std::size_t allocations = 0;
+
+	phase_stats& operator+=(const phase_stats& rhs) noexcept
+	{
+		duration += rhs.duration;
+		allocations += rhs.allocations;
+		return *this;
+	}
+};
+
+struct variable_stats {
+	std::string name;
+	// Looking up the variable in all sources, reading secret files, and invoking the parser and validator.
+	phase_stats parse;
+	// Searching the environment for similarly named variables, only for variables which are not set.
+	phase_stats typo_detection;
+};
+
+// Statistics of one call to 'parse_and_validate', only collected if libenvpp is built with 'LIBENVPP_INSTRUMENTATION'.
+struct parse_stats {
+	// Prefix of the variable names, including the delimiter.
+	std::string prefix_name;
+	bool cache_hit = false;
+	// Capturing the environment and looking up the frames of the testing environment.
+	phase_stats environment;
+	// Computing the cache key, loading from and storing to the cache.
+	phase_stats cache;
+	// Sum of the 'parse' phases of all variables.
+	phase_stats parse;
+	// Sum of the 'typo_detection' phases of all variables.
+	phase_stats typo_detection;
+	phase_stats unused_detection;
+	// The whole call, including the overhead of collecting the statistics.
+	phase_stats total;
+	std::vector<variable_stats> variables;
+};
+
+using parse_observer = std::function<void(const parse_stats&)>;
+
+// Returns the number of heap allocations made by the calling thread so far.
+using allocation_counter = std::size_t (*)() noexcept;
+
+#if LIBENVPP_INSTRUMENTATION_ENABLED
+
+// Installs an observer which is called with the statistics of every subsequent 'parse_and_validate', on the thread
+// calling it. An empty observer uninstalls the current one.
+void set_parse_observer(parse_observer observer);
+
+// Installs the counter of heap allocations, e.g. one querying the statistics of a custom allocator, and returns the
+// previously installed one. Allocations are reported as zero while no counter is installed. Linking the
+// 'libenvpp::allocation_counter' target installs a counter based on replacing the global allocation functions.
+allocation_counter set_allocation_counter(const allocation_counter counter) noexcept;
+
+namespace detail {
+
+// Number of heap allocations made by the calling thread so far, according to the installed allocation counter.
+[[nodiscard]] std::size_t allocation_count() noexcept;
+
+void notify_parse_observer(const parse_stats& stats);
+
+class phase_measurement {
+  public:
+	phase_measurement() noexcept : m_start(clock::now()), m_start_allocations(allocation_count()) {}
+
+	[[nodiscard]] phase_stats stop() const noexcept
+	{
+		return {std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - m_start),
+		        allocation_count() - m_start_allocations};
+	}
+
+  private:
+	using clock = std::chrono::steady_clock;
+
+	clock::time_point m_start;
+	std::size_t m_start_allocations;
+};
+
+} // namespace detail
+
+#endif
+
+} // namespace env
+
+#if LIBENVPP_INSTRUMENTATION_ENABLED
+#define LIBENVPP_INSTRUMENT(statement) statement
+#define LIBENVPP_MEASURE_BEGIN(measurement) const auto measurement = ::env::detail::phase_measurement{}
+#define LIBENVPP_MEASURE_END(measurement, stats) (stats) += (measurement).stop()
+#else
+#define LIBENVPP_INSTRUMENT(statement)
+#define LIBENVPP_MEASURE_BEGIN(measurement)
+#define LIBENVPP_MEASURE_END(measurement, stats)
+#endif
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <libenvpp/detail/errors.hpp>
+#include <libenvpp/detail/parser.hpp>
+#include <libenvpp/detail/string_ref.hpp>
+
+namespace env {
+namespace detail {
+
+// Integer types whose list elements are parsed with 'std::from_chars', and which support range elements such as '4-7'.
+// Character types are excluded, they are parsed as characters by 'default_parser'.
+template <typename T>
+struct is_list_integer
+    : std::conjunction<std::is_integral<T>, std::negation<std::is_same<T, bool>>,
+                       std::negation<std::is_same<T, char>>, std::negation<std::is_same<T, signed char>>,
+                       std::negation<std::is_same<T, unsigned char>>, std::negation<std::is_same<T, wchar_t>>,
+                       std::negation<std::is_same<T, char16_t>>, std::negation<std::is_same<T, char32_t>>> {
+};
+
+template <typename T>
+inline constexpr auto is_list_integer_v = is_list_integer<T>::value;
+
+[[nodiscard]] constexpr std::string_view trim_list_element(std::string_view str) noexcept
+{
+	while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) {
+		str.remove_prefix(1);
+	}
+	while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) {
+		str.remove_suffix(1);
+	}
+	return str;
+}
+
+// Calls 'fn' with the index and the trimmed text of every element of the 'Delim' separated 'str'. The elements are
+// views of 'str', nothing is allocated.
+template <char Delim, typename Fn>
+void for_each_list_element(std::string_view str, Fn&& fn)
+{
+	if (str.empty()) {
+		return;
+	}
+	for (auto index = std::size_t{0};; ++index) {
+		const auto delim_pos = str.find(Delim);
+		fn(index, trim_list_element(str.substr(0, delim_pos)));
+		if (delim_pos == std::string_view::npos) {
+			break;
+		}
+		str.remove_prefix(delim_pos + 1);
+	}
+}
+
+[[nodiscard]] inline std::size_t count_list_elements(const std::string_view str, const char delim) noexcept
+{
+	return str.empty() ? 0 : static_cast<std::size_t>(std::count(str.begin(), str.end(), delim)) + 1;
+}
+
+template <typename T>
+[[nodiscard]] T parse_list_integer(const std::string_view str)
+{
+	auto value = T{};
+	const auto* const end = str.data() + str.size();
+	const auto [ptr, ec] = std::from_chars(str.data(), end, value);
+	if (ec == std::errc::result_out_of_range) {
+		throw parser_error{fmt::format("Number '{}' is out of range of the element type", str)};
+	}
+	if (ec != std::errc{} || ptr != end) {
+		throw parser_error{fmt::format("Cannot parse '{}' as a number", str)};
+	}
+	return value;
+}
+
+// Appends the integers of the element 'str', which is either a single integer or an inclusive range 'first-last', to
+// 'list'. The first character is skipped when looking for the range separator, so that negative numbers are supported.
+// The size of a range is checked before expanding it, so that the list never grows beyond 'max_size' elements.
+template <typename T>
+void append_list_integers(std::vector<T>& list, const std::string_view str, const std::size_t max_size)
+{
+	const auto separator = str.empty() ? std::string_view::npos : str.find('-', 1);
+	if (separator == std::string_view::npos) {
+		const auto value = parse_list_integer<T>(str);
+		if (list.size() >= max_size) {
+			throw parser_error{fmt::format("List has more than {} elements", max_size)};
+		}
+		list.push_back(value);
+		return;
+	}
+	const auto first = parse_list_integer<T>(trim_list_element(str.substr(0, separator)));
+	const auto last = parse_list_integer<T>(trim_list_element(str.substr(separator + 1)));
+	if (last < first) {
+		throw parser_error{fmt::format("Range '{}' ends before it begins", str)};
+	}
+	// One less than the number of integers in the range, which cannot overflow in the unsigned type.
+	using unsigned_t = std::make_unsigned_t<T>;
+	const auto range_span = static_cast<unsigned_t>(static_cast<unsigned_t>(last) - static_cast<unsigned_t>(first));
+	if (static_cast<std::uintmax_t>(range_span) >= max_size - list.size()) {
+		throw parser_error{fmt::format("Range '{}' makes the list exceed {} elements", str, max_size)};
+	}
+	for (auto value = first;; ++value) {
+		list.push_back(value);
+		if (value == last) {
+			break;
+		}
+	}
+}
+
+} // namespace detail
+
+// Maximum number of elements of a list parsed by 'list_parser', unless given explicitly. Ranges are expanded into their
+// elements, so a short value such as '0-4000000000' would otherwise exhaust memory.
+inline constexpr auto default_max_list_size = std::size_t{65536};
+
+// Parses a list of values separated by 'Delim', e.g. 'a:1,b:2,c:3', into a 'std::vector<T>'. Whitespace around the
+// elements is ignored, and an empty string is parsed as an empty list. Integer elements may also be inclusive ranges,
+// e.g. '0,2,4-7' is parsed as '{0, 2, 4, 5, 6, 7}'. All other elements are parsed with 'default_parser<T>'. Lists with
+// more than 'MaxSize' elements, after expanding ranges, are rejected.
+template <typename T, char Delim = ',', std::size_t MaxSize = default_max_list_size>
+struct list_parser {
+	static_assert(!detail::is_string_reference_v<T>,
+	              "List elements cannot reference the parsed string, use 'std::string' elements instead.");
+
+	[[nodiscard]] std::vector<T> operator()(const std::string_view str) const
+	{
+		auto list = std::vector<T>();
+		list.reserve(std::min(detail::count_list_elements(str, Delim), MaxSize));
+		detail::for_each_list_element<Delim>(str, [&list](const std::size_t index, const std::string_view element) {
+			try {
+				if constexpr (detail::is_list_integer_v<T>) {
+					detail::append_list_integers(list, element, MaxSize);
+				} else {
+					if (list.size() >= MaxSize) {
+						throw parser_error{fmt::format("List has more than {} elements", MaxSize)};
+					}
+					list.push_back(default_parser<T>{}(element));
+				}
+			} catch (const parser_error& e) {
+				throw parser_error{fmt::format("Element {} '{}' of list: {}", index, element, e.what())};
+			}
+		});
+		return list;
+	}
+};
+
+// Validates every element of a list with 'default_validator<T>'.
+template <typename T>
+struct list_validator {
+	void operator()(const std::vector<T>& list) const
+	{
+		for (auto index = std::size_t{0}; index < list.size(); ++index) {
+			try {
+				default_validator<T>{}(list[index]);
+			} catch (const validation_error& e) {
+				throw validation_error{fmt::format("Element {} of list: {}", index, e.what())};
+			}
+		}
+	}
+};
+
+template <typename T>
+struct default_parser<std::vector<T>> : list_parser<T> {
+};
+
+template <typename T>
+struct default_validator<std::vector<T>> : list_validator<T> {
+};
+
+} // namespace env
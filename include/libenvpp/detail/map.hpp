@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <libenvpp/detail/errors.hpp>
+#include <libenvpp/detail/list.hpp>
+#include <libenvpp/detail/parser.hpp>
+#include <libenvpp/detail/string_ref.hpp>
+
+namespace env {
+
+// Map stored as a vector of key/value pairs sorted by key, which is faster to look up in than a 'std::unordered_map'
+// for small to medium sizes, see 'flat_map_find'.
+template <typename K, typename V>
+using flat_map = std::vector<std::pair<K, V>>;
+
+// Returns the value of 'key' in 'map', or a null pointer if 'map' does not contain 'key'.
+template <typename K, typename V, typename Key>
+[[nodiscard]] const V* flat_map_find(const flat_map<K, V>& map, const Key& key)
+{
+	const auto it = std::lower_bound(map.begin(), map.end(), key,
+	                                 [](const std::pair<K, V>& entry, const Key& k) { return entry.first < k; });
+	if (it == map.end() || key < it->first) {
+		return nullptr;
+	}
+	return &it->second;
+}
+
+namespace detail {
+
+// Splits the map element 'element' at the first 'KeyValueDelim', parses the key with 'default_parser<K>' and the
+// value with 'default_parser<V>', and passes both to 'fn'. Parser errors are reported with the index of the element.
+template <typename K, typename V, char KeyValueDelim, typename Fn>
+void parse_map_element(const std::size_t index, const std::string_view element, Fn&& fn)
+{
+	try {
+		const auto delim_pos = element.find(KeyValueDelim);
+		if (delim_pos == std::string_view::npos) {
+			throw parser_error{fmt::format("Missing '{}' between key and value", KeyValueDelim)};
+		}
+		const auto key = trim_list_element(element.substr(0, delim_pos));
+		fn(key, default_parser<K>{}(key), default_parser<V>{}(trim_list_element(element.substr(delim_pos + 1))));
+	} catch (const parser_error& e) {
+		throw parser_error{fmt::format("Element {} '{}' of map: {}", index, element, e.what())};
+	}
+}
+
+[[noreturn]] inline void throw_duplicate_map_key(const std::size_t index, const std::string_view element,
+                                                 const std::string_view key)
+{
+	throw parser_error{fmt::format("Element {} '{}' of map: Duplicate key '{}'", index, element, key)};
+}
+
+} // namespace detail
+
+// Parses key/value pairs separated by 'Delim', whose key and value are separated by 'KeyValueDelim', e.g.
+// 'region=eu,tier=gold', into a 'std::unordered_map<K, V>'. Keys and values are parsed with 'default_parser', the
+// value is everything after the first 'KeyValueDelim'. Duplicate keys are an error.
+template <typename K, typename V, char Delim = ',', char KeyValueDelim = '='>
+struct map_parser {
+	static_assert(!detail::is_string_reference_v<K> && !detail::is_string_reference_v<V>,
+	              "Map keys and values cannot reference the parsed string, use 'std::string' instead.");
+
+	[[nodiscard]] std::unordered_map<K, V> operator()(const std::string_view str) const
+	{
+		auto map = std::unordered_map<K, V>();
+		map.reserve(detail::count_list_elements(str, Delim));
+		detail::for_each_list_element<Delim>(str, [&map](const std::size_t index, const std::string_view element) {
+			detail::parse_map_element<K, V, KeyValueDelim>(
+			    index, element, [&](const std::string_view key_str, K&& key, V&& value) {
+				    if (!map.try_emplace(std::move(key), std::move(value)).second) {
+					    detail::throw_duplicate_map_key(index, element, key_str);
+				    }
+			    });
+		});
+		return map;
+	}
+};
+
+// Parses key/value pairs like 'map_parser', but into a 'flat_map<K, V>' sorted by key.
+template <typename K, typename V, char Delim = ',', char KeyValueDelim = '='>
+struct flat_map_parser {
+	static_assert(!detail::is_string_reference_v<K> && !detail::is_string_reference_v<V>,
+	              "Map keys and values cannot reference the parsed string, use 'std::string' instead.");
+
+	[[nodiscard]] flat_map<K, V> operator()(const std::string_view str) const
+	{
+		auto map = flat_map<K, V>();
+		map.reserve(detail::count_list_elements(str, Delim));
+		detail::for_each_list_element<Delim>(str, [&map](const std::size_t index, const std::string_view element) {
+			detail::parse_map_element<K, V, KeyValueDelim>(
+			    index, element, [&map](const std::string_view, K&& key, V&& value) {
+				    map.emplace_back(std::move(key), std::move(value));
+			    });
+		});
+
+		const auto key_less = [](const std::pair<K, V>& lhs, const std::pair<K, V>& rhs) {
+			return lhs.first < rhs.first;
+		};
+		std::stable_sort(map.begin(), map.end(), key_less);
+		const auto duplicate = std::adjacent_find(map.begin(), map.end(), [&](const auto& lhs, const auto& rhs) {
+			return !key_less(lhs, rhs) && !key_less(rhs, lhs);
+		});
+		if (duplicate != map.end()) {
+			// The sort lost the positions of the elements, so the second occurrence is found by parsing the keys again.
+			auto occurrences = 0;
+			detail::for_each_list_element<Delim>(str, [&](const std::size_t index, const std::string_view element) {
+				detail::parse_map_element<K, V, KeyValueDelim>(
+				    index, element, [&](const std::string_view key_str, K&& key, V&&) {
+					    if (!(key < duplicate->first) && !(duplicate->first < key) && ++occurrences == 2) {
+						    detail::throw_duplicate_map_key(index, element, key_str);
+					    }
+				    });
+			});
+		}
+		return map;
+	}
+};
+
+template <typename K, typename V>
+struct default_parser<std::unordered_map<K, V>> : map_parser<K, V> {
+};
+
+} // namespace env
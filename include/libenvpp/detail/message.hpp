@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+#include <fmt/format.h>
+
+namespace env {
+
+namespace detail {
+
+// Messages are produced by a visitor, which calls the function object it is given with the format string and arguments
+// of every part of the message. This allows computing the size of a message up front and then formatting it directly
+// into its destination.
+
+// Sums up the sizes of the formatted parts of a message without formatting them.
+class message_sizer {
+  public:
+	template <typename... Args>
+	void operator()(fmt::format_string<Args...> format, Args&&... args)
+	{
+		m_size += fmt::formatted_size(format, std::forward<Args>(args)...);
+	}
+
+	[[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+  private:
+	std::size_t m_size = 0;
+};
+
+// Formats the parts of a message to an output iterator.
+template <typename OutputIt>
+class message_writer {
+  public:
+	explicit message_writer(OutputIt out) : m_out(std::move(out)) {}
+
+	template <typename... Args>
+	void operator()(fmt::format_string<Args...> format, Args&&... args)
+	{
+		m_out = fmt::format_to(std::move(m_out), format, std::forward<Args>(args)...);
+	}
+
+	[[nodiscard]] OutputIt out() && { return std::move(m_out); }
+
+  private:
+	OutputIt m_out;
+};
+
+// Appends the message produced by 'visit' to 'buffer', e.g. a 'std::string' or 'fmt::memory_buffer', which is grown
+// at most once.
+template <typename Buffer, typename Visit>
+void append_message(Buffer& buffer, Visit&& visit)
+{
+	auto sizer = message_sizer();
+	visit(sizer);
+	buffer.reserve(buffer.size() + sizer.size());
+	auto writer = message_writer(std::back_inserter(buffer));
+	visit(writer);
+}
+
+// Writes the message produced by 'visit' to the output iterator 'out' and returns the iterator past the message.
+template <typename OutputIt, typename Visit>
+[[nodiscard]] OutputIt format_message(OutputIt out, Visit&& visit)
+{
+	auto writer = message_writer(std::move(out));
+	visit(writer);
+	return std::move(writer).out();
+}
+
+// Writes 'message' to the file descriptor 'fd', e.g. 'STDERR_FILENO', and throws 'write_error' if that fails.
+void write_message(const int fd, const std::string_view message);
+
+// Writes the message produced by 'visit' to the file descriptor 'fd' with a single buffer sized up front.
+template <typename Visit>
+void write_message(const int fd, Visit&& visit)
+{
+	auto buffer = fmt::memory_buffer();
+	append_message(buffer, std::forward<Visit>(visit));
+	write_message(fd, std::string_view(buffer.data(), buffer.size()));
+}
+
+} // namespace detail
+
+} // namespace env
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace env {
+
+enum class case_sensitivity {
+	sensitive,
+	insensitive,
+};
+
+namespace detail {
+
+// Perfect hash table of names built at run time, so that looking up a name takes one hash and one comparison. With
+// 'case_sensitivity::insensitive' names are matched ignoring the case of ASCII letters.
+class name_table {
+  public:
+	// Throws 'empty_option' if 'names' is empty, and 'duplicate_option' if it contains a name twice.
+	name_table(std::vector<std::string> names, const case_sensitivity sensitivity);
+
+	name_table(const name_table&) = delete;
+	name_table(name_table&&) = default;
+
+	name_table& operator=(const name_table&) = delete;
+	name_table& operator=(name_table&&) = default;
+
+	[[nodiscard]] std::size_t size() const noexcept { return m_names.size(); }
+	[[nodiscard]] const std::vector<std::string>& names() const noexcept { return m_names; }
+
+	// Returns the index of 'name', or 'size()' if it is not in the table.
+	[[nodiscard]] std::size_t find(const std::string_view name) const;
+
+	// Returns the name most similar to 'name' within the edit distance 'edit_distance_cutoff', if there is one.
+	[[nodiscard]] std::optional<std::string_view> find_similar(const std::string_view name,
+	                                                           const int edit_distance_cutoff) const;
+
+  private:
+	std::vector<std::string> m_names;
+	// Lowercase names if the table is case-insensitive, empty otherwise.
+	std::vector<std::string> m_folded_names;
+	std::vector<std::string_view> m_keys;
+	std::vector<std::uint32_t> m_displacements;
+	std::vector<std::size_t> m_slots;
+	case_sensitivity m_sensitivity;
+};
+
+// Values of an enum registered with 'register_enum', in the order of their names in the name table.
+template <typename E>
+struct enum_table {
+	name_table names;
+	std::vector<E> values;
+};
+
+} // namespace detail
+
+} // namespace env
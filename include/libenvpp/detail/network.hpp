@@ -0,0 +1,380 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#include <fmt/core.h>
+
+#include <libenvpp/detail/cache.hpp>
+#include <libenvpp/detail/parser.hpp>
+
+namespace env {
+
+class ip_address;
+class cidr;
+class endpoint;
+
+enum class ip_family : std::uint8_t {
+	v4,
+	v6,
+};
+
+namespace detail {
+
+// Builds an address with the zone ID 'zone_id', which must have at most 'ip_address::MAX_ZONE_ID_SIZE' characters.
+[[nodiscard]] ip_address make_ip_address(const std::array<std::uint8_t, 16>& bytes, const ip_family family,
+                                         const std::string_view zone_id) noexcept;
+
+// Whether 'address' is in the form every address is constructed in: its zone ID fits, it is of a known family, and the
+// bytes unused by IPv4 addresses and by the zone ID are zero. Only such addresses are loaded from the cache.
+[[nodiscard]] constexpr bool is_well_formed_ip_address(const ip_address& address) noexcept;
+
+// Throws 'parser_error' if 'str' is not an address, network or endpoint in numeric form. Parsing does not allocate
+// unless it fails.
+[[nodiscard]] ip_address parse_ip_address(const std::string_view str);
+[[nodiscard]] cidr parse_cidr(const std::string_view str);
+[[nodiscard]] endpoint parse_endpoint(const std::string_view str);
+
+} // namespace detail
+
+// IPv4 or IPv6 address, parsed from values such as '10.0.0.5', '::1' or 'fe80::1%eth0'. Addresses are parsed from
+// their numeric form only, host names are never resolved.
+class ip_address {
+  public:
+	static constexpr auto MAX_ZONE_ID_SIZE = std::size_t{16};
+
+	// The IPv4 address '0.0.0.0'.
+	constexpr ip_address() noexcept = default;
+
+	[[nodiscard]] static constexpr ip_address v4(const std::array<std::uint8_t, 4>& bytes) noexcept
+	{
+		auto address = ip_address{};
+		for (std::size_t i = 0; i < bytes.size(); ++i) {
+			address.m_bytes[i] = bytes[i];
+		}
+		return address;
+	}
+
+	[[nodiscard]] static constexpr ip_address v6(const std::array<std::uint8_t, 16>& bytes) noexcept
+	{
+		auto address = ip_address{};
+		address.m_bytes = bytes;
+		address.m_family = ip_family::v6;
+		return address;
+	}
+
+	[[nodiscard]] constexpr ip_family family() const noexcept { return m_family; }
+	[[nodiscard]] constexpr bool is_v4() const noexcept { return m_family == ip_family::v4; }
+	[[nodiscard]] constexpr bool is_v6() const noexcept { return m_family == ip_family::v6; }
+
+	// Network byte order, IPv4 addresses occupy the first 4 bytes and the remaining bytes are zero.
+	[[nodiscard]] constexpr const std::array<std::uint8_t, 16>& bytes() const noexcept { return m_bytes; }
+
+	// Zone ID of scoped IPv6 addresses, e.g. 'eth0' in 'fe80::1%eth0', or empty.
+	[[nodiscard]] constexpr std::string_view zone_id() const noexcept
+	{
+		return std::string_view(m_zone_id.data(), m_zone_id_size);
+	}
+
+	[[nodiscard]] friend constexpr bool operator==(const ip_address& lhs, const ip_address& rhs) noexcept
+	{
+		return lhs.m_family == rhs.m_family && lhs.m_bytes == rhs.m_bytes && lhs.zone_id() == rhs.zone_id();
+	}
+	[[nodiscard]] friend constexpr bool operator!=(const ip_address& lhs, const ip_address& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+	// IPv4 addresses order before IPv6 addresses, addresses of the same family order by their bytes.
+	[[nodiscard]] friend constexpr bool operator<(const ip_address& lhs, const ip_address& rhs) noexcept
+	{
+		if (lhs.m_family != rhs.m_family) {
+			return lhs.m_family < rhs.m_family;
+		}
+		for (std::size_t i = 0; i < lhs.m_bytes.size(); ++i) {
+			if (lhs.m_bytes[i] != rhs.m_bytes[i]) {
+				return lhs.m_bytes[i] < rhs.m_bytes[i];
+			}
+		}
+		return lhs.zone_id() < rhs.zone_id();
+	}
+	[[nodiscard]] friend constexpr bool operator<=(const ip_address& lhs, const ip_address& rhs) noexcept
+	{
+		return !(rhs < lhs);
+	}
+	[[nodiscard]] friend constexpr bool operator>(const ip_address& lhs, const ip_address& rhs) noexcept
+	{
+		return rhs < lhs;
+	}
+	[[nodiscard]] friend constexpr bool operator>=(const ip_address& lhs, const ip_address& rhs) noexcept
+	{
+		return !(lhs < rhs);
+	}
+
+  private:
+	friend ip_address detail::make_ip_address(const std::array<std::uint8_t, 16>& bytes, const ip_family family,
+	                                          const std::string_view zone_id) noexcept;
+	friend constexpr bool detail::is_well_formed_ip_address(const ip_address& address) noexcept;
+
+	// Only single byte members without padding, so that equal addresses have equal object representations, which are
+	// what is stored in the cache.
+	std::array<std::uint8_t, 16> m_bytes{};
+	std::array<char, MAX_ZONE_ID_SIZE> m_zone_id{};
+	std::uint8_t m_zone_id_size = 0;
+	ip_family m_family = ip_family::v4;
+};
+
+// Network given by an address and a prefix length, parsed from values such as '10.0.0.0/8' or 'fd00::/64'.
+class cidr {
+  public:
+	// The network '0.0.0.0/0'.
+	constexpr cidr() noexcept = default;
+	constexpr cidr(const ip_address& address, const std::uint8_t prefix_length) noexcept
+	    : m_address(address), m_prefix_length(prefix_length)
+	{
+	}
+
+	// The address as given, host bits are not cleared.
+	[[nodiscard]] constexpr const ip_address& address() const noexcept { return m_address; }
+	[[nodiscard]] constexpr std::uint8_t prefix_length() const noexcept { return m_prefix_length; }
+
+	// The address with all host bits cleared.
+	[[nodiscard]] constexpr ip_address network() const noexcept
+	{
+		auto bytes = m_address.bytes();
+		for (std::size_t i = 0; i < bytes.size(); ++i) {
+			bytes[i] &= prefix_mask(i);
+		}
+		if (m_address.is_v4()) {
+			return ip_address::v4({bytes[0], bytes[1], bytes[2], bytes[3]});
+		}
+		return ip_address::v6(bytes);
+	}
+
+	[[nodiscard]] constexpr bool contains(const ip_address& address) const noexcept
+	{
+		if (address.family() != m_address.family()) {
+			return false;
+		}
+		for (std::size_t i = 0; i < address.bytes().size(); ++i) {
+			if (((address.bytes()[i] ^ m_address.bytes()[i]) & prefix_mask(i)) != 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] friend constexpr bool operator==(const cidr& lhs, const cidr& rhs) noexcept
+	{
+		return lhs.m_address == rhs.m_address && lhs.m_prefix_length == rhs.m_prefix_length;
+	}
+	[[nodiscard]] friend constexpr bool operator!=(const cidr& lhs, const cidr& rhs) noexcept { return !(lhs == rhs); }
+	[[nodiscard]] friend constexpr bool operator<(const cidr& lhs, const cidr& rhs) noexcept
+	{
+		return lhs.m_address < rhs.m_address
+		       || (lhs.m_address == rhs.m_address && lhs.m_prefix_length < rhs.m_prefix_length);
+	}
+	[[nodiscard]] friend constexpr bool operator<=(const cidr& lhs, const cidr& rhs) noexcept { return !(rhs < lhs); }
+	[[nodiscard]] friend constexpr bool operator>(const cidr& lhs, const cidr& rhs) noexcept { return rhs < lhs; }
+	[[nodiscard]] friend constexpr bool operator>=(const cidr& lhs, const cidr& rhs) noexcept { return !(lhs < rhs); }
+
+  private:
+	// Mask of the prefix bits in byte 'index' of the address.
+	[[nodiscard]] constexpr std::uint8_t prefix_mask(const std::size_t index) const noexcept
+	{
+		const auto bits = static_cast<std::size_t>(m_prefix_length);
+		if (bits >= (index + 1) * 8) {
+			return 0xff;
+		}
+		if (bits <= index * 8) {
+			return 0;
+		}
+		return static_cast<std::uint8_t>(0xff << (8 - (bits - index * 8)));
+	}
+
+	ip_address m_address;
+	std::uint8_t m_prefix_length = 0;
+};
+
+// Address and port, parsed from values such as '10.0.0.5:9000' or '[::1]:8443'. IPv6 addresses must be enclosed in
+// brackets, host names are never resolved.
+class endpoint {
+  public:
+	// The endpoint '0.0.0.0:0'.
+	constexpr endpoint() noexcept = default;
+	constexpr endpoint(const ip_address& address, const std::uint16_t port) noexcept
+	    : m_address(address), m_port(port)
+	{
+	}
+
+	[[nodiscard]] constexpr const ip_address& address() const noexcept { return m_address; }
+	[[nodiscard]] constexpr std::uint16_t port() const noexcept { return m_port; }
+
+	[[nodiscard]] friend constexpr bool operator==(const endpoint& lhs, const endpoint& rhs) noexcept
+	{
+		return lhs.m_address == rhs.m_address && lhs.m_port == rhs.m_port;
+	}
+	[[nodiscard]] friend constexpr bool operator!=(const endpoint& lhs, const endpoint& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+	// Endpoints order by address first, so that ranges of endpoints with the same address are port ranges.
+	[[nodiscard]] friend constexpr bool operator<(const endpoint& lhs, const endpoint& rhs) noexcept
+	{
+		return lhs.m_address < rhs.m_address || (lhs.m_address == rhs.m_address && lhs.m_port < rhs.m_port);
+	}
+	[[nodiscard]] friend constexpr bool operator<=(const endpoint& lhs, const endpoint& rhs) noexcept
+	{
+		return !(rhs < lhs);
+	}
+	[[nodiscard]] friend constexpr bool operator>(const endpoint& lhs, const endpoint& rhs) noexcept
+	{
+		return rhs < lhs;
+	}
+	[[nodiscard]] friend constexpr bool operator>=(const endpoint& lhs, const endpoint& rhs) noexcept
+	{
+		return !(lhs < rhs);
+	}
+
+  private:
+	ip_address m_address;
+	std::uint16_t m_port = 0;
+};
+
+static_assert(std::has_unique_object_representations_v<ip_address>);
+static_assert(std::has_unique_object_representations_v<cidr>);
+static_assert(std::has_unique_object_representations_v<endpoint>);
+
+namespace detail {
+
+[[nodiscard]] constexpr bool is_well_formed_ip_address(const ip_address& address) noexcept
+{
+	if (address.m_zone_id_size > ip_address::MAX_ZONE_ID_SIZE) {
+		return false;
+	}
+	for (auto i = std::size_t{address.m_zone_id_size}; i < address.m_zone_id.size(); ++i) {
+		if (address.m_zone_id[i] != '\0') {
+			return false;
+		}
+	}
+	if (address.m_family == ip_family::v6) {
+		return true;
+	}
+	if (address.m_family != ip_family::v4 || address.m_zone_id_size != 0) {
+		return false;
+	}
+	for (auto i = std::size_t{4}; i < address.m_bytes.size(); ++i) {
+		if (address.m_bytes[i] != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// All members of the network types are single bytes or integers, so any representation read from the cache is an
+// object, which is then checked to be well-formed before it is used.
+template <typename T>
+[[nodiscard]] T read_cached_representation(const std::string_view representation) noexcept
+{
+	auto value = T{};
+	std::memcpy(static_cast<void*>(&value), representation.data(), sizeof(T));
+	return value;
+}
+
+template <>
+struct cached_representation<ip_address> {
+	static constexpr bool is_cacheable = true;
+
+	[[nodiscard]] static bool is_valid(const std::string_view representation) noexcept
+	{
+		return is_well_formed_ip_address(read_cached_representation<ip_address>(representation));
+	}
+};
+
+template <>
+struct cached_representation<cidr> {
+	static constexpr bool is_cacheable = true;
+
+	[[nodiscard]] static bool is_valid(const std::string_view representation) noexcept
+	{
+		const auto network = read_cached_representation<cidr>(representation);
+		return is_well_formed_ip_address(network.address())
+		       && network.prefix_length() <= (network.address().is_v4() ? 32 : 128);
+	}
+};
+
+template <>
+struct cached_representation<endpoint> {
+	static constexpr bool is_cacheable = true;
+
+	[[nodiscard]] static bool is_valid(const std::string_view representation) noexcept
+	{
+		return is_well_formed_ip_address(read_cached_representation<endpoint>(representation).address());
+	}
+};
+
+// Longest text of an address, a fully written out IPv6 address with an embedded IPv4 address and a zone ID.
+inline constexpr auto IP_ADDRESS_TEXT_SIZE = std::size_t{45 + 1 + ip_address::MAX_ZONE_ID_SIZE};
+
+// Writes 'address' to 'buffer' in its canonical form, IPv6 addresses as recommended by RFC 5952.
+[[nodiscard]] std::string_view format_ip_address(const ip_address& address,
+                                                 std::array<char, IP_ADDRESS_TEXT_SIZE>& buffer) noexcept;
+
+} // namespace detail
+
+template <>
+struct default_parser<ip_address> {
+	[[nodiscard]] ip_address operator()(const std::string_view str) const { return detail::parse_ip_address(str); }
+};
+
+template <>
+struct default_parser<cidr> {
+	[[nodiscard]] cidr operator()(const std::string_view str) const { return detail::parse_cidr(str); }
+};
+
+template <>
+struct default_parser<endpoint> {
+	[[nodiscard]] endpoint operator()(const std::string_view str) const { return detail::parse_endpoint(str); }
+};
+
+} // namespace env
+
+template <>
+struct fmt::formatter<env::ip_address> {
+	constexpr auto parse(format_parse_context& ctx) { return ctx.begin(); }
+
+	template <typename FormatContext>
+	auto format(const env::ip_address& address, FormatContext& ctx) const
+	{
+		auto buffer = std::array<char, env::detail::IP_ADDRESS_TEXT_SIZE>{};
+		return fmt::format_to(ctx.out(), "{}", env::detail::format_ip_address(address, buffer));
+	}
+};
+
+template <>
+struct fmt::formatter<env::cidr> {
+	constexpr auto parse(format_parse_context& ctx) { return ctx.begin(); }
+
+	template <typename FormatContext>
+	auto format(const env::cidr& network, FormatContext& ctx) const
+	{
+		return fmt::format_to(ctx.out(), "{}/{}", network.address(), network.prefix_length());
+	}
+};
+
+template <>
+struct fmt::formatter<env::endpoint> {
+	constexpr auto parse(format_parse_context& ctx) { return ctx.begin(); }
+
+	template <typename FormatContext>
+	auto format(const env::endpoint& endpoint, FormatContext& ctx) const
+	{
+		if (endpoint.address().is_v6()) {
+			return fmt::format_to(ctx.out(), "[{}]:{}", endpoint.address(), endpoint.port());
+		}
+		return fmt::format_to(ctx.out(), "{}:{}", endpoint.address(), endpoint.port());
+	}
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <libenvpp/detail/name_table.hpp>
+
+namespace env::detail {
+
+// Up to this many options are searched linearly, which is faster than any other lookup for so few options.
+inline constexpr auto OPTION_SET_LINEAR_SEARCH_MAX = std::size_t{8};
+
+// String options are matched against the raw value of the variable, before it is parsed.
+template <typename T>
+struct is_raw_string_option : std::disjunction<std::is_same<T, std::string>, std::is_same<T, std::string_view>> {
+};
+
+template <typename T>
+inline constexpr auto is_raw_string_option_v = is_raw_string_option<T>::value;
+
+// Set of valid options of an option variable, stored in the structure which is fastest to search for its type and
+// size: few options are searched linearly, more string options are looked up in a perfect hash table, and more options
+// of other types are binary searched.
+template <typename T>
+class option_set {
+  public:
+	// 'options' must be sorted and must not contain duplicates.
+	explicit option_set(std::vector<T> options) : m_options(std::move(options))
+	{
+		if constexpr (is_raw_string_option_v<T>) {
+			if (m_options.size() > OPTION_SET_LINEAR_SEARCH_MAX) {
+				m_table.emplace(std::vector<std::string>(m_options.begin(), m_options.end()),
+				                case_sensitivity::sensitive);
+			}
+		}
+	}
+
+	template <typename U = T, std::enable_if_t<is_raw_string_option_v<U>, int> = 0>
+	[[nodiscard]] bool contains(const std::string_view str) const
+	{
+		if (m_table.has_value()) {
+			return m_table->find(str) != m_table->size();
+		}
+		return std::any_of(m_options.begin(), m_options.end(), [str](const auto& option) { return option == str; });
+	}
+
+	template <typename U = T, std::enable_if_t<!is_raw_string_option_v<U>, int> = 0>
+	[[nodiscard]] bool contains(const T& value) const
+	{
+		if (m_options.size() <= OPTION_SET_LINEAR_SEARCH_MAX) {
+			return std::any_of(m_options.begin(), m_options.end(),
+			                   [&value](const T& option) { return option == value; });
+		}
+		return std::binary_search(m_options.begin(), m_options.end(), value);
+	}
+
+  private:
+	std::vector<T> m_options;
+	std::optional<name_table> m_table;
+};
+
+} // namespace env::detail
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+namespace env {
+
+// Determines how many errors 'parse_and_validate' reports before it stops. Once the error budget is spent, the
+// remaining variables are neither parsed nor validated, and typo and unused variable detection are skipped.
+class parse_mode {
+  public:
+	constexpr parse_mode() : m_error_budget(std::numeric_limits<std::size_t>::max()) {}
+	// At least one error is always reported.
+	constexpr explicit parse_mode(const std::size_t error_budget) : m_error_budget(error_budget > 0 ? error_budget : 1)
+	{
+	}
+
+	constexpr parse_mode(const parse_mode&) = default;
+	constexpr parse_mode(parse_mode&&) = default;
+
+	constexpr parse_mode& operator=(const parse_mode&) = default;
+	constexpr parse_mode& operator=(parse_mode&&) = default;
+
+	[[nodiscard]] constexpr std::size_t error_budget() const noexcept { return m_error_budget; }
+
+	[[nodiscard]] constexpr bool is_budgeted() const noexcept
+	{
+		return m_error_budget != std::numeric_limits<std::size_t>::max();
+	}
+
+  private:
+	std::size_t m_error_budget;
+};
+
+// Parses and validates all variables and reports all errors and warnings.
+inline constexpr auto collect_all = parse_mode();
+// Stops at the first error.
+inline constexpr auto fail_fast = parse_mode(1);
+
+// Stops after 'count' errors.
+[[nodiscard]] constexpr parse_mode max_errors(const std::size_t count)
+{
+	return parse_mode(count);
+}
+
+} // namespace env
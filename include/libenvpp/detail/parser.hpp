@@ -1,12 +1,19 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <exception>
+#include <locale>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <type_traits>
 #include <utility>
 
@@ -14,9 +21,25 @@
 
 #include <libenvpp/detail/errors.hpp>
 #include <libenvpp/detail/expected.hpp>
+#include <libenvpp/detail/string_ref.hpp>
 #include <libenvpp/detail/util.hpp>
 
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define LIBENVPP_FLOAT_FROM_CHARS_ENABLED 1
+#else
+#define LIBENVPP_FLOAT_FROM_CHARS_ENABLED 0
+#endif
+
 namespace env {
+
+// Syntax of the floating point numbers accepted by 'float_parser'. 'decimal' accepts decimal numbers with an optional
+// exponent, e.g. '1.5' or '-2.5e-3', and 'extended' additionally accepts hexadecimal numbers, e.g. '0x1.8p3', and the
+// special values 'inf', 'infinity' and 'nan' in any case.
+enum class float_syntax {
+	decimal,
+	extended,
+};
+
 namespace detail {
 
 template <typename T>
@@ -55,38 +78,171 @@ inline constexpr auto is_stringstream_constructible_v = is_stringstream_construc
 
 //////////////////////////////////////////////////////////////////////////
 
-[[nodiscard]] static inline bool parse_bool(const std::string_view str)
+// Whitespace skipped by 'operator>>' in the "C" locale.
+[[nodiscard]] constexpr bool is_whitespace(const char c) noexcept
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+[[nodiscard]] constexpr std::string_view trim_whitespace(std::string_view str) noexcept
+{
+	while (!str.empty() && is_whitespace(str.front())) {
+		str.remove_prefix(1);
+	}
+	while (!str.empty() && is_whitespace(str.back())) {
+		str.remove_suffix(1);
+	}
+	return str;
+}
+
+// Packs up to 8 characters into one integer, with bit 0x20 set in every character, which lowercases ASCII letters.
+// The remaining bytes are zero, so that words of different lengths never compare equal.
+[[nodiscard]] constexpr std::uint64_t pack_lowercase_word(const std::string_view str) noexcept
+{
+	auto packed = std::uint64_t{0};
+	for (std::size_t i = 0; i < str.size(); ++i) {
+		packed |= std::uint64_t{static_cast<unsigned char>(str[i]) | 0x20u} << (i * 8);
+	}
+	return packed;
+}
+
+inline constexpr auto BOOL_TRUE_WORDS =
+    std::array{pack_lowercase_word("true"), pack_lowercase_word("on"), pack_lowercase_word("yes")};
+inline constexpr auto BOOL_FALSE_WORDS =
+    std::array{pack_lowercase_word("false"), pack_lowercase_word("off"), pack_lowercase_word("no")};
+
+// Parses 'true', 'on' and 'yes', and 'false', 'off' and 'no', in any case, as well as the numbers 1 and 0, which may
+// have a sign and leading zeros. Surrounding whitespace is ignored.
+[[nodiscard]] constexpr std::optional<bool> classify_bool(const std::string_view str) noexcept
 {
-	constexpr auto to_lower_char = [](const char c) -> char {
-		if ('A' <= c && c <= 'Z') {
-			return c + ('a' - 'A');
-		} else {
-			return c;
+	auto value = trim_whitespace(str);
+	if (value.empty()) {
+		return std::nullopt;
+	}
+
+	constexpr auto is_digit = [](const char c) { return c >= '0' && c <= '9'; };
+	if (value.front() == '+' || value.front() == '-' || is_digit(value.front())) {
+		const auto negative = value.front() == '-';
+		auto digits = value.front() == '+' || negative ? value.substr(1) : value;
+		if (digits.empty()) {
+			return std::nullopt;
+		}
+		for (const auto c : digits) {
+			if (!is_digit(c)) {
+				return std::nullopt;
+			}
+		}
+		while (!digits.empty() && digits.front() == '0') {
+			digits.remove_prefix(1);
+		}
+		if (digits.empty()) {
+			return false;
+		}
+		if (digits == "1" && !negative) {
+			return true;
+		}
+		return std::nullopt;
+	}
+
+	if (value.size() > sizeof(std::uint64_t)) {
+		return std::nullopt;
+	}
+	const auto word = pack_lowercase_word(value);
+	for (std::size_t i = 0; i < BOOL_TRUE_WORDS.size(); ++i) {
+		if (word == BOOL_TRUE_WORDS[i]) {
+			return true;
 		}
-	};
-
-	constexpr auto equal_case_insensitive = [to_lower_char](const std::string_view a, const std::string_view b) {
-		return std::equal(a.begin(), a.end(), b.begin(), b.end(),
-		                  [to_lower_char](const char a, const char b) { return to_lower_char(a) == to_lower_char(b); });
-	};
-
-	if (equal_case_insensitive(str, "true")  //
-	    || equal_case_insensitive(str, "on") //
-	    || equal_case_insensitive(str, "yes")) {
-		return true;
-	} else if (equal_case_insensitive(str, "false")  //
-	           || equal_case_insensitive(str, "off") //
-	           || equal_case_insensitive(str, "no")) {
-		return false;
+		if (word == BOOL_FALSE_WORDS[i]) {
+			return false;
+		}
+	}
+	return std::nullopt;
+}
+
+[[nodiscard]] inline bool parse_bool(const std::string_view str)
+{
+	if (const auto value = classify_bool(str); value.has_value()) {
+		return *value;
+	}
+	throw parser_error{fmt::format("Failed to parse '{}' as boolean", str)};
+}
+
+// Parses the unsigned number 'str', which is hexadecimal without the '0x' prefix if 'hex' is set.
+template <typename T>
+[[nodiscard]] std::errc parse_float_magnitude(const std::string_view str, const bool hex, T& value)
+{
+	if (!str.empty() && (str.front() == '+' || str.front() == '-')) {
+		return std::errc::invalid_argument;
+	}
+#if LIBENVPP_FLOAT_FROM_CHARS_ENABLED
+	const auto* const end = str.data() + str.size();
+	const auto format = hex ? std::chars_format::hex : std::chars_format::general;
+	const auto [ptr, ec] = std::from_chars(str.data(), end, value, format);
+	return ec == std::errc{} && ptr != end ? std::errc::invalid_argument : ec;
+#else
+	// Decimal numbers are parsed with a stream in the "C" locale. Hexadecimal numbers and special values cannot be
+	// parsed with a stream, they are parsed with 'strtod', whose decimal point depends on the locale.
+	if (!hex && !str.empty() && (str.front() == '.' || (str.front() >= '0' && str.front() <= '9'))) {
+		auto stream = std::istringstream(std::string(str));
+		stream.imbue(std::locale::classic());
+		stream >> value;
+		return stream.fail() || !stream.eof() ? std::errc::invalid_argument : std::errc{};
+	}
+	const auto buffer = (hex ? std::string("0x") : std::string()) + std::string(str);
+	char* end = nullptr;
+	errno = 0;
+	if constexpr (std::is_same_v<T, float>) {
+		value = std::strtof(buffer.c_str(), &end);
+	} else if constexpr (std::is_same_v<T, double>) {
+		value = std::strtod(buffer.c_str(), &end);
 	} else {
-		throw parser_error{fmt::format("Failed to parse '{}' as boolean", str)};
+		value = std::strtold(buffer.c_str(), &end);
+	}
+	if (str.empty() || end != buffer.c_str() + buffer.size()) {
+		return std::errc::invalid_argument;
 	}
+	return errno == ERANGE ? std::errc::result_out_of_range : std::errc{};
+#endif
+}
+
+// Parses floating point numbers independent of the locale, ignoring surrounding whitespace.
+template <typename T>
+[[nodiscard]] T parse_float(const std::string_view str, const float_syntax syntax)
+{
+	auto value = trim_whitespace(str);
+	const auto negative = !value.empty() && value.front() == '-';
+	if (!value.empty() && (value.front() == '+' || value.front() == '-')) {
+		value.remove_prefix(1);
+	}
+	const auto hex = value.size() >= 2 && value[0] == '0' && (value[1] == 'x' || value[1] == 'X');
+	const auto special = !value.empty() && (value.front() == 'i' || value.front() == 'I' || value.front() == 'n'
+	                                        || value.front() == 'N');
+	if ((hex || special) && syntax != float_syntax::extended) {
+		throw parser_error{fmt::format("Failed to parse '{}' as floating point number", str)};
+	}
+
+	auto parsed = T{};
+	const auto ec = parse_float_magnitude(hex ? value.substr(2) : value, hex, parsed);
+	if (ec == std::errc::result_out_of_range) {
+		throw parser_error{fmt::format("Value '{}' is out of range of the type", str)};
+	}
+	if (ec != std::errc{}) {
+		throw parser_error{fmt::format("Failed to parse '{}' as floating point number", str)};
+	}
+	return negative ? -parsed : parsed;
 }
 
 template <typename T>
 [[nodiscard]] T construct_from_string(const std::string_view str)
 {
-	if constexpr (is_string_constructible_v<T>) {
+	if constexpr (is_string_reference_v<T>) {
+		// The parsed and validated prefix keeps the string alive, see 'value_snapshot'.
+		return T(str);
+	} else if constexpr (std::is_same_v<T, bool>) {
+		return parse_bool(str);
+	} else if constexpr (std::is_floating_point_v<T>) {
+		return parse_float<T>(str, float_syntax::decimal);
+	} else if constexpr (is_string_constructible_v<T>) {
 		try {
 			return T(std::string(str));
 		} catch (const parser_error&) {
@@ -100,17 +256,7 @@ template <typename T>
 		auto stream = std::istringstream(std::string(str));
 		auto parsed = T();
 		try {
-			if constexpr (std::is_same_v<T, bool>) {
-				stream >> parsed;
-				if (stream.fail()) {
-					stream = std::istringstream(std::string(str));
-					std::string bool_str;
-					stream >> bool_str;
-					parsed = parse_bool(bool_str);
-				}
-			} else {
-				stream >> parsed;
-			}
+			stream >> parsed;
 			if (!stream.eof()) {
 				stream >> std::ws;
 			}
@@ -128,7 +274,7 @@ template <typename T>
 			throw parser_error{fmt::format("Input '{}' was only parsed partially with remaining data '{}'", str,
 			                               stream.str().substr(stream.tellg()))};
 		}
-		if constexpr (!std::is_same_v<T, bool> && std::is_unsigned_v<T>) {
+		if constexpr (std::is_unsigned_v<T>) {
 			auto signed_parsed = std::int64_t{};
 			auto signed_stream = std::istringstream(std::string(str));
 			signed_stream >> signed_parsed;
@@ -162,6 +308,15 @@ struct default_parser {
 	[[nodiscard]] T operator()(const std::string_view str) const { return detail::construct_from_string<T>(str); }
 };
 
+// Parses floating point numbers with the syntax 'Syntax', e.g. to accept hexadecimal numbers and special values, which
+// 'default_parser' does not.
+template <typename T, float_syntax Syntax = float_syntax::decimal>
+struct float_parser {
+	static_assert(std::is_floating_point_v<T>, "Float parser requires a floating point type.");
+
+	[[nodiscard]] T operator()(const std::string_view str) const { return detail::parse_float<T>(str, Syntax); }
+};
+
 template <typename T>
 struct default_parser_and_validator {
 	[[nodiscard]] T operator()(const std::string_view str) const
@@ -175,33 +330,29 @@ struct default_parser_and_validator {
 namespace detail {
 
 template <typename T, typename ParserAndValidator>
-[[nodiscard]] expected<T, std::string> parse_or_error(const std::string_view env_var_name,
-                                                      const std::string_view env_var_value,
-                                                      ParserAndValidator&& parser_and_validator)
+[[nodiscard]] expected<T, error_details> parse_or_error(const std::string_view env_var_value,
+                                                        ParserAndValidator&& parser_and_validator)
 {
-	using expected_t = expected<T, std::string>;
+	using expected_t = expected<T, error_details>;
 	using unexpected_t = typename expected_t::unexpected_type;
 
-	auto error_msg = typename expected_t::error_type();
-
 	try {
 		return expected_t{parser_and_validator(env_var_value)};
 	} catch (const parser_error& e) {
-		error_msg = fmt::format("Parser error for environment variable '{}': {}", env_var_name, e.what());
+		return expected_t{unexpected_t{error_details{error_kind::parser, e.what()}}};
 	} catch (const validation_error& e) {
-		error_msg = fmt::format("Validation error for environment variable '{}': {}", env_var_name, e.what());
+		return expected_t{unexpected_t{error_details{error_kind::validation, e.what()}}};
 	} catch (const range_error& e) {
-		error_msg = fmt::format("Range error for environment variable '{}': {}", env_var_name, e.what());
+		return expected_t{unexpected_t{error_details{error_kind::range, e.what()}}};
 	} catch (const option_error& e) {
-		error_msg = fmt::format("Option error for environment variable '{}': {}", env_var_name, e.what());
+		return expected_t{unexpected_t{error_details{error_kind::option, e.what()}}};
+	} catch (const async_timeout& e) {
+		return expected_t{unexpected_t{error_details{error_kind::timeout, std::to_string(e.timeout.count())}}};
 	} catch (const std::exception& e) {
-		error_msg =
-		    fmt::format("Failed to parse or validate environment variable '{}' with: {}", env_var_name, e.what());
+		return expected_t{unexpected_t{error_details{error_kind::exception, e.what()}}};
 	} catch (...) {
-		error_msg =
-		    fmt::format("Failed to parse or validate environment variable '{}' with unknown error", env_var_name);
+		return expected_t{unexpected_t{error_details{error_kind::unknown_exception, {}}}};
 	}
-	return expected_t{unexpected_t{error_msg}};
 }
 
 } // namespace detail
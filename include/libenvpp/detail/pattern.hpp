@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace env::detail {
+
+// Regular expression compiled to a deterministic finite automaton, which matches in a single pass over the value
+// with one table lookup per character. Patterns always match the whole value, and support the syntax:
+//
+//     abc       literal characters, special characters are escaped with '\'
+//     .         any character except '\n'
+//     [a-z_]    character class, negated with '[^...]'
+//     \d \w \s  digit, word and whitespace characters, negated with \D \W \S
+//     (...)     group, '(?:...)' is accepted as well
+//     a|b       alternation
+//     * + ?     repetition, and bounded repetition with {n}, {n,} and {n,m}
+//
+// A leading '^' and a trailing '$' are accepted and ignored. Characters are bytes, so UTF-8 encoded characters in a
+// pattern only match as a sequence of literal characters.
+class compiled_pattern {
+  public:
+	static constexpr auto MAX_STATES = std::size_t{4096};
+	static constexpr auto MAX_REPETITIONS = 255;
+	static constexpr auto NO_MISMATCH = std::string_view::npos;
+
+	// Throws 'invalid_pattern' if 'pattern' is malformed, or its automaton would have more than 'MAX_STATES' states.
+	explicit compiled_pattern(const std::string_view pattern);
+
+	[[nodiscard]] const std::string& pattern() const noexcept { return m_pattern; }
+	[[nodiscard]] std::size_t state_count() const noexcept { return m_accepting.size(); }
+
+	// Returns the offset of the first character at which 'str' cannot match any more, 'str.size()' if 'str' is a
+	// prefix of a match, or 'NO_MISMATCH' if 'str' matches.
+	[[nodiscard]] std::size_t find_mismatch(const std::string_view str) const noexcept
+	{
+		auto state = m_start;
+		for (std::size_t i = 0; i < str.size(); ++i) {
+			state = m_transitions[state * 256 + static_cast<unsigned char>(str[i])];
+			if (state == DEAD_STATE) {
+				return i;
+			}
+		}
+		return m_accepting[state] ? NO_MISMATCH : str.size();
+	}
+
+	[[nodiscard]] bool matches(const std::string_view str) const noexcept { return find_mismatch(str) == NO_MISMATCH; }
+
+  private:
+	static constexpr auto DEAD_STATE = std::uint32_t{0};
+
+	std::string m_pattern;
+	std::vector<std::uint32_t> m_transitions;
+	std::vector<bool> m_accepting;
+	std::uint32_t m_start = DEAD_STATE;
+};
+
+} // namespace env::detail
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#include <libenvpp/detail/hash.hpp>
+
+namespace env::detail {
+
+// Perfect hashing by hash and displace: keys are distributed into buckets by their hash, and each bucket stores a
+// displacement which places all keys of the bucket into distinct, unoccupied slots of the table. A lookup therefore
+// takes one hash of the key and one comparison against the key stored in its slot.
+
+inline constexpr auto PERFECT_HASH_KEYS_PER_BUCKET = std::size_t{4};
+inline constexpr auto PERFECT_HASH_MAX_DISPLACEMENT = std::uint32_t{1} << 20;
+
+[[nodiscard]] constexpr std::size_t perfect_hash_bucket_count(const std::size_t key_count) noexcept
+{
+	return key_count == 0 ? 1 : (key_count + PERFECT_HASH_KEYS_PER_BUCKET - 1) / PERFECT_HASH_KEYS_PER_BUCKET;
+}
+
+[[nodiscard]] constexpr std::size_t perfect_hash_table_size(const std::size_t key_count) noexcept
+{
+	return key_count == 0 ? 1 : key_count + key_count / 4;
+}
+
+// Number of elements of the scratch space required to build a table of 'key_count' keys.
+[[nodiscard]] constexpr std::size_t perfect_hash_scratch_size(const std::size_t key_count) noexcept
+{
+	return 2 * key_count + perfect_hash_bucket_count(key_count) + 1;
+}
+
+[[nodiscard]] constexpr std::size_t perfect_hash_bucket(const std::uint64_t hash,
+                                                        const std::size_t bucket_count) noexcept
+{
+	return static_cast<std::size_t>((hash >> 32) % bucket_count);
+}
+
+[[nodiscard]] constexpr std::size_t perfect_hash_slot(const std::uint64_t hash, const std::uint32_t displacement,
+                                                      const std::size_t table_size) noexcept
+{
+	return static_cast<std::size_t>(hash_combine(hash, displacement) % table_size);
+}
+
+// Returns the index of 'key' in 'keys', or 'key_count' if it is not one of the keys.
+[[nodiscard]] constexpr std::size_t perfect_hash_find(const std::string_view key, const std::string_view* keys,
+                                                      const std::size_t key_count, const std::uint32_t* displacements,
+                                                      const std::size_t bucket_count, const std::size_t* slots,
+                                                      const std::size_t table_size) noexcept
+{
+	const auto hash = fnv1a(key);
+	const auto id = slots[perfect_hash_slot(hash, displacements[perfect_hash_bucket(hash, bucket_count)], table_size)];
+	return id < key_count && keys[id] == key ? id : key_count;
+}
+
+// Builds the displacements and slots of a table for the given keys, sized according to 'perfect_hash_bucket_count'
+// and 'perfect_hash_table_size'. Empty slots are set to 'key_count'. Usable at compile time, and throws if the keys
+// contain duplicates.
+constexpr void build_perfect_hash(const std::string_view* keys, const std::size_t key_count,
+                                  std::uint32_t* displacements, std::size_t* slots, std::size_t* scratch)
+{
+	const auto bucket_count = perfect_hash_bucket_count(key_count);
+	const auto table_size = perfect_hash_table_size(key_count);
+
+	// Counting sort of the keys by bucket, 'bucket_offsets[b]' to 'bucket_offsets[b + 1]' are the keys of bucket 'b'.
+	auto* const bucket_offsets = scratch;
+	auto* const bucket_keys = scratch + bucket_count + 1;
+	auto* const bucket_slots = bucket_keys + key_count;
+	for (std::size_t b = 0; b <= bucket_count; ++b) {
+		bucket_offsets[b] = 0;
+	}
+	for (std::size_t i = 0; i < key_count; ++i) {
+		++bucket_offsets[perfect_hash_bucket(fnv1a(keys[i]), bucket_count) + 1];
+	}
+	auto max_bucket_size = std::size_t{0};
+	for (std::size_t b = 0; b < bucket_count; ++b) {
+		max_bucket_size = bucket_offsets[b + 1] > max_bucket_size ? bucket_offsets[b + 1] : max_bucket_size;
+		bucket_offsets[b + 1] += bucket_offsets[b];
+	}
+	for (std::size_t i = 0; i < key_count; ++i) {
+		const auto b = perfect_hash_bucket(fnv1a(keys[i]), bucket_count);
+		bucket_keys[bucket_offsets[b]++] = i;
+	}
+	for (std::size_t b = bucket_count; b > 0; --b) {
+		bucket_offsets[b] = bucket_offsets[b - 1];
+	}
+	bucket_offsets[0] = 0;
+
+	for (std::size_t s = 0; s < table_size; ++s) {
+		slots[s] = key_count;
+	}
+
+	// Larger buckets are harder to place, and are therefore placed first.
+	for (auto bucket_size = max_bucket_size; bucket_size > 0; --bucket_size) {
+		for (std::size_t b = 0; b < bucket_count; ++b) {
+			if (bucket_offsets[b + 1] - bucket_offsets[b] != bucket_size) {
+				continue;
+			}
+
+			// Keys with identical hashes, which are practically always duplicate keys, can never be placed.
+			for (std::size_t i = bucket_offsets[b]; i < bucket_offsets[b + 1]; ++i) {
+				for (std::size_t j = i + 1; j < bucket_offsets[b + 1]; ++j) {
+					if (fnv1a(keys[bucket_keys[i]]) == fnv1a(keys[bucket_keys[j]])) {
+						throw std::invalid_argument("Failed to build perfect hash, keys must be unique");
+					}
+				}
+			}
+
+			auto displacement = std::uint32_t{0};
+			for (; displacement < PERFECT_HASH_MAX_DISPLACEMENT; ++displacement) {
+				auto placed = std::size_t{0};
+				for (; placed < bucket_size; ++placed) {
+					const auto key = bucket_keys[bucket_offsets[b] + placed];
+					const auto slot = perfect_hash_slot(fnv1a(keys[key]), displacement, table_size);
+					auto is_free = slots[slot] == key_count;
+					for (std::size_t i = 0; i < placed && is_free; ++i) {
+						is_free = bucket_slots[i] != slot;
+					}
+					if (!is_free) {
+						break;
+					}
+					bucket_slots[placed] = slot;
+				}
+				if (placed == bucket_size) {
+					break;
+				}
+			}
+			if (displacement == PERFECT_HASH_MAX_DISPLACEMENT) {
+				throw std::invalid_argument("Failed to build perfect hash, no displacement found");
+			}
+
+			displacements[b] = displacement;
+			for (std::size_t i = 0; i < bucket_size; ++i) {
+				slots[bucket_slots[i]] = bucket_keys[bucket_offsets[b] + i];
+			}
+		}
+	}
+}
+
+// Perfect hash table of a fixed set of keys, which can be built at compile time:
+//
+//     constexpr auto table = perfect_hash_table<2>({"MYPROG_LOG_FILE_PATH", "MYPROG_NUM_THREADS"});
+//     static_assert(table.find("MYPROG_NUM_THREADS") == 1);
+//
+// The keys are referenced, not copied, and must outlive the table, which is always the case for string literals.
+template <std::size_t N>
+class perfect_hash_table {
+  public:
+	static constexpr auto bucket_count = perfect_hash_bucket_count(N);
+	static constexpr auto table_size = perfect_hash_table_size(N);
+
+	constexpr explicit perfect_hash_table(const std::array<std::string_view, N>& keys) : m_keys(keys)
+	{
+		auto scratch = std::array<std::size_t, perfect_hash_scratch_size(N)>{};
+		build_perfect_hash(m_keys.data(), N, m_displacements.data(), m_slots.data(), scratch.data());
+	}
+
+	[[nodiscard]] static constexpr std::size_t size() noexcept { return N; }
+
+	[[nodiscard]] constexpr const std::array<std::string_view, N>& keys() const noexcept { return m_keys; }
+
+	// Returns the index of 'key' in the keys the table was built from, or 'size()' if it is not one of them.
+	[[nodiscard]] constexpr std::size_t find(const std::string_view key) const noexcept
+	{
+		return perfect_hash_find(key, m_keys.data(), N, m_displacements.data(), bucket_count, m_slots.data(),
+		                         table_size);
+	}
+
+  private:
+	std::array<std::string_view, N> m_keys{};
+	std::array<std::uint32_t, bucket_count> m_displacements{};
+	std::array<std::size_t, table_size> m_slots{};
+};
+
+} // namespace env::detail
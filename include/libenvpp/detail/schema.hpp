@@ -0,0 +1,167 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <libenvpp/detail/edit_distance.hpp>
+#include <libenvpp/detail/environment.hpp>
+#include <libenvpp/detail/errors.hpp>
+#include <libenvpp/detail/parser.hpp>
+#include <libenvpp/detail/testing.hpp>
+
+namespace env {
+
+// Result of parsing and validating a configuration struct generated by 'libenvpp_codegen' from a manifest.
+template <typename Config>
+class parsed_config {
+  public:
+	parsed_config() = delete;
+	parsed_config(Config config, std::vector<error> errors, std::vector<error> warnings)
+	    : m_config(std::move(config)), m_errors(std::move(errors)), m_warnings(std::move(warnings))
+	{
+	}
+
+	parsed_config(const parsed_config&) = delete;
+	parsed_config(parsed_config&&) = default;
+
+	parsed_config& operator=(const parsed_config&) = delete;
+	parsed_config& operator=(parsed_config&&) = default;
+
+	[[nodiscard]] bool ok() const noexcept { return m_errors.empty() && m_warnings.empty(); }
+
+	// Values of required variables are only meaningful if there are no errors.
+	[[nodiscard]] const Config& get() const noexcept { return m_config; }
+
+	[[nodiscard]] std::string error_message() const { return detail::format_messages("Error", m_errors); }
+
+	void error_message(fmt::memory_buffer& buffer) const { detail::format_messages(buffer, "Error", m_errors); }
+
+	[[nodiscard]] std::string warning_message() const { return detail::format_messages("Warning", m_warnings); }
+
+	void warning_message(fmt::memory_buffer& buffer) const { detail::format_messages(buffer, "Warning", m_warnings); }
+
+	[[nodiscard]] const std::vector<error>& errors() const noexcept { return m_errors; }
+
+	[[nodiscard]] const std::vector<error>& warnings() const noexcept { return m_warnings; }
+
+  private:
+	Config m_config;
+	std::vector<error> m_errors;
+	std::vector<error> m_warnings;
+};
+
+namespace detail {
+
+// Parses the variables of a schema known at compile time, as generated by 'libenvpp_codegen'. The schema provides:
+//  - 'prefix', the prefix of all variables including the delimiter,
+//  - 'size', the number of variables,
+//  - 'names', the full names of all variables,
+//  - 'find(name)', which returns the index of the variable with the given full name, or 'size' if there is none.
+// Errors and warnings are reported like by 'parse_and_validate' of a prefix with the same variables.
+template <typename Schema>
+class schema_parser {
+  public:
+	schema_parser() = delete;
+	// Reads through the testing environment in effect for the calling thread before 'environment', see
+	// 'testing_environment_view'.
+	explicit schema_parser(const std::unordered_map<std::string, std::string>& environment)
+	    : m_environment(environment)
+	{
+		m_environment.for_each([this](const std::string_view name, const std::string_view value) {
+			if (const auto id = Schema::find(name); id < Schema::size) {
+				m_values[id] = value;
+			}
+		});
+	}
+
+	schema_parser(const schema_parser&) = delete;
+	schema_parser(schema_parser&&) = delete;
+
+	schema_parser& operator=(const schema_parser&) = delete;
+	schema_parser& operator=(schema_parser&&) = delete;
+
+	template <std::size_t Id, typename T>
+	void parse_required(T& value)
+	{
+		if (auto res = parse<Id, T>(); res.has_value()) {
+			value = std::move(res).value();
+		}
+	}
+
+	template <std::size_t Id, typename T>
+	void parse_optional(std::optional<T>& value)
+	{
+		value = parse<Id, T>();
+	}
+
+	template <typename Config>
+	[[nodiscard]] parsed_config<Config> finish(Config config)
+	{
+		// Variables of the schema are only consumed if necessary, to detect typos of variables not set in the
+		// environment.
+		if (!m_unset.empty()) {
+			for (const auto name : Schema::names) {
+				m_environment.consume(name);
+			}
+		}
+
+		for (const auto& [id, is_required] : m_unset) {
+			const auto name = Schema::names[id];
+			const auto edit_distance_cutoff = default_edit_distance.get_or_default(name.length());
+			auto similar_env_var_error = get_similar_env_var_error(name, edit_distance_cutoff, m_environment);
+			if (similar_env_var_error.has_value()) {
+				auto err = make_error(id, name, name, std::move(similar_env_var_error).value());
+				if (is_required) {
+					m_errors.push_back(std::move(err));
+				} else {
+					m_warnings.push_back(std::move(err));
+				}
+			} else if (is_required) {
+				m_errors.push_back(make_error(id, name, name, {error_kind::unset, {}}));
+			}
+		}
+
+		m_environment.for_each([this](const std::string_view name, const std::string_view) {
+			if (name.find(Schema::prefix) == 0 && Schema::find(name) == Schema::size) {
+				m_warnings.push_back(make_owned_error(-1, name, {error_kind::unused, {}}));
+			}
+		});
+
+		return {std::move(config), std::move(m_errors), std::move(m_warnings)};
+	}
+
+  private:
+	template <std::size_t Id, typename T>
+	[[nodiscard]] std::optional<T> parse()
+	{
+		static_assert(Id < Schema::size, "Variable index out of range of the schema");
+		constexpr auto name = Schema::names[Id];
+		if (!m_values[Id]) {
+			m_unset.emplace_back(Id, Schema::required[Id]);
+			return std::nullopt;
+		}
+
+		auto res = parse_or_error<T>(*m_values[Id], default_parser_and_validator<T>{});
+		if (!res.has_value()) {
+			m_errors.push_back(make_error(Id, name.substr(Schema::prefix.size()), name, std::move(res).error()));
+			return std::nullopt;
+		}
+		return std::move(res).value();
+	}
+
+	testing_environment_view m_environment;
+	std::array<std::optional<std::string_view>, Schema::size> m_values{};
+	std::vector<std::pair<std::size_t, bool>> m_unset;
+	std::vector<error> m_errors;
+	std::vector<error> m_warnings;
+};
+
+} // namespace detail
+
+} // namespace env
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <libenvpp/detail/expected.hpp>
+
+namespace env {
+
+// Upper bound on the size of a secret file referenced through a '<NAME>_FILE' environment variable.
+inline constexpr auto default_secret_file_size_limit = std::size_t{64 * 1024};
+
+// Releases all cached secret file contents, zeroing their buffers once no parse references them anymore.
+void clear_secret_file_cache();
+
+namespace detail {
+
+inline constexpr auto SECRET_FILE_SUFFIX = std::string_view{"_FILE"};
+
+void secure_zero(void* data, const std::size_t size) noexcept;
+
+// Heap buffer holding secret data, which is zeroed before it is released.
+class secret_buffer {
+  public:
+	secret_buffer() = delete;
+	explicit secret_buffer(const std::size_t size) : m_data(std::make_unique<char[]>(size)), m_size(size) {}
+
+	secret_buffer(const secret_buffer&) = delete;
+	secret_buffer(secret_buffer&&) = default;
+
+	secret_buffer& operator=(const secret_buffer&) = delete;
+	secret_buffer& operator=(secret_buffer&& other) noexcept
+	{
+		release();
+		m_data = std::move(other.m_data);
+		m_size = other.m_size;
+		other.m_size = 0;
+		return *this;
+	}
+
+	~secret_buffer() { release(); }
+
+	[[nodiscard]] char* data() noexcept { return m_data.get(); }
+	[[nodiscard]] const char* data() const noexcept { return m_data.get(); }
+	[[nodiscard]] std::size_t size() const noexcept { return m_size; }
+	[[nodiscard]] std::string_view view() const noexcept { return {m_data.get(), m_size}; }
+
+	// Shrinks the visible size of the buffer, zeroing the discarded tail.
+	void truncate(const std::size_t size) noexcept
+	{
+		if (size < m_size) {
+			secure_zero(m_data.get() + size, m_size - size);
+			m_size = size;
+		}
+	}
+
+  private:
+	void release() noexcept
+	{
+		if (m_data) {
+			secure_zero(m_data.get(), m_size);
+		}
+	}
+
+	std::unique_ptr<char[]> m_data;
+	std::size_t m_size;
+};
+
+// Reads the secret file at 'path', with at most 'size_limit' bytes and a single trailing newline removed. The content
+// is cached keyed by path and modification time, so unchanged files are only read once.
+[[nodiscard]] expected<std::shared_ptr<const secret_buffer>, std::string>
+read_secret_file(const std::string_view path, const std::size_t size_limit);
+
+} // namespace detail
+
+} // namespace env
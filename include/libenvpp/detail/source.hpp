@@ -0,0 +1,106 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <libenvpp/detail/environment.hpp>
+
+namespace env {
+
+// A configuration layer from which the values of registered variables can be retrieved.
+class source {
+  public:
+	virtual ~source() = default;
+
+	// Name of the layer, used to report where a value came from.
+	[[nodiscard]] virtual std::string_view name() const noexcept = 0;
+
+	// Looks up the value of a registered variable, given its full name (including the prefix) and its registered name.
+	[[nodiscard]] virtual std::optional<std::string_view> find(const std::string_view full_name,
+	                                                           const std::string_view name) const = 0;
+};
+
+// Sources ordered from highest to lowest precedence.
+using source_chain = std::vector<std::reference_wrapper<const source>>;
+
+// The process environment, or a custom environment. Typo and unused variable detection is performed on the first
+// environment source of a chain, which also includes the global testing environment.
+class environment_source final : public source {
+  public:
+	explicit environment_source(std::unordered_map<std::string, std::string> environment = detail::get_environment())
+	    : m_environment(std::move(environment))
+	{
+	}
+
+	[[nodiscard]] std::string_view name() const noexcept override { return "environment"; }
+
+	[[nodiscard]] std::optional<std::string_view> find(const std::string_view full_name,
+	                                                   const std::string_view) const override;
+
+	[[nodiscard]] const std::unordered_map<std::string, std::string>& environment() const noexcept
+	{
+		return m_environment;
+	}
+
+  private:
+	std::unordered_map<std::string, std::string> m_environment;
+};
+
+// Command line arguments of the form '--num-threads=8', which map to the registered variable 'NUM_THREADS'. Arguments
+// of any other form are ignored, as are all arguments following '--'. If an option is given multiple times the last
+// one takes precedence. The arguments are referenced, not copied, and must outlive the source.
+class command_line_source final : public source {
+  public:
+	command_line_source(const int argc, const char* const* argv);
+
+	[[nodiscard]] std::string_view name() const noexcept override { return "command line"; }
+
+	[[nodiscard]] std::optional<std::string_view> find(const std::string_view,
+	                                                   const std::string_view name) const override;
+
+  private:
+	std::vector<std::pair<std::string_view, std::string_view>> m_options;
+};
+
+// Key/value pairs, keyed either by the full name or the registered name of a variable, e.g. to provide defaults.
+class map_source : public source {
+  public:
+	map_source(std::string name, std::unordered_map<std::string, std::string> values)
+	    : m_name(std::move(name)),
+	      m_values(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()))
+	{
+	}
+
+	[[nodiscard]] std::string_view name() const noexcept override { return m_name; }
+
+	[[nodiscard]] std::optional<std::string_view> find(const std::string_view full_name,
+	                                                   const std::string_view name) const override;
+
+  private:
+	std::string m_name;
+	// Ordered with a transparent comparison, so that names are looked up without constructing a string.
+	std::map<std::string, std::string, std::less<>> m_values;
+};
+
+// Configuration file consisting of 'KEY=VALUE' lines, keyed like a 'map_source'. Empty lines and lines starting with
+// '#' are ignored, whitespace around keys and values as well as quotes enclosing values are removed.
+class file_source final : public map_source {
+  public:
+	explicit file_source(const std::filesystem::path& path);
+};
+
+namespace detail {
+
+[[nodiscard]] std::unordered_map<std::string, std::string> parse_config_file(const std::filesystem::path& path);
+
+} // namespace detail
+
+} // namespace env
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace env {
+
+class string_ref;
+
+namespace detail {
+
+inline void share_ownership(string_ref& ref, std::shared_ptr<const void> owner) noexcept;
+
+} // namespace detail
+
+// Value of a variable which references the value in the environment snapshot of the parsed and validated prefix
+// instead of copying it. The snapshot is kept alive by every 'string_ref', so unlike a 'std::string_view' value it
+// remains valid after the parsed and validated prefix is destroyed.
+class string_ref {
+  public:
+	string_ref() = default;
+	explicit string_ref(const std::string_view str) noexcept : m_view(str) {}
+
+	[[nodiscard]] const char* data() const noexcept { return m_view.data(); }
+	[[nodiscard]] std::size_t size() const noexcept { return m_view.size(); }
+	[[nodiscard]] bool empty() const noexcept { return m_view.empty(); }
+
+	[[nodiscard]] std::string_view view() const noexcept { return m_view; }
+	[[nodiscard]] std::string str() const { return std::string(m_view); }
+
+	operator std::string_view() const noexcept { return m_view; }
+
+	[[nodiscard]] friend bool operator==(const string_ref& lhs, const string_ref& rhs) noexcept
+	{
+		return lhs.m_view == rhs.m_view;
+	}
+	[[nodiscard]] friend bool operator!=(const string_ref& lhs, const string_ref& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+	[[nodiscard]] friend bool operator==(const string_ref& lhs, const std::string_view rhs) noexcept
+	{
+		return lhs.m_view == rhs;
+	}
+	[[nodiscard]] friend bool operator!=(const string_ref& lhs, const std::string_view rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, const string_ref& str) { return os << str.m_view; }
+
+  private:
+	std::shared_ptr<const void> m_owner;
+	std::string_view m_view;
+
+	friend void detail::share_ownership(string_ref& ref, std::shared_ptr<const void> owner) noexcept;
+};
+
+namespace detail {
+
+// Makes 'ref' keep 'owner', which owns the referenced string, alive.
+inline void share_ownership(string_ref& ref, std::shared_ptr<const void> owner) noexcept
+{
+	ref.m_owner = std::move(owner);
+}
+
+// Types whose values reference the string they were parsed from, which therefore has to outlive them.
+template <typename T>
+struct is_string_reference : std::disjunction<std::is_same<T, std::string_view>, std::is_same<T, string_ref>> {
+};
+
+template <typename T>
+inline constexpr auto is_string_reference_v = is_string_reference<T>::value;
+
+} // namespace detail
+
+} // namespace env
@@ -1,29 +1,158 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace env {
 
 namespace detail {
 
-extern std::unordered_map<std::string, std::string> g_testing_environment;
+// Stack of frames of testing environment variables, where each frame holds the variables of one scope. Frames are
+// referenced, not copied, so pushing and popping a frame is independent of the number of variables, and lookups read
+// through all frames from the innermost to the outermost one.
+class testing_environment_frames {
+  public:
+	// Ordered by a transparent comparison, so that looking up a variable does not construct a 'std::string'.
+	using frame = std::map<std::string, std::string, std::less<>>;
+
+	void push(const frame& variables) { m_frames.push_back(&variables); }
+
+	// Frames are usually popped in reverse order of being pushed, but any frame may be popped.
+	void pop(const frame& variables);
+
+	[[nodiscard]] std::optional<std::string_view> find(const std::string_view name) const;
+
+	// Total number of variables of all frames, including variables shadowed by inner frames.
+	[[nodiscard]] std::size_t size() const noexcept;
+
+	[[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+	// Appends the frames to 'frames', from the innermost to the outermost one.
+	void append_frames(std::vector<const frame*>& frames) const;
+
+  private:
+	std::vector<const frame*> m_frames;
+};
+
+extern testing_environment_frames g_testing_environment;
+
+// Finds a variable in the testing environment in effect for the calling thread, which is the thread's
+// 'scoped_thread_test_environment's if there are any, and the global testing environment otherwise.
+[[nodiscard]] std::optional<std::string_view> find_testing_variable(const std::string_view name);
+
+// Environment considered for parsing and validating, which reads through the testing environment in effect for the
+// calling thread before 'environment', without copying or merging either of them. Variables may be consumed, which
+// excludes them from the variables visited for typo and unused variable detection.
+class testing_environment_view {
+  public:
+	testing_environment_view() = delete;
+	explicit testing_environment_view(const std::unordered_map<std::string, std::string>& environment);
+
+	testing_environment_view(const testing_environment_view&) = delete;
+	testing_environment_view(testing_environment_view&&) = delete;
+
+	testing_environment_view& operator=(const testing_environment_view&) = delete;
+	testing_environment_view& operator=(testing_environment_view&&) = delete;
+
+	[[nodiscard]] std::optional<std::string_view> find(const std::string_view name) const;
+
+	// Calls 'fn' with the name and value of every variable which has not been consumed, once per name, where
+	// variables set for testing shadow variables of the same name of outer frames and of the environment.
+	template <typename Fn>
+	void for_each(Fn&& fn) const
+	{
+		for (std::size_t i = 0; i < m_frames.size(); ++i) {
+			for (const auto& [name, value] : *m_frames[i]) {
+				if (!is_consumed(name) && !is_shadowed(name, i)) {
+					fn(name, value);
+				}
+			}
+		}
+		for (const auto& [name, value] : m_environment) {
+			if (!is_consumed(name) && !is_shadowed(name, m_frames.size())) {
+				fn(name, value);
+			}
+		}
+	}
+
+	// Finds the variable which has not been consumed whose name is closest to 'name', within 'edit_distance_cutoff'.
+	[[nodiscard]] std::optional<std::string_view> find_similar(const std::string_view name,
+	                                                           const int edit_distance_cutoff) const;
 
-[[nodiscard]] std::unordered_map<std::string, std::string>
-merge_environments(const std::unordered_map<std::string, std::string>& high_precedence_env,
-                   const std::unordered_map<std::string, std::string>& low_precedence_env);
+	// 'name' must outlive the view.
+	void consume(const std::string_view name) { m_consumed.insert(name); }
+
+	[[nodiscard]] bool is_consumed(const std::string_view name) const
+	{
+		return !m_consumed.empty() && m_consumed.count(name) > 0;
+	}
+
+  private:
+	// Whether one of the first 'frame_count' frames sets the variable 'name'.
+	[[nodiscard]] bool is_shadowed(const std::string_view name, const std::size_t frame_count) const;
+
+	const std::unordered_map<std::string, std::string>& m_environment;
+	// From the innermost to the outermost frame.
+	std::vector<const testing_environment_frames::frame*> m_frames;
+	std::unordered_set<std::string_view> m_consumed;
+	// Looking up a variable in the environment requires a 'std::string', which is reused for all lookups.
+	mutable std::string m_lookup_key;
+};
 
 } // namespace detail
 
 class [[nodiscard]] scoped_test_environment {
   public:
 	scoped_test_environment(const std::string_view name, const std::string_view value);
-	scoped_test_environment(const std::unordered_map<std::string, std::string>& environment);
+	scoped_test_environment(std::unordered_map<std::string, std::string> environment);
+
+	scoped_test_environment(const scoped_test_environment&) = delete;
+	scoped_test_environment(scoped_test_environment&&) = delete;
+
+	scoped_test_environment& operator=(const scoped_test_environment&) = delete;
+	scoped_test_environment& operator=(scoped_test_environment&&) = delete;
+
 	~scoped_test_environment();
 
   private:
-	const std::unordered_map<std::string, std::string> m_environment;
+	const detail::testing_environment_frames::frame m_environment;
+};
+
+enum class global_test_environment {
+	ignore,
+	fallback,
+};
+
+// Testing environment local to the calling thread, scopes may be nested and inner scopes take precedence over outer
+// ones. Unlike with 'scoped_test_environment', tests running concurrently on different threads, or nested sections of
+// a test, can therefore set conflicting values. While a thread has active scopes the global testing environment is
+// ignored for that thread, unless one of its scopes opts into falling back to it.
+// Scopes must be destroyed in reverse order of construction, on the thread that constructed them.
+class [[nodiscard]] scoped_thread_test_environment {
+  public:
+	scoped_thread_test_environment(const std::string_view name, const std::string_view value,
+	                               const global_test_environment global = global_test_environment::ignore);
+	scoped_thread_test_environment(std::unordered_map<std::string, std::string> environment,
+	                               const global_test_environment global = global_test_environment::ignore);
+
+	scoped_thread_test_environment(const scoped_thread_test_environment&) = delete;
+	scoped_thread_test_environment(scoped_thread_test_environment&&) = delete;
+
+	scoped_thread_test_environment& operator=(const scoped_thread_test_environment&) = delete;
+	scoped_thread_test_environment& operator=(scoped_thread_test_environment&&) = delete;
+
+	~scoped_thread_test_environment();
+
+  private:
+	const detail::testing_environment_frames::frame m_environment;
+	const global_test_environment m_global;
 };
 
 } // namespace env
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include <fmt/chrono.h>
+#include <fmt/core.h>
+
+#include <libenvpp/detail/cache.hpp>
+#include <libenvpp/detail/errors.hpp>
+#include <libenvpp/detail/parser.hpp>
+
+namespace env {
+
+// Size in bytes, parsed from values such as '512', '64KiB', '1.5GB' or '4GiB'.
+class byte_size {
+  public:
+	constexpr byte_size() noexcept = default;
+	constexpr explicit byte_size(const std::uint64_t bytes) noexcept : m_bytes(bytes) {}
+
+	[[nodiscard]] constexpr std::uint64_t count() const noexcept { return m_bytes; }
+
+	[[nodiscard]] friend constexpr bool operator==(const byte_size lhs, const byte_size rhs) noexcept
+	{
+		return lhs.m_bytes == rhs.m_bytes;
+	}
+	[[nodiscard]] friend constexpr bool operator!=(const byte_size lhs, const byte_size rhs) noexcept
+	{
+		return lhs.m_bytes != rhs.m_bytes;
+	}
+	[[nodiscard]] friend constexpr bool operator<(const byte_size lhs, const byte_size rhs) noexcept
+	{
+		return lhs.m_bytes < rhs.m_bytes;
+	}
+	[[nodiscard]] friend constexpr bool operator<=(const byte_size lhs, const byte_size rhs) noexcept
+	{
+		return lhs.m_bytes <= rhs.m_bytes;
+	}
+	[[nodiscard]] friend constexpr bool operator>(const byte_size lhs, const byte_size rhs) noexcept
+	{
+		return lhs.m_bytes > rhs.m_bytes;
+	}
+	[[nodiscard]] friend constexpr bool operator>=(const byte_size lhs, const byte_size rhs) noexcept
+	{
+		return lhs.m_bytes >= rhs.m_bytes;
+	}
+
+  private:
+	std::uint64_t m_bytes = 0;
+};
+
+namespace detail {
+
+template <>
+struct cached_representation<byte_size> {
+	static constexpr bool is_cacheable = true;
+
+	[[nodiscard]] static bool is_valid(const std::string_view representation) noexcept
+	{
+		return cached_representation<std::uint64_t>::is_valid(representation);
+	}
+};
+
+// Unit suffix whose value is 'num / den' of the base unit, i.e. seconds for durations and bytes for byte sizes.
+struct unit_suffix {
+	std::string_view suffix;
+	std::uint64_t num;
+	std::uint64_t den;
+};
+
+// The suffix '\xc2\xb5s' is 'µs' encoded in UTF-8.
+inline constexpr auto DURATION_SUFFIXES = std::array{
+    unit_suffix{"ns", 1, 1'000'000'000}, unit_suffix{"us", 1, 1'000'000}, unit_suffix{"\xc2\xb5s", 1, 1'000'000},
+    unit_suffix{"ms", 1, 1'000},         unit_suffix{"s", 1, 1},          unit_suffix{"min", 60, 1},
+    unit_suffix{"h", 3'600, 1},          unit_suffix{"d", 86'400, 1},
+};
+
+inline constexpr auto BYTE_SIZE_SUFFIXES = std::array{
+    unit_suffix{"B", 1, 1},
+    unit_suffix{"kB", 1'000, 1},
+    unit_suffix{"KB", 1'000, 1},
+    unit_suffix{"MB", 1'000'000, 1},
+    unit_suffix{"GB", 1'000'000'000, 1},
+    unit_suffix{"TB", 1'000'000'000'000, 1},
+    unit_suffix{"PB", 1'000'000'000'000'000, 1},
+    unit_suffix{"EB", 1'000'000'000'000'000'000, 1},
+    unit_suffix{"KiB", std::uint64_t{1} << 10, 1},
+    unit_suffix{"MiB", std::uint64_t{1} << 20, 1},
+    unit_suffix{"GiB", std::uint64_t{1} << 30, 1},
+    unit_suffix{"TiB", std::uint64_t{1} << 40, 1},
+    unit_suffix{"PiB", std::uint64_t{1} << 50, 1},
+    unit_suffix{"EiB", std::uint64_t{1} << 60, 1},
+};
+
+// Decimal number 'mantissa / scale' with the unit given by its suffix.
+struct unit_value {
+	std::uint64_t mantissa;
+	std::uint64_t scale;
+	bool negative;
+	unit_suffix unit;
+};
+
+[[nodiscard]] inline bool multiply_checked(std::uint64_t& value, const std::uint64_t factor) noexcept
+{
+	if (factor != 0 && value > std::numeric_limits<std::uint64_t>::max() / factor) {
+		return false;
+	}
+	value *= factor;
+	return true;
+}
+
+inline void reduce_fraction(std::uint64_t& num, std::uint64_t& den) noexcept
+{
+	const auto divisor = std::gcd(num, den);
+	if (divisor > 1) {
+		num /= divisor;
+		den /= divisor;
+	}
+}
+
+// Splits 'str' into an optionally negative decimal number and a unit suffix from 'suffixes'. Without a suffix the
+// unit is 'default_unit', if there is one.
+template <std::size_t N>
+[[nodiscard]] unit_value parse_unit_value(const std::string_view str, const std::array<unit_suffix, N>& suffixes,
+                                          const unit_suffix* const default_unit)
+{
+	auto value = unit_value{0, 1, false, {}};
+	auto number = str;
+	if (!number.empty() && number.front() == '-') {
+		value.negative = true;
+		number.remove_prefix(1);
+	}
+
+	const auto* const end = number.data() + number.size();
+	const auto [int_end, int_ec] = std::from_chars(number.data(), end, value.mantissa);
+	if (int_ec == std::errc::result_out_of_range) {
+		throw parser_error{fmt::format("Value '{}' is out of range of the type", str)};
+	}
+	if (int_ec != std::errc{}) {
+		throw parser_error{fmt::format("Cannot parse '{}' as a number with unit", str)};
+	}
+	auto suffix_begin = int_end;
+	if (suffix_begin != end && *suffix_begin == '.') {
+		for (++suffix_begin; suffix_begin != end && *suffix_begin >= '0' && *suffix_begin <= '9'; ++suffix_begin) {
+			const auto digit = static_cast<std::uint64_t>(*suffix_begin - '0');
+			if (!multiply_checked(value.scale, 10) || !multiply_checked(value.mantissa, 10)
+			    || value.mantissa > std::numeric_limits<std::uint64_t>::max() - digit) {
+				throw parser_error{fmt::format("Value '{}' has too many digits", str)};
+			}
+			value.mantissa += digit;
+		}
+	}
+	while (suffix_begin != end && *suffix_begin == ' ') {
+		++suffix_begin;
+	}
+
+	const auto suffix = std::string_view(suffix_begin, static_cast<std::size_t>(end - suffix_begin));
+	if (suffix.empty() && default_unit != nullptr) {
+		value.unit = *default_unit;
+		return value;
+	}
+	for (const auto& unit : suffixes) {
+		if (unit.suffix == suffix) {
+			value.unit = unit;
+			return value;
+		}
+	}
+
+	auto expected = std::string();
+	for (const auto& unit : suffixes) {
+		expected += expected.empty() ? "" : ", ";
+		expected += unit.suffix;
+	}
+	if (suffix.empty()) {
+		throw parser_error{fmt::format("Missing unit in '{}', expected one of {}", str, expected)};
+	}
+	throw parser_error{fmt::format("Unknown unit '{}' in '{}', expected one of {}", suffix, str, expected)};
+}
+
+// Returns the magnitude of 'value' in multiples of 'period_num / period_den' of the base unit, which must be exact.
+[[nodiscard]] inline std::uint64_t scale_unit_value(const std::string_view str, const unit_value& value,
+                                                    const std::uint64_t period_num, const std::uint64_t period_den)
+{
+	// mantissa * unit.num * period_den / (scale * unit.den * period_num), with every pair of numerator and denominator
+	// factors made coprime, so that the fraction is in lowest terms and only an integer if the denominator is 1.
+	auto num = std::array{value.mantissa, value.unit.num, period_den};
+	auto den = std::array{value.scale, value.unit.den, period_num};
+	for (auto& n : num) {
+		for (auto& d : den) {
+			reduce_fraction(n, d);
+		}
+	}
+	if (den[0] != 1 || den[1] != 1 || den[2] != 1) {
+		throw parser_error{fmt::format("Value '{}' cannot be represented exactly at the precision of the type", str)};
+	}
+	auto magnitude = num[0];
+	if (!multiply_checked(magnitude, num[1]) || !multiply_checked(magnitude, num[2])) {
+		throw parser_error{fmt::format("Value '{}' is out of range of the type", str)};
+	}
+	return magnitude;
+}
+
+} // namespace detail
+
+// Parses durations such as '250ms', '1.5s' or '2h'. The supported units are 'ns', 'us' (or 'µs'), 'ms', 's', 'min',
+// 'h' and 'd'. Durations with an integral representation must be represented exactly, e.g. '1.5ms' cannot be parsed
+// as 'std::chrono::milliseconds'.
+template <typename Rep, typename Period>
+struct default_parser<std::chrono::duration<Rep, Period>> {
+	[[nodiscard]] std::chrono::duration<Rep, Period> operator()(const std::string_view str) const
+	{
+		const auto value = detail::parse_unit_value(str, detail::DURATION_SUFFIXES, nullptr);
+		if constexpr (std::is_floating_point_v<Rep>) {
+			const auto magnitude = static_cast<Rep>(value.mantissa) / static_cast<Rep>(value.scale)
+			                       * static_cast<Rep>(value.unit.num) / static_cast<Rep>(value.unit.den)
+			                       * static_cast<Rep>(Period::den) / static_cast<Rep>(Period::num);
+			return std::chrono::duration<Rep, Period>(value.negative ? -magnitude : magnitude);
+		} else {
+			static_assert(std::is_integral_v<Rep>, "Duration representation must be an arithmetic type.");
+			const auto magnitude = detail::scale_unit_value(str, value, static_cast<std::uint64_t>(Period::num),
+			                                                static_cast<std::uint64_t>(Period::den));
+			if (value.negative && std::is_unsigned_v<Rep> && magnitude != 0) {
+				throw parser_error{fmt::format("Cannot parse negative duration '{}' as unsigned type", str)};
+			}
+			if (magnitude > static_cast<std::uint64_t>(std::numeric_limits<Rep>::max())) {
+				throw parser_error{fmt::format("Value '{}' is out of range of the type", str)};
+			}
+			const auto count = static_cast<Rep>(magnitude);
+			return std::chrono::duration<Rep, Period>(value.negative ? static_cast<Rep>(-count) : count);
+		}
+	}
+};
+
+// Parses byte sizes such as '512', '64KiB' or '1.5GB'. Values without a unit are bytes, the supported units are 'B',
+// the decimal units 'kB' (or 'KB'), 'MB', 'GB', 'TB', 'PB' and 'EB', and the binary units 'KiB', 'MiB', 'GiB', 'TiB',
+// 'PiB' and 'EiB'. Sizes must be a whole number of bytes.
+template <>
+struct default_parser<byte_size> {
+	[[nodiscard]] byte_size operator()(const std::string_view str) const
+	{
+		const auto value = detail::parse_unit_value(str, detail::BYTE_SIZE_SUFFIXES, &detail::BYTE_SIZE_SUFFIXES[0]);
+		const auto bytes = detail::scale_unit_value(str, value, 1, 1);
+		if (value.negative && bytes != 0) {
+			throw parser_error{fmt::format("Byte size '{}' cannot be negative", str)};
+		}
+		return byte_size{bytes};
+	}
+};
+
+} // namespace env
+
+// Formats byte sizes in the largest binary unit they are a whole multiple of, e.g. '4GiB' or '1000B'.
+template <>
+struct fmt::formatter<env::byte_size> {
+	constexpr auto parse(format_parse_context& ctx) { return ctx.begin(); }
+
+	template <typename FormatContext>
+	auto format(const env::byte_size size, FormatContext& ctx) const
+	{
+		for (auto it = env::detail::BYTE_SIZE_SUFFIXES.rbegin(); it != env::detail::BYTE_SIZE_SUFFIXES.rend(); ++it) {
+			const auto is_binary_unit = it->suffix.find('i') != std::string_view::npos;
+			if (is_binary_unit && size.count() != 0 && size.count() % it->num == 0) {
+				return fmt::format_to(ctx.out(), "{}{}", size.count() / it->num, it->suffix);
+			}
+		}
+		return fmt::format_to(ctx.out(), "{}B", size.count());
+	}
+};
@@ -2,9 +2,16 @@
 
 #include <algorithm>
 #include <any>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <initializer_list>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <string>
@@ -15,12 +22,29 @@
 
 #include <fmt/core.h>
 
+#include <libenvpp/detail/arena.hpp>
+#include <libenvpp/detail/async.hpp>
+#include <libenvpp/detail/cache.hpp>
 #include <libenvpp/detail/edit_distance.hpp>
 #include <libenvpp/detail/environment.hpp>
 #include <libenvpp/detail/errors.hpp>
+#include <libenvpp/detail/executor.hpp>
 #include <libenvpp/detail/get.hpp>
+#include <libenvpp/detail/hash.hpp>
+#include <libenvpp/detail/instrumentation.hpp>
+#include <libenvpp/detail/list.hpp>
+#include <libenvpp/detail/map.hpp>
+#include <libenvpp/detail/name_table.hpp>
+#include <libenvpp/detail/network.hpp>
+#include <libenvpp/detail/option_set.hpp>
+#include <libenvpp/detail/parse_mode.hpp>
 #include <libenvpp/detail/parser.hpp>
+#include <libenvpp/detail/pattern.hpp>
+#include <libenvpp/detail/secret.hpp>
+#include <libenvpp/detail/source.hpp>
+#include <libenvpp/detail/string_ref.hpp>
 #include <libenvpp/detail/testing.hpp>
+#include <libenvpp/detail/units.hpp>
 
 namespace env {
 
@@ -33,6 +57,9 @@ namespace detail {
 class variable_data {
   public:
 	using parser_and_validator_fn = std::function<std::any(const std::string_view)>;
+	// Runs an asynchronous parser and validator to completion, throwing 'async_timeout' once the timeout elapsed.
+	using timed_parser_and_validator_fn =
+	    std::function<std::any(const std::string_view, const std::chrono::milliseconds)>;
 
 	variable_data() = delete;
 
@@ -43,21 +70,77 @@ class variable_data {
 	variable_data& operator=(variable_data&&) = default;
 
   private:
-	variable_data(const std::string_view name, bool is_required, parser_and_validator_fn parser_and_validator)
-	    : m_name(name), m_is_required(is_required), m_parser_and_validator(std::move(parser_and_validator))
+	variable_data(const std::string_view name, bool is_required, parser_and_validator_fn parser_and_validator,
+	              cache_codec codec, std::optional<std::size_t> secret_file_size_limit = std::nullopt)
+	    : m_name(name), m_is_required(is_required), m_parser_and_validator(std::move(parser_and_validator)),
+	      m_cache_codec(codec), m_secret_file_size_limit(secret_file_size_limit)
 	{
 	}
 
 	std::string m_name;
+	// Full name of the environment variable including the prefix, which is stored in the arena of the prefix. The
+	// name of the '_FILE' suffixed variable of a secret shares its storage.
+	std::string_view m_full_name;
+	std::string_view m_secret_file_name;
+	std::uint64_t m_full_name_hash = 0;
+	// Whether the value references the string it was parsed from, e.g. a 'std::string_view', which is then kept alive
+	// by the value snapshot of the parsed and validated prefix.
+	bool m_references_value = false;
 	bool m_is_required;
 	parser_and_validator_fn m_parser_and_validator;
+	cache_codec m_cache_codec;
+	std::optional<std::size_t> m_secret_file_size_limit;
+	// Holds a 'std::shared_ptr<const async_parser_and_validator_fn>' for variables with an asynchronous parser and
+	// validator, which is type-erased so that the layout does not depend on the language standard.
+	std::any m_async_parser_and_validator;
+	// Used instead of 'm_parser_and_validator' for variables with an asynchronous parser and validator, when parsing
+	// without an event loop.
+	timed_parser_and_validator_fn m_timed_parser_and_validator;
+	std::optional<std::chrono::milliseconds> m_timeout;
 	std::any m_value;
+	std::optional<std::size_t> m_source;
 
 	friend prefix;
 	template <typename Prefix>
 	friend class ::env::parsed_and_validated_prefix;
 };
 
+// Strings referenced by values of variables, which are moved here from the environment or copied from other source
+// layers. A deque never relocates its elements, so the strings and views of them stay valid until the snapshot is
+// destroyed.
+struct value_snapshot {
+	std::deque<std::string> values;
+	std::vector<std::shared_ptr<const secret_buffer>> secrets;
+};
+
+// Parse of a variable which is deferred until all variables are resolved, e.g. to run it on an executor.
+struct deferred_parse {
+	std::size_t id;
+	std::size_t layer;
+	std::string_view var_value;
+	// Keeps the value alive if it was read from a secret file.
+	std::shared_ptr<const secret_buffer> secret;
+	std::optional<error_details> error;
+	std::exception_ptr exception;
+};
+
+using event_loop_fn = void (*)(parsed_and_validated_prefix<prefix>&, std::vector<deferred_parse>&,
+                               std::chrono::milliseconds);
+
+struct parse_options {
+	const config_cache* cache = nullptr;
+	// Parsers and validators are run on the executor if one is given, and on the calling thread otherwise.
+	executor* exec = nullptr;
+	// Statistics of capturing the environment of the process before constructing the environment source, if it was
+	// captured on behalf of the caller.
+	phase_stats environment_capture;
+	// Asynchronous parsers and validators are run concurrently on an event loop of the calling thread if set, and are
+	// otherwise run to completion one after another. It is set where coroutines are enabled instead of being called
+	// directly, so that parsing is the same code in translation units compiled with and without them.
+	event_loop_fn parse_on_event_loop = nullptr;
+	std::chrono::milliseconds async_timeout = default_async_timeout;
+};
+
 } // namespace detail
 
 template <typename T, bool IsRequired>
@@ -99,9 +182,12 @@ class parsed_and_validated_prefix {
 	parsed_and_validated_prefix& operator=(parsed_and_validated_prefix&& other) noexcept
 	{
 		m_prefix = std::move(other.m_prefix);
+		m_source_names = std::move(other.m_source_names);
+		m_snapshot = std::move(other.m_snapshot);
 		m_errors = std::move(other.m_errors);
 		m_warnings = std::move(other.m_warnings);
 		m_invalidated = std::move(other.m_invalidated);
+		LIBENVPP_INSTRUMENT(m_stats = std::move(other.m_stats));
 		other.m_invalidated = true;
 		return *this;
 	}
@@ -134,6 +220,20 @@ class parsed_and_validated_prefix {
 		return value.has_value() ? std::any_cast<T>(value) : static_cast<T>(std::forward<U>(default_value));
 	}
 
+	// Returns the name of the source layer the value of the variable was retrieved from, or nothing if the variable
+	// holds no value or was set for testing.
+	template <typename T, bool IsRequired>
+	[[nodiscard]] std::optional<std::string_view> get_source(const variable_id<T, IsRequired>& var_id) const
+	{
+		throw_if_invalid();
+
+		const auto& source = m_prefix.m_registered_vars[var_id.m_idx].m_source;
+		if (!source.has_value()) {
+			return std::nullopt;
+		}
+		return m_source_names[*source];
+	}
+
 	[[nodiscard]] bool ok() const
 	{
 		throw_if_invalid();
@@ -143,13 +243,57 @@ class parsed_and_validated_prefix {
 	[[nodiscard]] std::string error_message() const
 	{
 		throw_if_invalid();
-		return message_formatting_helper("Error", m_errors);
+		return detail::format_messages("Error", m_errors);
+	}
+
+	// Appends the error message to 'buffer', which is grown at most once.
+	void error_message(fmt::memory_buffer& buffer) const
+	{
+		throw_if_invalid();
+		detail::format_messages(buffer, "Error", m_errors);
+	}
+
+	template <typename OutputIt>
+	OutputIt error_message(OutputIt out) const
+	{
+		throw_if_invalid();
+		return detail::format_messages(std::move(out), "Error", m_errors);
+	}
+
+	// Writes the error message to the file descriptor 'fd', e.g. 'STDERR_FILENO'.
+	void write_error_message(const int fd) const
+	{
+		auto buffer = fmt::memory_buffer();
+		error_message(buffer);
+		detail::write_message(fd, std::string_view(buffer.data(), buffer.size()));
 	}
 
 	[[nodiscard]] std::string warning_message() const
 	{
 		throw_if_invalid();
-		return message_formatting_helper("Warning", m_warnings);
+		return detail::format_messages("Warning", m_warnings);
+	}
+
+	// Appends the warning message to 'buffer', which is grown at most once.
+	void warning_message(fmt::memory_buffer& buffer) const
+	{
+		throw_if_invalid();
+		detail::format_messages(buffer, "Warning", m_warnings);
+	}
+
+	template <typename OutputIt>
+	OutputIt warning_message(OutputIt out) const
+	{
+		throw_if_invalid();
+		return detail::format_messages(std::move(out), "Warning", m_warnings);
+	}
+
+	// Writes the warning message to the file descriptor 'fd', e.g. 'STDERR_FILENO'.
+	void write_warning_message(const int fd) const
+	{
+		auto buffer = fmt::memory_buffer();
+		warning_message(buffer);
+		detail::write_message(fd, std::string_view(buffer.data(), buffer.size()));
 	}
 
 	[[nodiscard]] const std::vector<error>& errors() const
@@ -170,6 +314,33 @@ class parsed_and_validated_prefix {
 		return m_prefix.help_message();
 	}
 
+	void help_message(fmt::memory_buffer& buffer) const
+	{
+		throw_if_invalid();
+		m_prefix.help_message(buffer);
+	}
+
+	template <typename OutputIt>
+	OutputIt help_message(OutputIt out) const
+	{
+		throw_if_invalid();
+		return m_prefix.help_message(std::move(out));
+	}
+
+	void write_help_message(const int fd) const
+	{
+		throw_if_invalid();
+		m_prefix.write_help_message(fd);
+	}
+
+#if LIBENVPP_INSTRUMENTATION_ENABLED
+	[[nodiscard]] const parse_stats& stats() const
+	{
+		throw_if_invalid();
+		return m_stats;
+	}
+#endif
+
   private:
 	void throw_if_invalid() const
 	{
@@ -178,88 +349,468 @@ class parsed_and_validated_prefix {
 		}
 	}
 
-	parsed_and_validated_prefix(Prefix&& pre, std::unordered_map<std::string, std::string> environment)
+	parsed_and_validated_prefix(Prefix&& pre, const source_chain& sources, const detail::parse_options& options = {})
 	    : m_prefix(std::move(pre))
 	{
-		// Merges the global testing environment into the environment considered for parsing and validating,
-		// giving precedence to variables set in the testing environment.
-		environment = detail::merge_environments(detail::g_testing_environment, environment);
+		LIBENVPP_MEASURE_BEGIN(total_measurement);
+		LIBENVPP_INSTRUMENT(m_stats.prefix_name = m_prefix.m_prefix_name);
+		LIBENVPP_INSTRUMENT(m_stats.variables.resize(m_prefix.m_registered_vars.size()));
+		LIBENVPP_INSTRUMENT(m_stats.environment = options.environment_capture);
+		LIBENVPP_INSTRUMENT(m_stats.total = options.environment_capture);
+
+		LIBENVPP_MEASURE_BEGIN(environment_measurement);
+		const auto environment_layer = std::find_if(sources.begin(), sources.end(), [](const source& layer) {
+			return dynamic_cast<const environment_source*>(&layer) != nullptr;
+		});
+		const auto no_environment = std::unordered_map<std::string, std::string>{};
+		// Reads through the testing environment before the environment considered for parsing and validating, giving
+		// precedence to variables set in the testing environment without merging them.
+		auto environment = detail::testing_environment_view(
+		    environment_layer != sources.end()
+		        ? static_cast<const environment_source&>(environment_layer->get()).environment()
+		        : no_environment);
+		LIBENVPP_MEASURE_END(environment_measurement, m_stats.environment);
+
+		for (const auto& layer : sources) {
+			m_source_names.emplace_back(layer.get().name());
+		}
 
+		LIBENVPP_MEASURE_BEGIN(cache_load_measurement);
+		const auto* const cache = options.cache;
+		auto cache_key = std::optional<std::uint64_t>{};
+		if (cache && environment_layer != sources.end()) {
+			cache_key = get_cache_key(environment);
+		}
+		const auto is_cache_hit =
+		    cache_key.has_value()
+		    && load_from_cache(*cache, *cache_key, static_cast<std::size_t>(environment_layer - sources.begin()));
+		LIBENVPP_MEASURE_END(cache_load_measurement, m_stats.cache);
+		if (is_cache_hit) {
+			LIBENVPP_INSTRUMENT(m_stats.cache_hit = true);
+			LIBENVPP_INSTRUMENT(finish_stats(total_measurement));
+			return;
+		}
+
+		const auto mode = m_prefix.m_parse_mode;
 		auto unparsed_env_vars = std::vector<std::size_t>{};
+		// Every required variable which is not set results in exactly one error, with or without typo detection.
+		auto unset_required_count = std::size_t{0};
+		// Values are parsed once all variables are resolved if an executor is given or parsing is asynchronous, which
+		// happens before the environment and the testing environment referenced by the values go out of scope.
+		const auto is_deferred = options.exec || options.parse_on_event_loop;
+		auto deferred_parses = std::vector<detail::deferred_parse>{};
+		const auto snapshot = [&]() -> detail::value_snapshot& {
+			if (!m_snapshot) {
+				m_snapshot = std::make_shared<detail::value_snapshot>();
+			}
+			return *m_snapshot;
+		};
+		const auto parse_or_defer = [&](const std::size_t id, const std::size_t layer, const std::string_view var_value,
+		                                std::shared_ptr<const detail::secret_buffer> secret = nullptr) {
+			if (is_deferred) {
+				deferred_parses.push_back({id, layer, var_value, std::move(secret), std::nullopt, nullptr});
+			} else {
+				parse_variable(id, layer, var_value, secret != nullptr);
+			}
+		};
 
 		for (std::size_t id = 0; id < m_prefix.m_registered_vars.size(); ++id) {
+			LIBENVPP_MEASURE_BEGIN(variable_measurement);
 			auto& var = m_prefix.m_registered_vars[id];
-			const auto var_name = m_prefix.get_full_env_var_name(id);
-			const auto var_value = detail::pop_from_environment(var_name, environment);
+			const auto var_name = var.m_full_name;
+			const auto var_value = environment.find(var_name);
+			const auto is_secret = var.m_secret_file_size_limit.has_value();
+			const auto secret_file_path = is_secret ? environment.find(var.m_secret_file_name) : std::nullopt;
 			if (var.m_value.has_value()) {
-				// Skip variables set for testing, but consume their environment value if available.
+				// Skip variables set for testing, whose environment value is not reported as unused either.
+				LIBENVPP_MEASURE_END(variable_measurement, m_stats.variables[id].parse);
 				continue;
 			}
-			if (!var_value.has_value()) {
-				unparsed_env_vars.push_back(id);
-			} else {
-				auto res =
-				    detail::parse_or_error<std::any>(var_name, *var_value, std::move(var.m_parser_and_validator));
-				if (res.has_value()) {
-					var.m_value = std::move(res).value();
+
+			const auto resolve_from_environment = [&](const std::size_t layer) {
+				if (var_value.has_value() && secret_file_path.has_value()) {
+					m_errors.push_back(detail::make_error(id, var.m_name, var_name,
+					                                      {error_kind::mutually_exclusive, {}},
+					                                      detail::SECRET_FILE_SUFFIX));
+				} else if (var_value.has_value()) {
+					parse_or_defer(id, layer,
+					               var.m_references_value ? std::string_view(snapshot().values.emplace_back(*var_value))
+					                                      : *var_value);
+				} else if (secret_file_path.has_value()) {
+					const auto secret = detail::read_secret_file(*secret_file_path, *var.m_secret_file_size_limit);
+					if (secret.has_value()) {
+						if (var.m_references_value) {
+							snapshot().secrets.push_back(*secret);
+						}
+						parse_or_defer(id, layer, (*secret)->view(), *secret);
+					} else {
+						m_errors.push_back(detail::make_error(id, var.m_name, var_name,
+						                                      {error_kind::secret_file, std::move(secret).error()}));
+					}
 				} else {
-					m_errors.emplace_back(id, var.m_name, std::move(res).error());
+					return false;
+				}
+				return true;
+			};
+
+			// Layers are checked in order of precedence, the first layer providing a value for the variable wins.
+			auto is_resolved = false;
+			for (std::size_t layer = 0; layer < sources.size() && !is_resolved; ++layer) {
+				if (sources.begin() + layer == environment_layer) {
+					is_resolved = resolve_from_environment(layer);
+				} else if (const auto value = sources[layer].get().find(var_name, var.m_name); value.has_value()) {
+					// Source layers are not guaranteed to outlive the parsed and validated prefix.
+					parse_or_defer(id, layer,
+					               var.m_references_value ? std::string_view(snapshot().values.emplace_back(*value))
+					                                      : *value);
+					is_resolved = true;
+				}
+			}
+			if (!is_resolved) {
+				unparsed_env_vars.push_back(id);
+				unset_required_count += var.m_is_required ? 1 : 0;
+			}
+			LIBENVPP_MEASURE_END(variable_measurement, m_stats.variables[id].parse);
+			if (m_errors.size() + unset_required_count >= mode.error_budget()) {
+				break;
+			}
+		}
+
+		if (!deferred_parses.empty() && options.exec) {
+			parse_on_executor(deferred_parses, *options.exec);
+		}
+		if (!deferred_parses.empty() && options.parse_on_event_loop) {
+			options.parse_on_event_loop(*this, deferred_parses, options.async_timeout);
+		}
+		if (mode.is_budgeted()) {
+			apply_error_budget(mode.error_budget(), unparsed_env_vars);
+		}
+
+		// Typo and unused variable detection only refine the result, which is not worth it once it is known to contain
+		// errors unless all of them are to be collected.
+		const auto skip_detection = mode.is_budgeted() && (!m_errors.empty() || unset_required_count > 0);
+		if (!skip_detection) {
+			// The variables of the prefix are neither typos of each other nor unused, whether they are set or not.
+			for (const auto& var : m_prefix.m_registered_vars) {
+				environment.consume(var.m_full_name);
+				if (var.m_secret_file_size_limit.has_value()) {
+					environment.consume(var.m_secret_file_name);
 				}
 			}
 		}
 
 		for (const auto id : unparsed_env_vars) {
+			LIBENVPP_MEASURE_BEGIN(typo_measurement);
 			auto& var = m_prefix.m_registered_vars[id];
-			const auto var_name = m_prefix.get_full_env_var_name(id);
+			const auto var_name = var.m_full_name;
+			if (skip_detection) {
+				if (var.m_is_required) {
+					m_errors.push_back(detail::make_error(id, var_name, var_name, {error_kind::unset, {}}));
+				}
+				LIBENVPP_MEASURE_END(typo_measurement, m_stats.variables[id].typo_detection);
+				continue;
+			}
 			const auto edit_distance_cutoff = m_prefix.m_edit_distance_cutoff.get_or_default(var_name.length());
-			auto similar_env_var_error =
-			    detail::get_similar_env_var_error(id, var_name, edit_distance_cutoff, environment);
+			auto similar_env_var_error = detail::get_similar_env_var_error(var_name, edit_distance_cutoff, environment);
 			if (similar_env_var_error.has_value()) {
+				auto err = detail::make_error(id, var_name, var_name, std::move(similar_env_var_error).value());
 				if (var.m_is_required) {
-					m_errors.push_back(std::move(similar_env_var_error).value());
+					m_errors.push_back(std::move(err));
 				} else {
-					m_warnings.push_back(std::move(similar_env_var_error).value());
+					m_warnings.push_back(std::move(err));
 				}
 			} else if (var.m_is_required) {
-				m_errors.push_back(detail::get_unset_env_var_error(id, var_name));
+				m_errors.push_back(detail::make_error(id, var_name, var_name, {error_kind::unset, {}}));
 			}
+			LIBENVPP_MEASURE_END(typo_measurement, m_stats.variables[id].typo_detection);
 		}
 
-		for (auto&& unused_var : find_unused_env_vars(environment)) {
-			m_warnings.emplace_back(-1, unused_var,
-			                        fmt::format("Prefix environment variable '{}' specified but unused", unused_var));
+		LIBENVPP_MEASURE_BEGIN(unused_measurement);
+		if (!skip_detection) {
+			for (const auto unused_var : find_unused_env_vars(environment)) {
+				m_warnings.push_back(detail::make_owned_error(-1, unused_var, {error_kind::unused, {}}));
+			}
 		}
+		LIBENVPP_MEASURE_END(unused_measurement, m_stats.unused_detection);
+
+		attach_snapshot();
+
+		// Only results without any errors or warnings are cached, so a cache hit never needs to reproduce them.
+		LIBENVPP_MEASURE_BEGIN(cache_store_measurement);
+		if (cache_key.has_value() && m_errors.empty() && m_warnings.empty()) {
+			store_to_cache(*cache, *cache_key);
+		}
+		LIBENVPP_MEASURE_END(cache_store_measurement, m_stats.cache);
+
+		LIBENVPP_INSTRUMENT(finish_stats(total_measurement));
 	}
 
-	[[nodiscard]] std::string message_formatting_helper(const std::string_view message_type,
-	                                                    const std::vector<error>& errors_or_warnings) const
+#if LIBENVPP_INSTRUMENTATION_ENABLED
+	void finish_stats(const detail::phase_measurement& total_measurement)
 	{
-		if (errors_or_warnings.empty()) {
-			return {};
+		for (std::size_t id = 0; id < m_stats.variables.size(); ++id) {
+			auto& var_stats = m_stats.variables[id];
+			var_stats.name = m_prefix.m_registered_vars[id].m_name;
+			m_stats.parse += var_stats.parse;
+			m_stats.typo_detection += var_stats.typo_detection;
 		}
-		auto msg = std::string();
-		for (std::size_t i = 0; i < errors_or_warnings.size(); ++i) {
-			msg += fmt::format("{:<7}: {}\n", message_type, errors_or_warnings[i].what());
+		m_stats.total += total_measurement.stop();
+		detail::notify_parse_observer(m_stats);
+	}
+#endif
+
+	// Identifies the schema of the prefix together with everything in the environment that can influence the result of
+	// parsing and validating it. Returns no key if the prefix contains variables that cannot be cached.
+	[[nodiscard]] std::optional<std::uint64_t>
+	get_cache_key(const detail::testing_environment_view& environment) const
+	{
+		auto key = detail::fnv1a(m_prefix.m_prefix_name);
+		for (const auto& var : m_prefix.m_registered_vars) {
+			if (!var.m_cache_codec.serialize || var.m_secret_file_size_limit.has_value() || var.m_value.has_value()) {
+				return std::nullopt;
+			}
+			key = detail::hash_combine(key, var.m_full_name_hash);
+			key = detail::hash_combine(key, var.m_cache_codec.schema_hash);
+			key = detail::hash_combine(key, var.m_is_required);
+			key = detail::hash_combine(key, m_prefix.m_edit_distance_cutoff.get_or_default(var.m_full_name.length()));
+			const auto var_value = environment.find(var.m_full_name);
+			key = detail::hash_combine(key, var_value.has_value());
+			if (var_value.has_value()) {
+				key = detail::hash_combine(key, detail::fnv1a(*var_value));
+			}
 		}
-		return msg;
+		// Typo and unused variable detection depend on the names of all variables in the environment, which are
+		// combined independently of their order.
+		auto env_names_key = std::uint64_t{0};
+		environment.for_each([&](const std::string_view name, const std::string_view) {
+			env_names_key += detail::mix(detail::fnv1a(name));
+		});
+		return detail::hash_combine(key, env_names_key);
 	}
 
-	[[nodiscard]] std::vector<std::string>
-	find_unused_env_vars(const std::unordered_map<std::string, std::string>& environment) const
+	[[nodiscard]] bool load_from_cache(const config_cache& cache, const std::uint64_t key, const std::size_t layer)
 	{
-		auto unused_env_vars = std::vector<std::string>{};
-		for (const auto& [var, _] : environment) {
+		const auto cache_file = detail::mapped_cache_file(cache.path());
+		const auto entries = cache_file.entries(key, m_prefix.m_registered_vars.size());
+		if (!entries.has_value()) {
+			return false;
+		}
+
+		auto values = std::vector<std::optional<std::any>>(entries->size());
+		for (std::size_t id = 0; id < entries->size(); ++id) {
+			if ((*entries)[id].has_value()) {
+				values[id] = m_prefix.m_registered_vars[id].m_cache_codec.deserialize(*(*entries)[id]);
+				if (!values[id].has_value()) {
+					return false;
+				}
+			}
+		}
+
+		for (std::size_t id = 0; id < values.size(); ++id) {
+			if (values[id].has_value()) {
+				auto& var = m_prefix.m_registered_vars[id];
+				var.m_value = std::move(values[id]).value();
+				var.m_source = layer;
+			}
+		}
+		return true;
+	}
+
+	void store_to_cache(const config_cache& cache, const std::uint64_t key) const
+	{
+		auto entries = std::vector<std::optional<std::string>>(m_prefix.m_registered_vars.size());
+		for (std::size_t id = 0; id < entries.size(); ++id) {
+			const auto& var = m_prefix.m_registered_vars[id];
+			if (var.m_value.has_value()) {
+				var.m_cache_codec.serialize(var.m_value, entries[id].emplace());
+			}
+		}
+		detail::store_cache_file(cache.path(), key, entries);
+	}
+
+	void parse_variable(const std::size_t id, const std::size_t layer, const std::string_view var_value,
+	                    const bool is_secret_file)
+	{
+		if (auto details = try_parse_variable(id, layer, var_value); details.has_value()) {
+			m_errors.push_back(make_variable_error(id, std::move(details).value(), is_secret_file));
+		}
+	}
+
+	[[nodiscard]] error make_variable_error(const std::size_t id, detail::error_details details,
+	                                        const bool is_secret_file) const
+	{
+		const auto& var = m_prefix.m_registered_vars[id];
+		return detail::make_error(id, var.m_name, var.m_full_name, std::move(details),
+		                          is_secret_file ? detail::SECRET_FILE_SUFFIX : std::string_view());
+	}
+
+	// Lets all 'string_ref' values share ownership of the snapshot they reference.
+	void attach_snapshot()
+	{
+		if (!m_snapshot) {
+			return;
+		}
+		for (auto& var : m_prefix.m_registered_vars) {
+			if (auto* const ref = std::any_cast<string_ref>(&var.m_value); ref && var.m_references_value) {
+				detail::share_ownership(*ref, m_snapshot);
+			}
+		}
+	}
+
+	// Only modifies the variable itself, so different variables can be parsed concurrently.
+	[[nodiscard]] std::optional<detail::error_details>
+	try_parse_variable(const std::size_t id, const std::size_t layer, const std::string_view var_value)
+	{
+		auto& var = m_prefix.m_registered_vars[id];
+		auto res = [&] {
+			if (var.m_timed_parser_and_validator) {
+				const auto timeout = var.m_timeout.value_or(default_async_timeout);
+				return detail::parse_or_error<std::any>(var_value, [&](const std::string_view value) {
+					return var.m_timed_parser_and_validator(value, timeout);
+				});
+			}
+			return detail::parse_or_error<std::any>(var_value, std::move(var.m_parser_and_validator));
+		}();
+		if (!res.has_value()) {
+			return std::move(res).error();
+		}
+		var.m_value = std::move(res).value();
+		var.m_source = layer;
+		return std::nullopt;
+	}
+
+	// Runs all parsers and validators on the executor and waits for them to finish. Errors are reported in
+	// registration order, like when parsing on the calling thread.
+	void parse_on_executor(std::vector<detail::deferred_parse>& parses, executor& exec)
+	{
+		auto mutex = std::mutex{};
+		auto finished = std::condition_variable{};
+		auto running = std::size_t{0};
+		const auto wait_until_finished = [&] {
+			auto lock = std::unique_lock(mutex);
+			finished.wait(lock, [&] { return running == 0; });
+		};
+
+		for (auto& parse : parses) {
+			{
+				const auto _ = std::lock_guard(mutex);
+				++running;
+			}
+			try {
+				exec.execute([&] {
+					try {
+						LIBENVPP_MEASURE_BEGIN(parse_measurement);
+						parse.error = try_parse_variable(parse.id, parse.layer, parse.var_value);
+						LIBENVPP_MEASURE_END(parse_measurement, m_stats.variables[parse.id].parse);
+					} catch (...) {
+						parse.exception = std::current_exception();
+					}
+					// Notifying while holding the lock, as the waiting thread destroys the condition variable once
+					// it observes that all parses are finished.
+					const auto _ = std::lock_guard(mutex);
+					--running;
+					finished.notify_all();
+				});
+			} catch (...) {
+				{
+					const auto _ = std::lock_guard(mutex);
+					--running;
+				}
+				// Tasks which were already submitted reference the parses, which must therefore outlive them.
+				wait_until_finished();
+				throw;
+			}
+		}
+		wait_until_finished();
+		report_deferred_errors(parses);
+	}
+
+	// Runs all asynchronous parsers and validators concurrently on an event loop of the calling thread, and all other
+	// ones directly. Asynchronous ones which did not finish within their timeout are cancelled and reported as errors.
+	// Only defined where coroutines are enabled.
+	void parse_on_event_loop(std::vector<detail::deferred_parse>& parses,
+	                         const std::chrono::milliseconds default_timeout);
+
+	// Errors are reported in registration order, like when parsing sequentially on the calling thread.
+	void report_deferred_errors(std::vector<detail::deferred_parse>& parses)
+	{
+		for (auto& parse : parses) {
+			if (parse.exception) {
+				std::rethrow_exception(parse.exception);
+			}
+			if (parse.error.has_value()) {
+				const auto is_secret_file = parse.secret != nullptr;
+				m_errors.push_back(make_variable_error(parse.id, std::move(parse.error).value(), is_secret_file));
+			}
+		}
+		// All errors so far were found while resolving or parsing the variables, at most one per variable.
+		std::stable_sort(m_errors.begin(), m_errors.end(),
+		                 [](const error& lhs, const error& rhs) { return lhs.get_id() < rhs.get_id(); });
+	}
+
+	// Parsing on an executor or an event loop only finds out about errors after all variables were resolved, and may
+	// therefore have parsed variables after the one at which the error budget was spent. Everything found after it is
+	// dropped, so that the result is the same as when parsing on the calling thread.
+	void apply_error_budget(const std::size_t error_budget, std::vector<std::size_t>& unparsed_env_vars)
+	{
+		auto has_error = std::vector<bool>(m_prefix.m_registered_vars.size(), false);
+		for (const auto& err : m_errors) {
+			has_error[err.get_id()] = true;
+		}
+		for (const auto id : unparsed_env_vars) {
+			has_error[id] = has_error[id] || m_prefix.m_registered_vars[id].m_is_required;
+		}
+
+		auto error_count = std::size_t{0};
+		auto last_id = std::size_t{0};
+		for (; last_id < has_error.size(); ++last_id) {
+			error_count += has_error[last_id] ? 1 : 0;
+			if (error_count == error_budget) {
+				break;
+			}
+		}
+		if (last_id == has_error.size()) {
+			return;
+		}
+
+		m_errors.erase(std::remove_if(m_errors.begin(), m_errors.end(),
+		                              [last_id](const error& err) { return err.get_id() > last_id; }),
+		               m_errors.end());
+		unparsed_env_vars.erase(std::remove_if(unparsed_env_vars.begin(), unparsed_env_vars.end(),
+		                                       [last_id](const std::size_t id) { return id > last_id; }),
+		                        unparsed_env_vars.end());
+		for (auto id = last_id + 1; id < m_prefix.m_registered_vars.size(); ++id) {
+			auto& var = m_prefix.m_registered_vars[id];
+			// Values set for testing have no source and are kept.
+			if (var.m_source.has_value()) {
+				var.m_value.reset();
+				var.m_source.reset();
+			}
+		}
+	}
+
+	[[nodiscard]] std::vector<std::string_view>
+	find_unused_env_vars(const detail::testing_environment_view& environment) const
+	{
+		auto unused_env_vars = std::vector<std::string_view>{};
+		environment.for_each([&](const std::string_view var, const std::string_view) {
 			if (var.find(m_prefix.m_prefix_name) == 0) {
 				unused_env_vars.push_back(var);
 			}
-		}
+		});
 		return unused_env_vars;
 	}
 
 	Prefix m_prefix;
+	std::vector<std::string> m_source_names;
+	// Only created if a value references the string it was parsed from.
+	std::shared_ptr<detail::value_snapshot> m_snapshot;
 	std::vector<error> m_errors;
 	std::vector<error> m_warnings;
 	bool m_invalidated = false;
+#if LIBENVPP_INSTRUMENTATION_ENABLED
+	parse_stats m_stats;
+#endif
 
 	friend prefix;
 };
@@ -284,7 +835,9 @@ class prefix {
 	{
 		m_prefix_name = std::move(other.m_prefix_name);
 		m_edit_distance_cutoff = std::move(other.m_edit_distance_cutoff);
+		m_parse_mode = std::move(other.m_parse_mode);
 		m_registered_vars = std::move(other.m_registered_vars);
+		m_names = std::move(other.m_names);
 		m_invalidated = std::move(other.m_invalidated);
 		other.m_invalidated = true;
 		return *this;
@@ -331,12 +884,58 @@ class prefix {
 		return registration_option_helper<T, true>(name, options);
 	}
 
+	template <typename E>
+	[[nodiscard]] auto register_enum(const std::string_view name,
+	                                 const std::initializer_list<std::pair<std::string_view, E>> names,
+	                                 const case_sensitivity sensitivity = case_sensitivity::sensitive)
+	{
+		return registration_enum_helper<E, false>(name, names, sensitivity);
+	}
+
+	template <typename E>
+	[[nodiscard]] auto register_required_enum(const std::string_view name,
+	                                          const std::initializer_list<std::pair<std::string_view, E>> names,
+	                                          const case_sensitivity sensitivity = case_sensitivity::sensitive)
+	{
+		return registration_enum_helper<E, true>(name, names, sensitivity);
+	}
+
+	template <typename T = std::string>
+	[[nodiscard]] auto register_pattern(const std::string_view name, const std::string_view pattern)
+	{
+		return registration_pattern_helper<T, false>(name, pattern);
+	}
+
+	template <typename T = std::string>
+	[[nodiscard]] auto register_required_pattern(const std::string_view name, const std::string_view pattern)
+	{
+		return registration_pattern_helper<T, true>(name, pattern);
+	}
+
+	template <typename T, typename ParserAndValidatorFn = decltype(default_parser_and_validator<T>{})>
+	[[nodiscard]] auto register_secret(const std::string_view name,
+	                                   ParserAndValidatorFn parser_and_validator = default_parser_and_validator<T>{},
+	                                   const std::size_t size_limit = default_secret_file_size_limit)
+	{
+		return registration_helper<T, false>(name, std::move(parser_and_validator), size_limit);
+	}
+
+	template <typename T, typename ParserAndValidatorFn = decltype(default_parser_and_validator<T>{})>
+	[[nodiscard]] auto
+	register_required_secret(const std::string_view name,
+	                         ParserAndValidatorFn parser_and_validator = default_parser_and_validator<T>{},
+	                         const std::size_t size_limit = default_secret_file_size_limit)
+	{
+		return registration_helper<T, true>(name, std::move(parser_and_validator), size_limit);
+	}
+
 	void register_deprecated(const std::string_view name, const std::string_view deprecation_message)
 	{
 		throw_if_invalid();
 		std::string dm{deprecation_message};
-		m_registered_vars.push_back(detail::variable_data{
-		    name, false, [dm](const std::string_view) -> std::any { throw validation_error(dm); }});
+		add_variable(detail::variable_data{name, false,
+		                                   [dm](const std::string_view) -> std::any { throw validation_error(dm); },
+		                                   detail::make_cache_codec<bool, void>(detail::fnv1a(dm))});
 	}
 
 	template <typename T, bool IsRequired, typename U = T>
@@ -346,36 +945,179 @@ class prefix {
 		m_registered_vars[var_id.m_idx].m_value = static_cast<T>(value);
 	}
 
+	// Used by all ways of parsing and validating the prefix, which is 'collect_all' unless set.
+	void set_parse_mode(const parse_mode mode)
+	{
+		throw_if_invalid();
+		m_parse_mode = mode;
+	}
+
+	template <typename T, bool IsRequired>
+	void set_timeout(const variable_id<T, IsRequired>& var_id, const std::chrono::milliseconds timeout)
+	{
+		throw_if_invalid();
+		m_registered_vars[var_id.m_idx].m_timeout = timeout;
+	}
+
+	[[nodiscard]] parsed_and_validated_prefix<prefix> parse_and_validate()
+	{
+		throw_if_invalid();
+		auto options = detail::parse_options{};
+		const auto environment_layer = capture_environment(options.environment_capture);
+		return {std::move(*this), source_chain{environment_layer}, options};
+	}
+
 	[[nodiscard]] parsed_and_validated_prefix<prefix>
-	parse_and_validate(std::unordered_map<std::string, std::string> environment = detail::get_environment())
+	parse_and_validate(std::unordered_map<std::string, std::string> environment)
 	{
 		throw_if_invalid();
-		return {std::move(*this), std::move(environment)};
+		const auto environment_layer = environment_source(std::move(environment));
+		return {std::move(*this), source_chain{environment_layer}};
 	}
 
-	[[nodiscard]] std::string help_message() const
+	[[nodiscard]] parsed_and_validated_prefix<prefix> parse_and_validate(const source_chain& sources)
+	{
+		throw_if_invalid();
+		return {std::move(*this), sources};
+	}
+
+	// Templated so that braced environments, e.g. 'parse_and_validate({{"NAME", "value"}})', are not ambiguous with
+	// constructing a cache from a path.
+	template <typename Cache, typename = std::enable_if_t<std::is_same_v<Cache, config_cache>>>
+	[[nodiscard]] parsed_and_validated_prefix<prefix> parse_and_validate(const Cache& cache)
 	{
 		throw_if_invalid();
+		auto options = detail::parse_options{};
+		options.cache = &cache;
+		const auto environment_layer = capture_environment(options.environment_capture);
+		return {std::move(*this), source_chain{environment_layer}, options};
+	}
 
-		if (m_registered_vars.empty()) {
-			return fmt::format("There are no supported environment variables for the prefix '{}'\n", m_prefix_name);
-		}
-		auto msg = fmt::format("Prefix '{}' supports the following {} environment variable(s):\n", m_prefix_name,
-		                       m_registered_vars.size());
-		for (std::size_t i = 0; i < m_registered_vars.size(); ++i) {
-			const auto& var = m_registered_vars[i];
-			const auto var_name = get_full_env_var_name(i);
-			msg += fmt::format("\t'{}' {}\n", var_name, var.m_is_required ? "required" : "optional");
-		}
+	template <typename Cache, typename = std::enable_if_t<std::is_same_v<Cache, config_cache>>>
+	[[nodiscard]] parsed_and_validated_prefix<prefix>
+	parse_and_validate(const Cache& cache, std::unordered_map<std::string, std::string> environment)
+	{
+		throw_if_invalid();
+		const auto environment_layer = environment_source(std::move(environment));
+		auto options = detail::parse_options{};
+		options.cache = &cache;
+		return {std::move(*this), source_chain{environment_layer}, options};
+	}
+
+	// Runs the parsers and validators of the variables on 'exec', which pays off for expensive validators. Errors and
+	// warnings are reported in the same order as without an executor.
+	[[nodiscard]] parsed_and_validated_prefix<prefix> parse_and_validate(executor& exec)
+	{
+		throw_if_invalid();
+		auto options = detail::parse_options{};
+		options.exec = &exec;
+		const auto environment_layer = capture_environment(options.environment_capture);
+		return {std::move(*this), source_chain{environment_layer}, options};
+	}
+
+	[[nodiscard]] parsed_and_validated_prefix<prefix>
+	parse_and_validate(executor& exec, std::unordered_map<std::string, std::string> environment)
+	{
+		throw_if_invalid();
+		const auto environment_layer = environment_source(std::move(environment));
+		auto options = detail::parse_options{};
+		options.exec = &exec;
+		return {std::move(*this), source_chain{environment_layer}, options};
+	}
+
+	[[nodiscard]] parsed_and_validated_prefix<prefix> parse_and_validate(executor& exec, const source_chain& sources)
+	{
+		throw_if_invalid();
+		auto options = detail::parse_options{};
+		options.exec = &exec;
+		return {std::move(*this), sources, options};
+	}
+
+	// Runs asynchronous parsers and validators, i.e. ones returning an 'env::task', concurrently on an event loop of
+	// the calling thread. Each of them fails once 'timeout', or the timeout set with 'set_timeout', elapsed. Only
+	// defined where coroutines are enabled.
+	[[nodiscard]] parsed_and_validated_prefix<prefix>
+	parse_and_validate_async(const std::chrono::milliseconds timeout = default_async_timeout);
+
+	[[nodiscard]] parsed_and_validated_prefix<prefix>
+	parse_and_validate_async(const std::chrono::milliseconds timeout,
+	                         std::unordered_map<std::string, std::string> environment);
+
+	[[nodiscard]] std::string help_message() const
+	{
+		throw_if_invalid();
+		auto msg = std::string();
+		detail::append_message(msg, [this](auto& fn) { visit_help_message(fn); });
 		return msg;
 	}
 
+	// Appends the help message to 'buffer', which is grown at most once.
+	void help_message(fmt::memory_buffer& buffer) const
+	{
+		throw_if_invalid();
+		detail::append_message(buffer, [this](auto& fn) { visit_help_message(fn); });
+	}
+
+	// Formats the help message directly to 'out', without building it in memory first.
+	template <typename OutputIt>
+	OutputIt help_message(OutputIt out) const
+	{
+		throw_if_invalid();
+		return detail::format_message(std::move(out), [this](auto& fn) { visit_help_message(fn); });
+	}
+
+	// Writes the help message to the file descriptor 'fd', e.g. 'STDERR_FILENO'.
+	void write_help_message(const int fd) const
+	{
+		throw_if_invalid();
+		detail::write_message(fd, [this](auto& fn) { visit_help_message(fn); });
+	}
+
   private:
 	prefix() = default;
 
-	[[nodiscard]] std::string get_full_env_var_name(const std::size_t var_id) const
+	// Captures the environment of the process, which is part of the environment phase of the instrumentation.
+	[[nodiscard]] static environment_source capture_environment([[maybe_unused]] phase_stats& stats)
 	{
-		return get_full_env_var_name(m_registered_vars[var_id].m_name);
+		LIBENVPP_MEASURE_BEGIN(capture_measurement);
+		auto environment = detail::get_environment();
+		LIBENVPP_MEASURE_END(capture_measurement, stats);
+		return environment_source(std::move(environment));
+	}
+
+	// Calls 'fn' with the format string and arguments of every line of the help message, see 'message.hpp'.
+	template <typename Fn>
+	void visit_help_message(Fn& fn) const
+	{
+		if (m_registered_vars.empty()) {
+			fn("There are no supported environment variables for the prefix '{}'\n", m_prefix_name);
+			return;
+		}
+		fn("Prefix '{}' supports the following {} environment variable(s):\n", m_prefix_name,
+		   m_registered_vars.size());
+		for (const auto& var : m_registered_vars) {
+			const auto requirement = std::string_view(var.m_is_required ? "required" : "optional");
+			if (var.m_secret_file_size_limit.has_value()) {
+				fn("\t'{}' {} (or '{}')\n", var.m_full_name, requirement, var.m_secret_file_name);
+			} else {
+				fn("\t'{}' {}\n", var.m_full_name, requirement);
+			}
+		}
+	}
+
+	// Stores the full names of the variable in the arena and registers it, returns the ID of the variable.
+	std::size_t add_variable(detail::variable_data var)
+	{
+		const auto is_secret = var.m_secret_file_size_limit.has_value();
+		var.m_secret_file_name =
+		    m_names.store({m_prefix_name, var.m_name, is_secret ? detail::SECRET_FILE_SUFFIX : std::string_view()});
+		var.m_full_name = var.m_secret_file_name.substr(0, m_prefix_name.size() + var.m_name.size());
+		var.m_full_name_hash = detail::fnv1a(var.m_full_name);
+		if (!is_secret) {
+			var.m_secret_file_name = {};
+		}
+		m_registered_vars.push_back(std::move(var));
+		return m_registered_vars.size() - 1;
 	}
 
 	[[nodiscard]] std::string get_full_env_var_name(const std::string_view name) const
@@ -392,21 +1134,40 @@ class prefix {
 	}
 
 	template <typename T, bool IsRequired, typename ParserAndValidatorFn>
-	[[nodiscard]] auto registration_helper(const std::string_view name, ParserAndValidatorFn&& parser_and_validator)
+	[[nodiscard]] auto registration_helper(const std::string_view name, ParserAndValidatorFn&& parser_and_validator,
+	                                       const std::optional<std::size_t> secret_file_size_limit = std::nullopt,
+	                                       const std::optional<std::uint64_t> schema_seed = std::nullopt)
 	{
 		throw_if_invalid();
 
-		const auto type_erased_parser_and_validator =
-		    [parser_and_validator](const std::string_view env_value) -> std::any {
-			static_assert(std::is_convertible_v<decltype(parser_and_validator(env_value)), T>,
-			              "Parser and validator function must return type convertible to T");
-			return parser_and_validator(env_value);
-		};
-		m_registered_vars.push_back(
-		    detail::variable_data{name, IsRequired, std::move(type_erased_parser_and_validator)});
-		return variable_id<T, IsRequired>{m_registered_vars.size() - 1};
+		using result_t = std::invoke_result_t<std::decay_t<ParserAndValidatorFn>&, const std::string_view>;
+		if constexpr (detail::is_task_v<result_t>) {
+			return async_registration_helper<T, IsRequired>(
+			    name, std::forward<ParserAndValidatorFn>(parser_and_validator), secret_file_size_limit);
+		} else {
+			const auto type_erased_parser_and_validator =
+			    [parser_and_validator](const std::string_view env_value) -> std::any {
+				static_assert(std::is_convertible_v<decltype(parser_and_validator(env_value)), T>,
+				              "Parser and validator function must return type convertible to T");
+				return parser_and_validator(env_value);
+			};
+			const auto codec = detail::make_cache_codec<T, std::decay_t<ParserAndValidatorFn>>(schema_seed);
+			auto var = detail::variable_data{name, IsRequired, std::move(type_erased_parser_and_validator), codec,
+			                                 secret_file_size_limit};
+			var.m_references_value = detail::is_string_reference_v<T>;
+			return variable_id<T, IsRequired>{add_variable(std::move(var))};
+		}
 	}
 
+	// Only defined where coroutines are enabled, as only then can a parser and validator return a task. It is declared
+	// regardless, so that 'registration_helper' is the same code in every language mode.
+	template <typename T, bool IsRequired, typename ParserAndValidatorFn>
+	[[nodiscard]] variable_id<T, IsRequired>
+	async_registration_helper(const std::string_view name, ParserAndValidatorFn&& parser_and_validator,
+	                          const std::optional<std::size_t> secret_file_size_limit);
+
+	[[nodiscard]] static detail::parse_options make_async_parse_options(const std::chrono::milliseconds timeout);
+
 	template <typename T, bool IsRequired>
 	[[nodiscard]] auto registration_range_helper(const std::string_view name, const T min, const T max)
 	{
@@ -423,7 +1184,8 @@ class prefix {
 			}
 			return value;
 		};
-		return registration_helper<T, IsRequired>(name, std::move(parser_and_validator));
+		const auto schema_seed = detail::hash_combine(detail::hash_cached_value(min), detail::hash_cached_value(max));
+		return registration_helper<T, IsRequired>(name, std::move(parser_and_validator), std::nullopt, schema_seed);
 	}
 
 	template <typename T, bool IsRequired>
@@ -437,24 +1199,215 @@ class prefix {
 		if (options_set.size() != options.size()) {
 			throw duplicate_option{fmt::format("Duplicate option specified for '{}'", get_full_env_var_name(name))};
 		}
-		const auto parser_and_validator = [options = std::move(options_set)](const std::string_view str) {
-			const auto value = default_parser<T>{}(str);
-			default_validator<T>{}(value);
-			if (std::all_of(options.begin(), options.end(), [&value](const auto& option) { return option != value; })) {
+		auto schema_seed = std::uint64_t{0};
+		for (const auto& option : options_set) {
+			schema_seed = detail::hash_combine(schema_seed, detail::hash_cached_value(option));
+		}
+		const auto valid_options =
+		    std::make_shared<const detail::option_set<T>>(std::vector<T>(options_set.begin(), options_set.end()));
+		const auto parser_and_validator = [valid_options](const std::string_view str) {
+			if constexpr (detail::is_raw_string_option_v<T>) {
+				if (!valid_options->contains(str)) {
+					throw option_error{fmt::format("Unrecognized option '{}'", str)};
+				}
+				const auto value = default_parser<T>{}(str);
+				default_validator<T>{}(value);
+				return value;
+			} else {
+				const auto value = default_parser<T>{}(str);
+				default_validator<T>{}(value);
+				if (!valid_options->contains(value)) {
+					throw option_error{fmt::format("Unrecognized option '{}'", str)};
+				}
+				return value;
+			}
+		};
+		return registration_helper<T, IsRequired>(name, std::move(parser_and_validator), std::nullopt, schema_seed);
+	}
+
+	template <typename E, bool IsRequired>
+	[[nodiscard]] auto registration_enum_helper(const std::string_view name,
+	                                            const std::initializer_list<std::pair<std::string_view, E>> names,
+	                                            const case_sensitivity sensitivity)
+	{
+		auto table_names = std::vector<std::string>();
+		auto values = std::vector<E>();
+		table_names.reserve(names.size());
+		values.reserve(names.size());
+		auto schema_seed = static_cast<std::uint64_t>(sensitivity);
+		for (const auto& [enum_name, value] : names) {
+			table_names.emplace_back(enum_name);
+			values.push_back(value);
+			schema_seed = detail::hash_combine(schema_seed, detail::fnv1a(enum_name));
+			schema_seed = detail::hash_combine(schema_seed, detail::hash_cached_value(value));
+		}
+
+		auto table = std::shared_ptr<const detail::enum_table<E>>();
+		try {
+			table = std::make_shared<const detail::enum_table<E>>(
+			    detail::enum_table<E>{detail::name_table(std::move(table_names), sensitivity), std::move(values)});
+		} catch (const empty_option&) {
+			throw empty_option{fmt::format("No names provided for '{}'", get_full_env_var_name(name))};
+		} catch (const duplicate_option& e) {
+			throw duplicate_option{fmt::format("{} specified for '{}'", e.what(), get_full_env_var_name(name))};
+		}
+
+		const auto parser_and_validator = [table = std::move(table),
+		                                   edit_distance_cutoff = m_edit_distance_cutoff](const std::string_view str) {
+			const auto index = table->names.find(str);
+			if (index == table->names.size()) {
+				const auto similar =
+				    table->names.find_similar(str, edit_distance_cutoff.get_or_default(str.length()));
+				if (similar.has_value()) {
+					throw option_error{fmt::format("Unrecognized option '{}', did you mean '{}'?", str, *similar)};
+				}
 				throw option_error{fmt::format("Unrecognized option '{}'", str)};
 			}
+			const auto value = table->values[index];
+			default_validator<E>{}(value);
+			return value;
+		};
+		return registration_helper<E, IsRequired>(name, std::move(parser_and_validator), std::nullopt, schema_seed);
+	}
+
+	template <typename T, bool IsRequired>
+	[[nodiscard]] auto registration_pattern_helper(const std::string_view name, const std::string_view pattern)
+	{
+		auto compiled_pattern = std::shared_ptr<const detail::compiled_pattern>();
+		try {
+			compiled_pattern = std::make_shared<const detail::compiled_pattern>(pattern);
+		} catch (const invalid_pattern& e) {
+			throw invalid_pattern{fmt::format("{} for '{}'", e.what(), get_full_env_var_name(name))};
+		}
+
+		// The value is matched before it is parsed, so that the pattern applies to the value as it was given.
+		const auto parser_and_validator = [compiled_pattern](const std::string_view str) {
+			const auto mismatch = compiled_pattern->find_mismatch(str);
+			if (mismatch != detail::compiled_pattern::NO_MISMATCH) {
+				throw validation_error{fmt::format("Value '{}' does not match pattern '{}' at offset {}", str,
+				                                   compiled_pattern->pattern(), mismatch)};
+			}
+			const auto value = default_parser<T>{}(str);
+			default_validator<T>{}(value);
 			return value;
 		};
-		return registration_helper<T, IsRequired>(name, std::move(parser_and_validator));
+		return registration_helper<T, IsRequired>(name, std::move(parser_and_validator), std::nullopt,
+		                                          detail::fnv1a(pattern));
 	}
 
 	std::string m_prefix_name;
 	edit_distance m_edit_distance_cutoff;
+	parse_mode m_parse_mode;
 	std::vector<detail::variable_data> m_registered_vars;
+	// Holds the full names of all registered variables.
+	detail::string_arena m_names;
 	bool m_invalidated = false;
 
 	template <typename Prefix>
 	friend class parsed_and_validated_prefix;
 };
 
+#if LIBENVPP_COROUTINES_ENABLED
+template <typename Prefix>
+void parsed_and_validated_prefix<Prefix>::parse_on_event_loop(std::vector<detail::deferred_parse>& parses,
+                                                            const std::chrono::milliseconds default_timeout)
+{
+	using async_fn_ptr = std::shared_ptr<const detail::async_parser_and_validator_fn>;
+	const auto start = detail::event_loop::clock::now();
+	auto tasks = std::vector<detail::timed_task>{};
+	auto task_parses = std::vector<detail::deferred_parse*>{};
+	for (auto& parse : parses) {
+		const auto& var = m_prefix.m_registered_vars[parse.id];
+		const auto* const async_fn = std::any_cast<async_fn_ptr>(&var.m_async_parser_and_validator);
+		if (!async_fn) {
+			LIBENVPP_MEASURE_BEGIN(parse_measurement);
+			parse.error = try_parse_variable(parse.id, parse.layer, parse.var_value);
+			LIBENVPP_MEASURE_END(parse_measurement, m_stats.variables[parse.id].parse);
+			continue;
+		}
+		// Tasks start suspended, so creating them does not run the parser and validator yet.
+		tasks.push_back({(**async_fn)(parse.var_value), start + var.m_timeout.value_or(default_timeout)});
+		task_parses.push_back(&parse);
+	}
+
+	detail::run_timed_tasks(tasks);
+
+	for (std::size_t i = 0; i < tasks.size(); ++i) {
+		auto& parse = *task_parses[i];
+		auto& var = m_prefix.m_registered_vars[parse.id];
+		if (tasks[i].m_timed_out) {
+			const auto timeout = var.m_timeout.value_or(default_timeout);
+			parse.error = detail::error_details{error_kind::timeout, std::to_string(timeout.count())};
+			continue;
+		}
+		auto res = detail::parse_or_error<std::any>(parse.var_value, [&](const std::string_view) {
+			return detail::task_access::result(tasks[i].m_task);
+		});
+		if (res.has_value()) {
+			var.m_value = std::move(res).value();
+			var.m_source = parse.layer;
+		} else {
+			parse.error = std::move(res).error();
+		}
+	}
+	report_deferred_errors(parses);
+}
+
+inline parsed_and_validated_prefix<prefix> prefix::parse_and_validate_async(const std::chrono::milliseconds timeout)
+{
+	throw_if_invalid();
+	auto options = make_async_parse_options(timeout);
+	const auto environment_layer = capture_environment(options.environment_capture);
+	return {std::move(*this), source_chain{environment_layer}, options};
+}
+
+inline parsed_and_validated_prefix<prefix>
+prefix::parse_and_validate_async(const std::chrono::milliseconds timeout,
+                                 std::unordered_map<std::string, std::string> environment)
+{
+	throw_if_invalid();
+	auto options = make_async_parse_options(timeout);
+	const auto environment_layer = environment_source(std::move(environment));
+	return {std::move(*this), source_chain{environment_layer}, options};
+}
+
+inline detail::parse_options prefix::make_async_parse_options(const std::chrono::milliseconds timeout)
+{
+	auto options = detail::parse_options{};
+	options.parse_on_event_loop = [](parsed_and_validated_prefix<prefix>& parsed,
+	                                 std::vector<detail::deferred_parse>& parses,
+	                                 const std::chrono::milliseconds default_timeout) {
+		parsed.parse_on_event_loop(parses, default_timeout);
+	};
+	options.async_timeout = timeout;
+	return options;
+}
+
+template <typename T, bool IsRequired, typename ParserAndValidatorFn>
+variable_id<T, IsRequired> prefix::async_registration_helper(const std::string_view name,
+                                                             ParserAndValidatorFn&& parser_and_validator,
+                                                             const std::optional<std::size_t> secret_file_size_limit)
+{
+	using result_t = std::invoke_result_t<std::decay_t<ParserAndValidatorFn>&, const std::string_view>;
+	static_assert(std::is_convertible_v<typename detail::is_task<result_t>::value_type, T>,
+	              "Parser and validator function must return a task of type convertible to T");
+
+	const auto async_parser_and_validator = std::make_shared<const detail::async_parser_and_validator_fn>(
+	    [parser_and_validator](const std::string_view env_value) {
+		    return detail::erase_task_type<T>(parser_and_validator(env_value));
+	    });
+	// Asynchronous validation usually depends on external state, so the result is never cached.
+	auto var = detail::variable_data{name, IsRequired, nullptr, detail::cache_codec{0}, secret_file_size_limit};
+	var.m_async_parser_and_validator = async_parser_and_validator;
+	// Parsing and validating without an event loop, e.g. with 'parse_and_validate', runs the task to completion on the
+	// calling thread, within the timeout of the variable.
+	var.m_timed_parser_and_validator = [async_parser_and_validator](const std::string_view env_value,
+	                                                                const std::chrono::milliseconds timeout) {
+		return detail::run_task((*async_parser_and_validator)(env_value), timeout);
+	};
+	var.m_references_value = detail::is_string_reference_v<T>;
+	return variable_id<T, IsRequired>{add_variable(std::move(var))};
+}
+#endif
+
 } // namespace env
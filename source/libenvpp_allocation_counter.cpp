@@ -0,0 +1,182 @@
+#if LIBENVPP_INSTRUMENTATION_ENABLED
+
+// Replacements of all forms of the global allocation functions, which count the allocations of each thread and install
+// the count as the allocation counter of the instrumentation. Only part of the 'libenvpp::allocation_counter' target,
+// which programs link on purpose, as the global allocation functions can be replaced only once per program.
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <libenvpp/detail/instrumentation.hpp>
+
+namespace {
+
+constexpr auto DEFAULT_ALIGNMENT = std::size_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__};
+
+thread_local std::size_t t_allocation_count = 0;
+
+[[nodiscard]] std::size_t count_allocations() noexcept
+{
+	return t_allocation_count;
+}
+
+[[maybe_unused]] const auto g_previous_allocation_counter = env::set_allocation_counter(count_allocations);
+
+[[nodiscard]] bool is_over_aligned(const std::size_t alignment) noexcept
+{
+	return alignment > DEFAULT_ALIGNMENT;
+}
+
+[[nodiscard]] void* try_allocate(std::size_t size, const std::size_t alignment) noexcept
+{
+	size = size == 0 ? 1 : size;
+	if (!is_over_aligned(alignment)) {
+		return std::malloc(size);
+	}
+#if LIBENVPP_PLATFORM_WINDOWS
+	return _aligned_malloc(size, alignment);
+#else
+	// 'std::aligned_alloc' requires the size to be a multiple of the alignment.
+	return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+[[nodiscard]] void* allocate(const std::size_t size, const std::size_t alignment)
+{
+	++t_allocation_count;
+	while (true) {
+		if (auto* const ptr = try_allocate(size, alignment)) {
+			return ptr;
+		}
+		const auto handler = std::get_new_handler();
+		if (!handler) {
+			throw std::bad_alloc{};
+		}
+		handler();
+	}
+}
+
+[[nodiscard]] void* allocate(const std::size_t size, const std::size_t alignment, const std::nothrow_t&) noexcept
+{
+	try {
+		return allocate(size, alignment);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void deallocate(void* const ptr, [[maybe_unused]] const std::size_t alignment) noexcept
+{
+#if LIBENVPP_PLATFORM_WINDOWS
+	if (is_over_aligned(alignment)) {
+		_aligned_free(ptr);
+		return;
+	}
+#endif
+	std::free(ptr);
+}
+
+} // namespace
+
+void* operator new(const std::size_t size)
+{
+	return allocate(size, DEFAULT_ALIGNMENT);
+}
+
+void* operator new[](const std::size_t size)
+{
+	return allocate(size, DEFAULT_ALIGNMENT);
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t& tag) noexcept
+{
+	return allocate(size, DEFAULT_ALIGNMENT, tag);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t& tag) noexcept
+{
+	return allocate(size, DEFAULT_ALIGNMENT, tag);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+	return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+	return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t& tag) noexcept
+{
+	return allocate(size, static_cast<std::size_t>(alignment), tag);
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t& tag) noexcept
+{
+	return allocate(size, static_cast<std::size_t>(alignment), tag);
+}
+
+void operator delete(void* const ptr) noexcept
+{
+	deallocate(ptr, DEFAULT_ALIGNMENT);
+}
+
+void operator delete[](void* const ptr) noexcept
+{
+	deallocate(ptr, DEFAULT_ALIGNMENT);
+}
+
+void operator delete(void* const ptr, const std::size_t) noexcept
+{
+	deallocate(ptr, DEFAULT_ALIGNMENT);
+}
+
+void operator delete[](void* const ptr, const std::size_t) noexcept
+{
+	deallocate(ptr, DEFAULT_ALIGNMENT);
+}
+
+void operator delete(void* const ptr, const std::nothrow_t&) noexcept
+{
+	deallocate(ptr, DEFAULT_ALIGNMENT);
+}
+
+void operator delete[](void* const ptr, const std::nothrow_t&) noexcept
+{
+	deallocate(ptr, DEFAULT_ALIGNMENT);
+}
+
+void operator delete(void* const ptr, const std::align_val_t alignment) noexcept
+{
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* const ptr, const std::align_val_t alignment) noexcept
+{
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* const ptr, const std::size_t, const std::align_val_t alignment) noexcept
+{
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* const ptr, const std::size_t, const std::align_val_t alignment) noexcept
+{
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* const ptr, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* const ptr, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+#endif
@@ -0,0 +1,202 @@
+#include <libenvpp/detail/cache.hpp>
+
+#include <cerrno>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <system_error>
+
+#include <fmt/core.h>
+
+#if LIBENVPP_PLATFORM_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace env::detail {
+
+namespace {
+
+constexpr auto CACHE_MAGIC = std::string_view{"LIBENVPP"};
+constexpr auto CACHE_VERSION = std::uint32_t{2};
+
+template <typename T>
+void append_raw(std::string& out, const T value)
+{
+	out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+[[nodiscard]] std::optional<T> read_raw(std::string_view& data)
+{
+	if (data.size() < sizeof(T)) {
+		return std::nullopt;
+	}
+	auto value = T{};
+	std::memcpy(&value, data.data(), sizeof(T));
+	data.remove_prefix(sizeof(T));
+	return value;
+}
+
+#if LIBENVPP_PLATFORM_UNIX
+// Only files owned by the current user which nobody else can write to are trusted, as their values are used without
+// running any parser or registered validator.
+[[nodiscard]] bool is_trusted_cache_file(const struct stat& st)
+{
+	return S_ISREG(st.st_mode) && st.st_uid == ::geteuid() && (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+// Creates the file, which must not exist yet, and removes it again if it cannot be written completely.
+[[nodiscard]] bool write_new_file(const std::filesystem::path& path, const std::string_view content)
+{
+	const auto fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+	if (fd < 0) {
+		return false;
+	}
+	auto remaining = content;
+	while (!remaining.empty()) {
+		const auto written = ::write(fd, remaining.data(), remaining.size());
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (written <= 0) {
+			break;
+		}
+		remaining.remove_prefix(static_cast<std::size_t>(written));
+	}
+	if (::close(fd) != 0 || !remaining.empty()) {
+		::unlink(path.c_str());
+		return false;
+	}
+	return true;
+}
+#else
+[[nodiscard]] bool write_new_file(const std::filesystem::path& path, const std::string_view content)
+{
+	auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+	file.write(content.data(), static_cast<std::streamsize>(content.size()));
+	file.close();
+	if (!file) {
+		auto ec = std::error_code{};
+		std::filesystem::remove(path, ec);
+		return false;
+	}
+	return true;
+}
+#endif
+
+} // namespace
+
+mapped_cache_file::mapped_cache_file(const std::filesystem::path& path)
+{
+#if LIBENVPP_PLATFORM_UNIX
+	const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return;
+	}
+	struct stat st {};
+	if (::fstat(fd, &st) == 0 && is_trusted_cache_file(st) && st.st_size > 0) {
+		const auto size = static_cast<std::size_t>(st.st_size);
+		const auto mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED) {
+			m_mapping = mapping;
+			m_data = std::string_view(static_cast<const char*>(mapping), size);
+		}
+	}
+	::close(fd);
+#else
+	auto file = std::ifstream(path, std::ios::binary);
+	if (file) {
+		m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		m_data = m_buffer;
+	}
+#endif
+}
+
+mapped_cache_file::~mapped_cache_file()
+{
+#if LIBENVPP_PLATFORM_UNIX
+	if (m_mapping) {
+		::munmap(m_mapping, m_data.size());
+	}
+#endif
+}
+
+[[nodiscard]] std::optional<std::vector<std::optional<std::string_view>>>
+mapped_cache_file::entries(const std::uint64_t key, const std::size_t count) const
+{
+	auto data = m_data;
+	if (data.substr(0, CACHE_MAGIC.size()) != CACHE_MAGIC) {
+		return std::nullopt;
+	}
+	data.remove_prefix(CACHE_MAGIC.size());
+
+	const auto version = read_raw<std::uint32_t>(data);
+	const auto stored_key = read_raw<std::uint64_t>(data);
+	const auto stored_count = read_raw<std::uint64_t>(data);
+	const auto stored_checksum = read_raw<std::uint64_t>(data);
+	if (version != CACHE_VERSION || stored_key != key || stored_count != count || stored_checksum != fnv1a(data)) {
+		return std::nullopt;
+	}
+
+	auto entries = std::vector<std::optional<std::string_view>>{};
+	entries.reserve(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		const auto has_value = read_raw<std::uint8_t>(data);
+		if (!has_value.has_value()) {
+			return std::nullopt;
+		}
+		if (*has_value == 0) {
+			entries.emplace_back(std::nullopt);
+			continue;
+		}
+		const auto size = read_raw<std::uint64_t>(data);
+		if (!size.has_value() || *size > data.size()) {
+			return std::nullopt;
+		}
+		entries.emplace_back(data.substr(0, static_cast<std::size_t>(*size)));
+		data.remove_prefix(static_cast<std::size_t>(*size));
+	}
+	if (!data.empty()) {
+		return std::nullopt;
+	}
+	return entries;
+}
+
+void store_cache_file(const std::filesystem::path& path, const std::uint64_t key,
+                      const std::vector<std::optional<std::string>>& entries) noexcept
+{
+	try {
+		auto payload = std::string();
+		for (const auto& entry : entries) {
+			append_raw(payload, static_cast<std::uint8_t>(entry.has_value()));
+			if (entry.has_value()) {
+				append_raw(payload, static_cast<std::uint64_t>(entry->size()));
+				payload.append(*entry);
+			}
+		}
+
+		auto content = std::string(CACHE_MAGIC);
+		append_raw(content, CACHE_VERSION);
+		append_raw(content, key);
+		append_raw(content, static_cast<std::uint64_t>(entries.size()));
+		append_raw(content, fnv1a(payload));
+		content.append(payload);
+
+		auto temporary_path = path;
+		temporary_path += fmt::format(".{}.tmp", std::random_device{}());
+		if (!write_new_file(temporary_path, content)) {
+			return;
+		}
+		auto ec = std::error_code{};
+		std::filesystem::rename(temporary_path, path, ec);
+		if (ec) {
+			std::filesystem::remove(temporary_path, ec);
+		}
+	} catch (...) {
+	}
+}
+
+} // namespace env::detail
@@ -1,28 +1,52 @@
 #include <libenvpp/detail/errors.hpp>
 
-#include <fmt/core.h>
+namespace env {
 
-#include <libenvpp/detail/environment.hpp>
+namespace detail {
 
-namespace env::detail {
+namespace {
 
-[[nodiscard]] std::optional<error> get_similar_env_var_error(const std::size_t id, const std::string_view env_var_name,
-                                                             const int edit_dist_cutoff,
-                                                             std::unordered_map<std::string, std::string>& environment)
+template <typename Buffer>
+void append_messages(Buffer& buffer, const std::string_view message_type, const std::vector<error>& errors_or_warnings)
 {
-	const auto similar_var = find_similar_env_var(env_var_name, environment, edit_dist_cutoff);
+	append_message(buffer, [&](auto& fn) { visit_messages(fn, message_type, errors_or_warnings); });
+}
+
+} // namespace
+
+[[nodiscard]] std::optional<error_details> get_similar_env_var_error(const std::string_view env_var_name,
+                                                                     const int edit_dist_cutoff,
+                                                                     testing_environment_view& environment)
+{
+	const auto similar_var = environment.find_similar(env_var_name, edit_dist_cutoff);
 	if (similar_var.has_value()) {
-		const auto msg =
-		    fmt::format("Unrecognized environment variable '{}' set, did you mean '{}'?", *similar_var, env_var_name);
-		pop_from_environment(*similar_var, environment);
-		return {error(id, env_var_name, msg)};
+		environment.consume(*similar_var);
+		return error_details{error_kind::misspelled, std::string(*similar_var)};
 	}
 	return std::nullopt;
 }
 
-[[nodiscard]] error get_unset_env_var_error(const std::size_t id, const std::string_view env_var_name)
+[[nodiscard]] std::string format_messages(const std::string_view message_type,
+                                          const std::vector<error>& errors_or_warnings)
+{
+	auto msg = std::string();
+	append_messages(msg, message_type, errors_or_warnings);
+	return msg;
+}
+
+void format_messages(fmt::memory_buffer& buffer, const std::string_view message_type,
+                     const std::vector<error>& errors_or_warnings)
+{
+	append_messages(buffer, message_type, errors_or_warnings);
+}
+
+} // namespace detail
+
+[[nodiscard]] std::string error::what() const
 {
-	return error(id, env_var_name, fmt::format("Environment variable '{}' not set", env_var_name));
+	auto msg = std::string();
+	detail::append_message(msg, [this](auto& fn) { detail::error_access::visit_message(*this, fn); });
+	return msg;
 }
 
-} // namespace env::detail
+} // namespace env
@@ -0,0 +1,56 @@
+#include <libenvpp/detail/executor.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace env {
+
+thread_pool::thread_pool(const std::size_t thread_count)
+{
+	// 'std::thread::hardware_concurrency' may be zero if it is not computable.
+	const auto actual_thread_count = std::max(thread_count, std::size_t{1});
+	m_threads.reserve(actual_thread_count);
+	for (std::size_t i = 0; i < actual_thread_count; ++i) {
+		m_threads.emplace_back([this] { run(); });
+	}
+}
+
+thread_pool::~thread_pool()
+{
+	{
+		const auto _ = std::lock_guard(m_mutex);
+		m_stopping = true;
+	}
+	m_task_available.notify_all();
+	for (auto& thread : m_threads) {
+		thread.join();
+	}
+}
+
+void thread_pool::execute(std::function<void()> task)
+{
+	{
+		const auto _ = std::lock_guard(m_mutex);
+		m_tasks.push_back(std::move(task));
+	}
+	m_task_available.notify_one();
+}
+
+void thread_pool::run()
+{
+	while (true) {
+		auto task = std::function<void()>{};
+		{
+			auto lock = std::unique_lock(m_mutex);
+			m_task_available.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+			if (m_tasks.empty()) {
+				return;
+			}
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+		task();
+	}
+}
+
+} // namespace env
@@ -0,0 +1,58 @@
+#if LIBENVPP_INSTRUMENTATION_ENABLED
+
+#include <libenvpp/detail/instrumentation.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace env {
+
+namespace detail {
+
+namespace {
+
+std::atomic<allocation_counter> g_allocation_counter = nullptr;
+
+std::mutex g_parse_observer_mutex;
+std::shared_ptr<const parse_observer> g_parse_observer;
+
+} // namespace
+
+std::size_t allocation_count() noexcept
+{
+	const auto counter = g_allocation_counter.load(std::memory_order_relaxed);
+	return counter ? counter() : 0;
+}
+
+void notify_parse_observer(const parse_stats& stats)
+{
+	auto observer = std::shared_ptr<const parse_observer>{};
+	{
+		const auto _ = std::lock_guard(g_parse_observer_mutex);
+		observer = g_parse_observer;
+	}
+	// The observer is called without holding the lock, so it may install another observer.
+	if (observer) {
+		(*observer)(stats);
+	}
+}
+
+} // namespace detail
+
+void set_parse_observer(parse_observer observer)
+{
+	auto new_observer = observer ? std::make_shared<const parse_observer>(std::move(observer)) : nullptr;
+	const auto _ = std::lock_guard(detail::g_parse_observer_mutex);
+	detail::g_parse_observer = std::move(new_observer);
+}
+
+allocation_counter set_allocation_counter(const allocation_counter counter) noexcept
+{
+	return detail::g_allocation_counter.exchange(counter);
+}
+
+} // namespace env
+
+#endif
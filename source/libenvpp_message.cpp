@@ -0,0 +1,41 @@
+#include <libenvpp/detail/message.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fmt/core.h>
+
+#include <libenvpp/detail/errors.hpp>
+
+#if LIBENVPP_PLATFORM_UNIX
+#include <unistd.h>
+#elif LIBENVPP_PLATFORM_WINDOWS
+#include <io.h>
+#endif
+
+namespace env {
+
+namespace detail {
+
+void write_message(const int fd, std::string_view message)
+{
+	while (!message.empty()) {
+#if LIBENVPP_PLATFORM_UNIX
+		const auto written = ::write(fd, message.data(), message.size());
+#elif LIBENVPP_PLATFORM_WINDOWS
+		const auto written = ::_write(fd, message.data(), static_cast<unsigned int>(message.size()));
+#endif
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (written <= 0) {
+			throw write_error{
+			    fmt::format("Failed to write message to file descriptor {}: {}", fd, std::strerror(errno))};
+		}
+		message.remove_prefix(static_cast<std::size_t>(written));
+	}
+}
+
+} // namespace detail
+
+} // namespace env
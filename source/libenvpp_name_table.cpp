@@ -0,0 +1,86 @@
+#include <libenvpp/detail/name_table.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include <fmt/core.h>
+
+#include <libenvpp/detail/errors.hpp>
+#include <libenvpp/detail/levenshtein.hpp>
+#include <libenvpp/detail/perfect_hash.hpp>
+
+namespace env::detail {
+
+namespace {
+
+[[nodiscard]] std::string fold_case(const std::string_view name)
+{
+	auto folded = std::string(name);
+	std::transform(folded.begin(), folded.end(), folded.begin(),
+	               [](const char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; });
+	return folded;
+}
+
+} // namespace
+
+name_table::name_table(std::vector<std::string> names, const case_sensitivity sensitivity)
+    : m_names(std::move(names)), m_sensitivity(sensitivity)
+{
+	if (m_names.empty()) {
+		throw empty_option{"No names provided"};
+	}
+	if (m_sensitivity == case_sensitivity::insensitive) {
+		m_folded_names.reserve(m_names.size());
+		std::transform(m_names.begin(), m_names.end(), std::back_inserter(m_folded_names), fold_case);
+	}
+	const auto& keys = m_sensitivity == case_sensitivity::insensitive ? m_folded_names : m_names;
+	m_keys.assign(keys.begin(), keys.end());
+
+	auto sorted_keys = m_keys;
+	std::sort(sorted_keys.begin(), sorted_keys.end());
+	const auto duplicate = std::adjacent_find(sorted_keys.begin(), sorted_keys.end());
+	if (duplicate != sorted_keys.end()) {
+		throw duplicate_option{fmt::format("Duplicate name '{}'", *duplicate)};
+	}
+
+	m_displacements.resize(perfect_hash_bucket_count(m_keys.size()));
+	m_slots.resize(perfect_hash_table_size(m_keys.size()));
+	auto scratch = std::vector<std::size_t>(perfect_hash_scratch_size(m_keys.size()));
+	build_perfect_hash(m_keys.data(), m_keys.size(), m_displacements.data(), m_slots.data(), scratch.data());
+}
+
+std::size_t name_table::find(const std::string_view name) const
+{
+	if (m_sensitivity == case_sensitivity::insensitive) {
+		// Names are usually short enough for the folded copy to be stored inline in the string.
+		const auto folded = fold_case(name);
+		return perfect_hash_find(folded, m_keys.data(), m_keys.size(), m_displacements.data(), m_displacements.size(),
+		                         m_slots.data(), m_slots.size());
+	}
+	return perfect_hash_find(name, m_keys.data(), m_keys.size(), m_displacements.data(), m_displacements.size(),
+	                         m_slots.data(), m_slots.size());
+}
+
+std::optional<std::string_view> name_table::find_similar(const std::string_view name,
+                                                         const int edit_distance_cutoff) const
+{
+	const auto folded = m_sensitivity == case_sensitivity::insensitive ? fold_case(name) : std::string();
+	const auto key = m_sensitivity == case_sensitivity::insensitive ? std::string_view(folded) : name;
+
+	auto best = std::optional<std::size_t>();
+	auto best_distance = edit_distance_cutoff + 1;
+	for (std::size_t i = 0; i < m_keys.size(); ++i) {
+		const auto distance = levenshtein::distance(key, m_keys[i], best_distance);
+		if (distance < best_distance) {
+			best = i;
+			best_distance = distance;
+		}
+	}
+	if (!best.has_value()) {
+		return std::nullopt;
+	}
+	return m_names[*best];
+}
+
+} // namespace env::detail
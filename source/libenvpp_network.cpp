@@ -0,0 +1,410 @@
+#include <libenvpp/detail/network.hpp>
+
+#include <algorithm>
+
+#include <fmt/core.h>
+
+#include <libenvpp/detail/errors.hpp>
+
+namespace env::detail {
+
+namespace {
+
+using address_bytes = std::array<std::uint8_t, 16>;
+
+// Address split into its parts, with the zone ID referring to the parsed text.
+struct address_parts {
+	address_bytes bytes{};
+	ip_family family = ip_family::v4;
+	std::string_view zone_id;
+};
+
+constexpr auto NO_GAP = std::size_t{8};
+
+[[nodiscard]] constexpr bool is_digit(const char c) noexcept
+{
+	return c >= '0' && c <= '9';
+}
+
+[[nodiscard]] constexpr int hex_digit_value(const char c) noexcept
+{
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	}
+	if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	}
+	if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+[[nodiscard]] constexpr bool is_zone_id_char(const char c) noexcept
+{
+	return is_digit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-' || c == '_' || c == '.';
+}
+
+// The parse functions below return why 'str' is invalid, or 'nullptr' if it was parsed. Errors are reported as static
+// strings, so that nothing is allocated until the caller formats the error message.
+
+[[nodiscard]] const char* parse_ipv4(const std::string_view str, std::uint8_t* const bytes) noexcept
+{
+	auto pos = std::size_t{0};
+	for (std::size_t octet = 0; octet < 4; ++octet) {
+		if (octet > 0) {
+			if (pos == str.size() || str[pos] != '.') {
+				return "Expected 4 decimal octets separated by '.'";
+			}
+			++pos;
+		}
+		const auto begin = pos;
+		auto value = 0u;
+		for (; pos < str.size() && is_digit(str[pos]); ++pos) {
+			if (pos - begin == 3) {
+				return "Octets must be at most 255";
+			}
+			value = value * 10 + static_cast<unsigned>(str[pos] - '0');
+		}
+		if (pos == begin) {
+			return "Expected 4 decimal octets separated by '.'";
+		}
+		if (value > 255) {
+			return "Octets must be at most 255";
+		}
+		if (str[begin] == '0' && pos - begin > 1) {
+			return "Octets must not have leading zeros";
+		}
+		bytes[octet] = static_cast<std::uint8_t>(value);
+	}
+	if (pos != str.size()) {
+		return "Expected 4 decimal octets separated by '.'";
+	}
+	return nullptr;
+}
+
+[[nodiscard]] const char* parse_ipv6(const std::string_view str, address_bytes& bytes) noexcept
+{
+	auto groups = std::array<std::uint16_t, 8>{};
+	auto count = std::size_t{0};
+	auto gap = NO_GAP;
+	auto pos = std::size_t{0};
+	if (str.substr(0, 2) == "::") {
+		gap = 0;
+		pos = 2;
+	} else if (!str.empty() && str.front() == ':') {
+		return "Address must not start with a single ':'";
+	}
+
+	while (pos < str.size()) {
+		const auto begin = pos;
+		auto value = 0u;
+		for (; pos < str.size() && hex_digit_value(str[pos]) >= 0 && pos - begin < 5; ++pos) {
+			value = value * 16 + static_cast<unsigned>(hex_digit_value(str[pos]));
+		}
+		if (pos < str.size() && str[pos] == '.') {
+			// Embedded IPv4 address, which takes up the last two groups.
+			auto ipv4_bytes = std::array<std::uint8_t, 4>{};
+			if (parse_ipv4(str.substr(begin), ipv4_bytes.data()) != nullptr) {
+				return "Invalid embedded IPv4 address";
+			}
+			if (count > 6) {
+				return "Address has more than 8 groups";
+			}
+			groups[count++] = static_cast<std::uint16_t>(ipv4_bytes[0] << 8 | ipv4_bytes[1]);
+			groups[count++] = static_cast<std::uint16_t>(ipv4_bytes[2] << 8 | ipv4_bytes[3]);
+			pos = str.size();
+			break;
+		}
+		if (pos == begin) {
+			return "Expected groups of hexadecimal digits separated by ':'";
+		}
+		if (pos - begin > 4) {
+			return "Groups must have at most 4 hexadecimal digits";
+		}
+		if (count == 8) {
+			return "Address has more than 8 groups";
+		}
+		groups[count++] = static_cast<std::uint16_t>(value);
+		if (pos == str.size()) {
+			break;
+		}
+		if (str[pos] != ':') {
+			return "Expected groups of hexadecimal digits separated by ':'";
+		}
+		++pos;
+		if (pos < str.size() && str[pos] == ':') {
+			if (gap != NO_GAP) {
+				return "Address must contain '::' at most once";
+			}
+			gap = count;
+			++pos;
+		} else if (pos == str.size()) {
+			return "Address must not end with a single ':'";
+		}
+	}
+
+	if (gap == NO_GAP && count != 8) {
+		return "Address must have 8 groups, or fewer with '::'";
+	}
+	if (gap != NO_GAP && count == 8) {
+		return "Address has more than 8 groups";
+	}
+	bytes = {};
+	for (std::size_t i = 0; i < count; ++i) {
+		const auto index = i < gap ? i : i + 8 - count;
+		bytes[index * 2] = static_cast<std::uint8_t>(groups[i] >> 8);
+		bytes[index * 2 + 1] = static_cast<std::uint8_t>(groups[i] & 0xff);
+	}
+	return nullptr;
+}
+
+[[nodiscard]] const char* parse_address(const std::string_view str, address_parts& parts) noexcept
+{
+	if (str.empty()) {
+		return "Address must not be empty";
+	}
+	const auto zone_pos = str.find('%');
+	const auto address = str.substr(0, zone_pos);
+	if (address.find(':') == std::string_view::npos) {
+		if (zone_pos != std::string_view::npos) {
+			return "Zone IDs are only supported for IPv6 addresses";
+		}
+		parts.family = ip_family::v4;
+		return parse_ipv4(address, parts.bytes.data());
+	}
+
+	parts.family = ip_family::v6;
+	if (const auto* const error = parse_ipv6(address, parts.bytes); error != nullptr) {
+		return error;
+	}
+	if (zone_pos != std::string_view::npos) {
+		parts.zone_id = str.substr(zone_pos + 1);
+		if (parts.zone_id.empty()) {
+			return "Zone ID must not be empty";
+		}
+		if (parts.zone_id.size() > ip_address::MAX_ZONE_ID_SIZE) {
+			return "Zone ID is too long";
+		}
+		if (!std::all_of(parts.zone_id.begin(), parts.zone_id.end(), is_zone_id_char)) {
+			return "Zone ID must only contain letters, digits, '-', '_' and '.'";
+		}
+	}
+	return nullptr;
+}
+
+// Parses a decimal number of at most 'max_digits' digits without leading zeros into 'value'.
+[[nodiscard]] bool parse_decimal(const std::string_view str, const std::size_t max_digits, unsigned& value) noexcept
+{
+	if (str.empty() || str.size() > max_digits || (str.front() == '0' && str.size() > 1)
+	    || !std::all_of(str.begin(), str.end(), is_digit)) {
+		return false;
+	}
+	value = 0;
+	for (const auto c : str) {
+		value = value * 10 + static_cast<unsigned>(c - '0');
+	}
+	return true;
+}
+
+[[nodiscard]] const char* parse_port(const std::string_view str, std::uint16_t& port) noexcept
+{
+	if (str.empty()) {
+		return "Missing port";
+	}
+	auto value = 0u;
+	if (!parse_decimal(str, 5, value) || value > 65535) {
+		return "Port must be a number from 0 to 65535";
+	}
+	port = static_cast<std::uint16_t>(value);
+	return nullptr;
+}
+
+[[nodiscard]] bool looks_like_host_name(const std::string_view str) noexcept
+{
+	return std::any_of(str.begin(), str.end(),
+	                   [](const char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); });
+}
+
+[[nodiscard]] char* write_decimal(char* out, const unsigned value) noexcept
+{
+	if (value >= 10) {
+		out = write_decimal(out, value / 10);
+	}
+	*out++ = static_cast<char>('0' + value % 10);
+	return out;
+}
+
+[[nodiscard]] char* write_ipv4(char* out, const std::uint8_t* const bytes) noexcept
+{
+	for (std::size_t i = 0; i < 4; ++i) {
+		if (i > 0) {
+			*out++ = '.';
+		}
+		out = write_decimal(out, bytes[i]);
+	}
+	return out;
+}
+
+[[nodiscard]] char* write_hex_group(char* out, const unsigned group) noexcept
+{
+	constexpr auto digits = std::string_view("0123456789abcdef");
+	auto started = false;
+	for (auto shift = 12; shift >= 0; shift -= 4) {
+		const auto digit = (group >> shift) & 0xf;
+		if (started || digit != 0 || shift == 0) {
+			*out++ = digits[digit];
+			started = true;
+		}
+	}
+	return out;
+}
+
+} // namespace
+
+ip_address make_ip_address(const std::array<std::uint8_t, 16>& bytes, const ip_family family,
+                           const std::string_view zone_id) noexcept
+{
+	auto address = ip_address{};
+	address.m_bytes = bytes;
+	address.m_family = family;
+	std::copy(zone_id.begin(), zone_id.end(), address.m_zone_id.begin());
+	address.m_zone_id_size = static_cast<std::uint8_t>(zone_id.size());
+	return address;
+}
+
+ip_address parse_ip_address(const std::string_view str)
+{
+	auto parts = address_parts{};
+	if (const auto* const error = parse_address(str, parts); error != nullptr) {
+		throw parser_error{fmt::format("Invalid IP address '{}': {}", str, error)};
+	}
+	return make_ip_address(parts.bytes, parts.family, parts.zone_id);
+}
+
+cidr parse_cidr(const std::string_view str)
+{
+	const auto slash_pos = str.find('/');
+	if (slash_pos == std::string_view::npos) {
+		throw parser_error{fmt::format("Invalid CIDR '{}': Missing prefix length", str)};
+	}
+	auto parts = address_parts{};
+	if (const auto* const error = parse_address(str.substr(0, slash_pos), parts); error != nullptr) {
+		throw parser_error{fmt::format("Invalid CIDR '{}': {}", str, error)};
+	}
+	if (!parts.zone_id.empty()) {
+		throw parser_error{fmt::format("Invalid CIDR '{}': Networks cannot have a zone ID", str)};
+	}
+	const auto max_prefix_length = parts.family == ip_family::v4 ? 32u : 128u;
+	auto prefix_length = 0u;
+	if (!parse_decimal(str.substr(slash_pos + 1), 3, prefix_length) || prefix_length > max_prefix_length) {
+		throw parser_error{
+		    fmt::format("Invalid CIDR '{}': Prefix length must be a number from 0 to {}", str, max_prefix_length)};
+	}
+	return cidr{make_ip_address(parts.bytes, parts.family, {}), static_cast<std::uint8_t>(prefix_length)};
+}
+
+endpoint parse_endpoint(const std::string_view str)
+{
+	const auto throw_error = [str](const char* const error) {
+		throw parser_error{fmt::format("Invalid endpoint '{}': {}", str, error)};
+	};
+
+	auto parts = address_parts{};
+	auto port_str = std::string_view();
+	if (!str.empty() && str.front() == '[') {
+		const auto close_pos = str.find(']');
+		if (close_pos == std::string_view::npos) {
+			throw_error("Missing ']'");
+		}
+		if (const auto* const error = parse_address(str.substr(1, close_pos - 1), parts); error != nullptr) {
+			throw_error(error);
+		}
+		if (parts.family == ip_family::v4) {
+			throw_error("Only IPv6 addresses are enclosed in brackets");
+		}
+		if (close_pos + 1 == str.size()) {
+			throw_error("Missing port");
+		}
+		if (str[close_pos + 1] != ':') {
+			throw_error("Expected ':' after ']'");
+		}
+		port_str = str.substr(close_pos + 2);
+	} else {
+		const auto colon_pos = str.rfind(':');
+		if (colon_pos == std::string_view::npos) {
+			throw_error("Missing port");
+		}
+		const auto host = str.substr(0, colon_pos);
+		if (host.find(':') != std::string_view::npos) {
+			throw_error("IPv6 addresses must be enclosed in brackets, e.g. '[::1]:8080'");
+		}
+		if (const auto* const error = parse_address(host, parts); error != nullptr) {
+			throw_error(looks_like_host_name(host) ? "Host names are not resolved, the address must be numeric"
+			                                       : error);
+		}
+		port_str = str.substr(colon_pos + 1);
+	}
+
+	auto port = std::uint16_t{0};
+	if (const auto* const error = parse_port(port_str, port); error != nullptr) {
+		throw_error(error);
+	}
+	return endpoint{make_ip_address(parts.bytes, parts.family, parts.zone_id), port};
+}
+
+std::string_view format_ip_address(const ip_address& address, std::array<char, IP_ADDRESS_TEXT_SIZE>& buffer) noexcept
+{
+	const auto& bytes = address.bytes();
+	auto* out = buffer.data();
+	if (address.is_v4()) {
+		out = write_ipv4(out, bytes.data());
+		return std::string_view(buffer.data(), static_cast<std::size_t>(out - buffer.data()));
+	}
+
+	auto groups = std::array<unsigned, 8>{};
+	for (std::size_t i = 0; i < groups.size(); ++i) {
+		groups[i] = static_cast<unsigned>(bytes[i * 2] << 8 | bytes[i * 2 + 1]);
+	}
+	// RFC 5952: the longest run of at least two zero groups is compressed, the first one if there are several.
+	auto gap_begin = groups.size();
+	auto gap_size = std::size_t{1};
+	for (std::size_t i = 0; i < groups.size();) {
+		auto run_end = i;
+		while (run_end < groups.size() && groups[run_end] == 0) {
+			++run_end;
+		}
+		if (run_end - i > gap_size) {
+			gap_begin = i;
+			gap_size = run_end - i;
+		}
+		i = run_end == i ? i + 1 : run_end;
+	}
+
+	// IPv4-mapped addresses are written with the IPv4 address in dotted decimal, e.g. '::ffff:10.0.0.5'.
+	const auto is_ipv4_mapped = gap_begin == 0 && gap_size == 5 && groups[5] == 0xffff;
+	const auto group_count = is_ipv4_mapped ? std::size_t{6} : groups.size();
+	for (std::size_t i = 0; i < group_count; ++i) {
+		if (i == gap_begin) {
+			*out++ = ':';
+			*out++ = ':';
+			i += gap_size - 1;
+			continue;
+		}
+		if (i > 0 && i != gap_begin + gap_size) {
+			*out++ = ':';
+		}
+		out = write_hex_group(out, groups[i]);
+	}
+	if (is_ipv4_mapped) {
+		*out++ = ':';
+		out = write_ipv4(out, bytes.data() + 12);
+	}
+	if (!address.zone_id().empty()) {
+		*out++ = '%';
+		out = std::copy(address.zone_id().begin(), address.zone_id().end(), out);
+	}
+	return std::string_view(buffer.data(), static_cast<std::size_t>(out - buffer.data()));
+}
+
+} // namespace env::detail
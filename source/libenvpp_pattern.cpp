@@ -0,0 +1,455 @@
+#include <libenvpp/detail/pattern.hpp>
+
+#include <algorithm>
+#include <bitset>
+#include <map>
+#include <utility>
+
+#include <fmt/core.h>
+
+#include <libenvpp/detail/errors.hpp>
+
+namespace env::detail {
+
+namespace {
+
+using char_set = std::bitset<256>;
+
+constexpr auto UNBOUNDED = -1;
+constexpr auto MAX_NFA_STATES = std::size_t{1} << 16;
+constexpr auto NO_STATE = std::uint32_t{0xFFFFFFFF};
+
+struct pattern_node {
+	enum class kind {
+		chars,
+		concatenation,
+		alternation,
+		repetition,
+	};
+
+	kind type;
+	char_set chars;
+	std::vector<std::size_t> children;
+	int min = 0;
+	int max = 0;
+};
+
+[[nodiscard]] char_set make_range(const unsigned char first, const unsigned char last)
+{
+	auto set = char_set();
+	for (auto c = static_cast<unsigned>(first); c <= last; ++c) {
+		set.set(c);
+	}
+	return set;
+}
+
+[[nodiscard]] char_set make_char(const char c)
+{
+	auto set = char_set();
+	set.set(static_cast<unsigned char>(c));
+	return set;
+}
+
+// Recursive descent parser of the pattern syntax into a tree of nodes, whose root is returned by 'parse'.
+class pattern_parser {
+  public:
+	explicit pattern_parser(const std::string_view pattern) : m_pattern(pattern) {}
+
+	[[nodiscard]] std::size_t parse()
+	{
+		if (at('^')) {
+			++m_pos;
+		}
+		const auto root = parse_alternation();
+		if (at('$') && m_pos + 1 == m_pattern.size()) {
+			++m_pos;
+		}
+		if (m_pos != m_pattern.size()) {
+			fail(at(')') ? "Unmatched ')'" : "Unexpected character");
+		}
+		return root;
+	}
+
+	[[nodiscard]] const std::vector<pattern_node>& nodes() const noexcept { return m_nodes; }
+
+	[[noreturn]] void fail(const std::string_view reason) const
+	{
+		throw invalid_pattern{fmt::format("Invalid pattern '{}' at offset {}: {}", m_pattern, m_pos, reason)};
+	}
+
+  private:
+	[[nodiscard]] bool at(const char c) const noexcept { return m_pos < m_pattern.size() && m_pattern[m_pos] == c; }
+
+	[[nodiscard]] bool at_end_anchor() const noexcept { return at('$') && m_pos + 1 == m_pattern.size(); }
+
+	std::size_t add_node(pattern_node node)
+	{
+		m_nodes.push_back(std::move(node));
+		return m_nodes.size() - 1;
+	}
+
+	std::size_t parse_alternation()
+	{
+		auto children = std::vector<std::size_t>{parse_concatenation()};
+		while (at('|')) {
+			++m_pos;
+			children.push_back(parse_concatenation());
+		}
+		if (children.size() == 1) {
+			return children.front();
+		}
+		return add_node({pattern_node::kind::alternation, {}, std::move(children)});
+	}
+
+	std::size_t parse_concatenation()
+	{
+		auto children = std::vector<std::size_t>();
+		while (m_pos < m_pattern.size() && !at('|') && !at(')') && !at_end_anchor()) {
+			children.push_back(parse_repetition());
+		}
+		if (children.size() == 1) {
+			return children.front();
+		}
+		return add_node({pattern_node::kind::concatenation, {}, std::move(children)});
+	}
+
+	std::size_t parse_repetition()
+	{
+		auto node = parse_atom();
+		while (at('*') || at('+') || at('?') || at('{')) {
+			auto min = 0;
+			auto max = UNBOUNDED;
+			const auto quantifier = m_pattern[m_pos++];
+			if (quantifier == '+') {
+				min = 1;
+			} else if (quantifier == '?') {
+				max = 1;
+			} else if (quantifier == '{') {
+				min = parse_count();
+				max = min;
+				if (at(',')) {
+					++m_pos;
+					max = at('}') ? UNBOUNDED : parse_count();
+				}
+				if (!at('}')) {
+					fail("Missing '}'");
+				}
+				++m_pos;
+				if (max != UNBOUNDED && max < min) {
+					fail("Invalid repetition count");
+				}
+			}
+			node = add_node({pattern_node::kind::repetition, {}, {node}, min, max});
+		}
+		return node;
+	}
+
+	int parse_count()
+	{
+		if (m_pos >= m_pattern.size() || m_pattern[m_pos] < '0' || m_pattern[m_pos] > '9') {
+			fail("Expected repetition count");
+		}
+		auto count = 0;
+		for (; m_pos < m_pattern.size() && m_pattern[m_pos] >= '0' && m_pattern[m_pos] <= '9'; ++m_pos) {
+			count = count * 10 + (m_pattern[m_pos] - '0');
+			if (count > compiled_pattern::MAX_REPETITIONS) {
+				fail("Repetition count too large");
+			}
+		}
+		return count;
+	}
+
+	std::size_t parse_atom()
+	{
+		const auto c = m_pattern[m_pos];
+		if (c == '(') {
+			++m_pos;
+			if (m_pattern.substr(m_pos, 2) == "?:") {
+				m_pos += 2;
+			}
+			const auto node = parse_alternation();
+			if (!at(')')) {
+				fail("Missing ')'");
+			}
+			++m_pos;
+			return node;
+		}
+		if (c == '*' || c == '+' || c == '?' || c == '{') {
+			fail("Nothing to repeat");
+		}
+		auto chars = char_set();
+		if (c == '[') {
+			chars = parse_class();
+		} else if (c == '\\') {
+			chars = parse_escape();
+		} else if (c == '.') {
+			chars = ~make_char('\n');
+			++m_pos;
+		} else {
+			chars = make_char(c);
+			++m_pos;
+		}
+		return add_node({pattern_node::kind::chars, chars, {}});
+	}
+
+	char_set parse_escape()
+	{
+		++m_pos;
+		if (m_pos >= m_pattern.size()) {
+			fail("Trailing '\\'");
+		}
+		const auto c = m_pattern[m_pos++];
+		const auto digits = make_range('0', '9');
+		const auto word = make_range('a', 'z') | make_range('A', 'Z') | digits | make_char('_');
+		const auto space = make_char(' ') | make_range('\t', '\r');
+		switch (c) {
+		case 'd':
+			return digits;
+		case 'D':
+			return ~digits;
+		case 'w':
+			return word;
+		case 'W':
+			return ~word;
+		case 's':
+			return space;
+		case 'S':
+			return ~space;
+		case 'n':
+			return make_char('\n');
+		case 'r':
+			return make_char('\r');
+		case 't':
+			return make_char('\t');
+		default:
+			if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) {
+				--m_pos;
+				fail("Unknown escape sequence");
+			}
+			return make_char(c);
+		}
+	}
+
+	// Parses a single character of a class, which may be escaped. Escapes of several characters, such as '\d', are
+	// added to 'chars' directly and yield no character.
+	[[nodiscard]] bool parse_class_char(char_set& chars, unsigned char& c)
+	{
+		if (!at('\\')) {
+			c = static_cast<unsigned char>(m_pattern[m_pos++]);
+			return true;
+		}
+		const auto escaped = parse_escape();
+		if (escaped.count() != 1) {
+			chars |= escaped;
+			return false;
+		}
+		for (auto i = 0u; i < 256; ++i) {
+			if (escaped.test(i)) {
+				c = static_cast<unsigned char>(i);
+			}
+		}
+		return true;
+	}
+
+	char_set parse_class()
+	{
+		++m_pos;
+		const auto negated = at('^');
+		if (negated) {
+			++m_pos;
+		}
+		auto chars = char_set();
+		for (auto first = true;; first = false) {
+			if (m_pos >= m_pattern.size()) {
+				fail("Missing ']'");
+			}
+			if (at(']') && !first) {
+				++m_pos;
+				break;
+			}
+			auto lo = static_cast<unsigned char>(0);
+			if (!parse_class_char(chars, lo)) {
+				continue;
+			}
+			if (at('-') && m_pos + 1 < m_pattern.size() && m_pattern[m_pos + 1] != ']') {
+				++m_pos;
+				auto hi = static_cast<unsigned char>(0);
+				if (!parse_class_char(chars, hi) || hi < lo) {
+					fail("Invalid character range");
+				}
+				chars |= make_range(lo, hi);
+			} else {
+				chars.set(lo);
+			}
+		}
+		return negated ? ~chars : chars;
+	}
+
+	std::string_view m_pattern;
+	std::size_t m_pos = 0;
+	std::vector<pattern_node> m_nodes;
+};
+
+struct nfa_state {
+	char_set chars;
+	std::uint32_t next = NO_STATE;
+	std::vector<std::uint32_t> epsilon;
+};
+
+// Thompson construction of a nondeterministic automaton with a single start and a single accepting state.
+class nfa_builder {
+  public:
+	nfa_builder(const pattern_parser& parser) : m_parser(parser) {}
+
+	[[nodiscard]] std::pair<std::uint32_t, std::uint32_t> build(const std::size_t node_index)
+	{
+		const auto& node = m_parser.nodes()[node_index];
+		switch (node.type) {
+		case pattern_node::kind::chars: {
+			const auto start = add_state();
+			const auto end = add_state();
+			m_states[start].chars = node.chars;
+			m_states[start].next = end;
+			return {start, end};
+		}
+		case pattern_node::kind::concatenation: {
+			const auto start = add_state();
+			auto end = start;
+			for (const auto child : node.children) {
+				const auto [child_start, child_end] = build(child);
+				link(end, child_start);
+				end = child_end;
+			}
+			return {start, end};
+		}
+		case pattern_node::kind::alternation: {
+			const auto start = add_state();
+			const auto end = add_state();
+			for (const auto child : node.children) {
+				const auto [child_start, child_end] = build(child);
+				link(start, child_start);
+				link(child_end, end);
+			}
+			return {start, end};
+		}
+		case pattern_node::kind::repetition:
+		default: {
+			const auto start = add_state();
+			auto end = start;
+			for (auto i = 0; i < node.min; ++i) {
+				const auto [child_start, child_end] = build(node.children.front());
+				link(end, child_start);
+				end = child_end;
+			}
+			const auto repetition_end = add_state();
+			if (node.max == UNBOUNDED) {
+				const auto [child_start, child_end] = build(node.children.front());
+				link(end, child_start);
+				link(end, repetition_end);
+				link(child_end, end);
+			} else {
+				for (auto i = node.min; i < node.max; ++i) {
+					const auto [child_start, child_end] = build(node.children.front());
+					link(end, child_start);
+					link(end, repetition_end);
+					end = child_end;
+				}
+				link(end, repetition_end);
+			}
+			return {start, repetition_end};
+		}
+		}
+	}
+
+	[[nodiscard]] const std::vector<nfa_state>& states() const noexcept { return m_states; }
+
+  private:
+	std::uint32_t add_state()
+	{
+		if (m_states.size() >= MAX_NFA_STATES) {
+			m_parser.fail("Pattern too large");
+		}
+		m_states.emplace_back();
+		return static_cast<std::uint32_t>(m_states.size() - 1);
+	}
+
+	void link(const std::uint32_t from, const std::uint32_t to) { m_states[from].epsilon.push_back(to); }
+
+	const pattern_parser& m_parser;
+	std::vector<nfa_state> m_states;
+};
+
+// Returns the sorted set of states reachable from 'states' by epsilon transitions, including 'states' themselves.
+[[nodiscard]] std::vector<std::uint32_t> epsilon_closure(const std::vector<nfa_state>& nfa,
+                                                         std::vector<std::uint32_t> states, std::vector<bool>& visited)
+{
+	std::fill(visited.begin(), visited.end(), false);
+	for (const auto state : states) {
+		visited[state] = true;
+	}
+	for (std::size_t i = 0; i < states.size(); ++i) {
+		for (const auto next : nfa[states[i]].epsilon) {
+			if (!visited[next]) {
+				visited[next] = true;
+				states.push_back(next);
+			}
+		}
+	}
+	std::sort(states.begin(), states.end());
+	return states;
+}
+
+} // namespace
+
+compiled_pattern::compiled_pattern(const std::string_view pattern) : m_pattern(pattern)
+{
+	auto parser = pattern_parser(pattern);
+	const auto root = parser.parse();
+	auto builder = nfa_builder(parser);
+	const auto [nfa_start, nfa_accept] = builder.build(root);
+	const auto& nfa = builder.states();
+
+	// Subset construction, every state of the automaton is the set of states the nondeterministic automaton can be
+	// in. The empty set is the dead state, from which no match is possible any more.
+	auto visited = std::vector<bool>(nfa.size());
+	auto sets = std::vector<std::vector<std::uint32_t>>{{}};
+	auto ids = std::map<std::vector<std::uint32_t>, std::uint32_t>{{{}, DEAD_STATE}};
+	const auto find_or_add = [&](std::vector<std::uint32_t> set) {
+		const auto [it, inserted] = ids.try_emplace(std::move(set), static_cast<std::uint32_t>(sets.size()));
+		if (inserted) {
+			if (sets.size() >= MAX_STATES) {
+				throw invalid_pattern{fmt::format("Invalid pattern '{}': Pattern has more than {} states", pattern,
+				                                  MAX_STATES)};
+			}
+			sets.push_back(it->first);
+		}
+		return it->second;
+	};
+	m_start = find_or_add(epsilon_closure(nfa, {nfa_start}, visited));
+
+	auto moved = std::vector<std::uint32_t>();
+	for (std::size_t state = 0; state < sets.size(); ++state) {
+		m_transitions.resize((state + 1) * 256, DEAD_STATE);
+		if (state == DEAD_STATE) {
+			continue;
+		}
+		for (auto c = 0u; c < 256; ++c) {
+			moved.clear();
+			for (const auto from : sets[state]) {
+				if (nfa[from].chars.test(c)) {
+					moved.push_back(nfa[from].next);
+				}
+			}
+			if (!moved.empty()) {
+				m_transitions[state * 256 + c] = find_or_add(epsilon_closure(nfa, moved, visited));
+			}
+		}
+	}
+
+	m_accepting.resize(sets.size());
+	for (std::size_t state = 0; state < sets.size(); ++state) {
+		m_accepting[state] = std::binary_search(sets[state].begin(), sets[state].end(), nfa_accept);
+	}
+}
+
+} // namespace env::detail
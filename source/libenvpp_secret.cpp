@@ -0,0 +1,271 @@
+#include <libenvpp/detail/secret.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include <fmt/core.h>
+
+#if LIBENVPP_PLATFORM_UNIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#elif LIBENVPP_PLATFORM_WINDOWS
+#include <libenvpp/detail/environment.hpp>
+
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#endif
+
+namespace env {
+
+namespace detail {
+
+namespace {
+
+struct file_stamp {
+	std::int64_t modification_time;
+	std::uint64_t size;
+
+	[[nodiscard]] bool operator==(const file_stamp& other) const noexcept
+	{
+		return modification_time == other.modification_time && size == other.size;
+	}
+};
+
+struct cached_secret {
+	file_stamp stamp;
+	std::shared_ptr<const secret_buffer> content;
+};
+
+std::mutex g_secret_cache_mutex;
+std::unordered_map<std::string, cached_secret> g_secret_cache;
+
+#if LIBENVPP_PLATFORM_UNIX
+
+class file_handle {
+  public:
+	explicit file_handle(const std::string& path) : m_fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC)) {}
+	file_handle(const file_handle&) = delete;
+	file_handle& operator=(const file_handle&) = delete;
+	~file_handle()
+	{
+		if (m_fd >= 0) {
+			::close(m_fd);
+		}
+	}
+
+	[[nodiscard]] bool is_open() const noexcept { return m_fd >= 0; }
+
+	[[nodiscard]] expected<file_stamp, std::string> stamp() const
+	{
+		struct stat st {};
+		if (::fstat(m_fd, &st) != 0) {
+			return expected<file_stamp, std::string>{unexpected<std::string>{std::strerror(errno)}};
+		}
+		if (!S_ISREG(st.st_mode)) {
+			return expected<file_stamp, std::string>{unexpected<std::string>{"not a regular file"}};
+		}
+#if defined(__APPLE__)
+		const auto nanoseconds = static_cast<std::int64_t>(st.st_mtimespec.tv_nsec);
+#else
+		const auto nanoseconds = static_cast<std::int64_t>(st.st_mtim.tv_nsec);
+#endif
+		const auto modification_time = static_cast<std::int64_t>(st.st_mtime) * 1'000'000'000 + nanoseconds;
+		return expected<file_stamp, std::string>{file_stamp{modification_time, static_cast<std::uint64_t>(st.st_size)}};
+	}
+
+	// Reads up to 'size' bytes from the start of the file, returns the number of bytes read.
+	[[nodiscard]] expected<std::size_t, std::string> read(char* buffer, const std::size_t size) const
+	{
+		auto total = std::size_t{0};
+		while (total < size) {
+			const auto res = ::pread(m_fd, buffer + total, size - total, static_cast<off_t>(total));
+			if (res < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return expected<std::size_t, std::string>{unexpected<std::string>{std::strerror(errno)}};
+			}
+			if (res == 0) {
+				break;
+			}
+			total += static_cast<std::size_t>(res);
+		}
+		return expected<std::size_t, std::string>{total};
+	}
+
+	[[nodiscard]] static std::string last_error() { return std::strerror(errno); }
+
+  private:
+	int m_fd;
+};
+
+#elif LIBENVPP_PLATFORM_WINDOWS
+
+class file_handle {
+  public:
+	explicit file_handle(const std::string& path)
+	{
+		const auto wide_path = convert_string(path);
+		if (wide_path) {
+			m_handle = CreateFileW(wide_path->c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+			                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		}
+	}
+	file_handle(const file_handle&) = delete;
+	file_handle& operator=(const file_handle&) = delete;
+	~file_handle()
+	{
+		if (is_open()) {
+			CloseHandle(m_handle);
+		}
+	}
+
+	[[nodiscard]] bool is_open() const noexcept { return m_handle != INVALID_HANDLE_VALUE; }
+
+	[[nodiscard]] expected<file_stamp, std::string> stamp() const
+	{
+		auto info = BY_HANDLE_FILE_INFORMATION{};
+		if (!GetFileInformationByHandle(m_handle, &info)) {
+			return expected<file_stamp, std::string>{unexpected<std::string>{last_error()}};
+		}
+		if (info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+			return expected<file_stamp, std::string>{unexpected<std::string>{"not a regular file"}};
+		}
+		const auto modification_time =
+		    (static_cast<std::int64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) | info.ftLastWriteTime.dwLowDateTime;
+		const auto size = (static_cast<std::uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+		return expected<file_stamp, std::string>{file_stamp{modification_time, size}};
+	}
+
+	// Reads up to 'size' bytes from the start of the file, returns the number of bytes read.
+	[[nodiscard]] expected<std::size_t, std::string> read(char* buffer, const std::size_t size) const
+	{
+		auto total = std::size_t{0};
+		while (total < size) {
+			auto overlapped = OVERLAPPED{};
+			overlapped.Offset = static_cast<DWORD>(total);
+			auto bytes_read = DWORD{0};
+			if (!ReadFile(m_handle, buffer + total, static_cast<DWORD>(size - total), &bytes_read, &overlapped)) {
+				if (GetLastError() == ERROR_HANDLE_EOF) {
+					break;
+				}
+				return expected<std::size_t, std::string>{unexpected<std::string>{last_error()}};
+			}
+			if (bytes_read == 0) {
+				break;
+			}
+			total += bytes_read;
+		}
+		return expected<std::size_t, std::string>{total};
+	}
+
+	[[nodiscard]] static std::string last_error() { return fmt::format("error code {}", GetLastError()); }
+
+  private:
+	HANDLE m_handle = INVALID_HANDLE_VALUE;
+};
+
+#endif
+
+// Secret files are read again if they changed while reading them, until they were read this many times.
+constexpr auto SECRET_READ_ATTEMPTS = 3;
+
+[[nodiscard]] std::size_t trimmed_size(const std::string_view content)
+{
+	if (content.size() >= 2 && content.substr(content.size() - 2) == "\r\n") {
+		return content.size() - 2;
+	}
+	if (!content.empty() && content.back() == '\n') {
+		return content.size() - 1;
+	}
+	return content.size();
+}
+
+} // namespace
+
+void secure_zero(void* data, const std::size_t size) noexcept
+{
+	// Writing through a volatile pointer prevents the compiler from eliding the stores to memory that is released next.
+	auto* bytes = static_cast<volatile unsigned char*>(data);
+	for (std::size_t i = 0; i < size; ++i) {
+		bytes[i] = 0;
+	}
+}
+
+[[nodiscard]] expected<std::shared_ptr<const secret_buffer>, std::string>
+read_secret_file(const std::string_view path, const std::size_t size_limit)
+{
+	using expected_t = expected<std::shared_ptr<const secret_buffer>, std::string>;
+	using unexpected_t = typename expected_t::unexpected_type;
+
+	const auto path_str = std::string(path);
+	const auto file = file_handle(path_str);
+	if (!file.is_open()) {
+		return expected_t{unexpected_t{fmt::format("Failed to open secret file '{}': {}", path, file.last_error())}};
+	}
+	for (auto attempt = 0; attempt < SECRET_READ_ATTEMPTS; ++attempt) {
+		const auto stamp = file.stamp();
+		if (!stamp.has_value()) {
+			return expected_t{unexpected_t{fmt::format("Failed to query secret file '{}': {}", path, stamp.error())}};
+		}
+		if (stamp->size > size_limit) {
+			return expected_t{unexpected_t{
+			    fmt::format("Secret file '{}' exceeds the size limit of {} bytes", path, size_limit)}};
+		}
+
+		{
+			const auto lock = std::lock_guard(g_secret_cache_mutex);
+			if (const auto it = g_secret_cache.find(path_str);
+			    it != g_secret_cache.end() && it->second.stamp == *stamp) {
+				return expected_t{it->second.content};
+			}
+		}
+
+		// Read one byte more than the reported size to detect files that grew since querying them.
+		auto buffer = secret_buffer(static_cast<std::size_t>(stamp->size) + 1);
+		const auto bytes_read = file.read(buffer.data(), buffer.size());
+		if (!bytes_read.has_value()) {
+			return expected_t{
+			    unexpected_t{fmt::format("Failed to read secret file '{}': {}", path, bytes_read.error())}};
+		}
+		if (*bytes_read > size_limit) {
+			return expected_t{unexpected_t{
+			    fmt::format("Secret file '{}' exceeds the size limit of {} bytes", path, size_limit)}};
+		}
+		// A file which changed while reading it may have been read partially, so it is read again.
+		const auto stamp_after_read = file.stamp();
+		if (*bytes_read != stamp->size || !stamp_after_read.has_value() || !(*stamp_after_read == *stamp)) {
+			continue;
+		}
+		buffer.truncate(*bytes_read);
+		buffer.truncate(trimmed_size(buffer.view()));
+
+		auto content = std::make_shared<const secret_buffer>(std::move(buffer));
+		{
+			const auto lock = std::lock_guard(g_secret_cache_mutex);
+			g_secret_cache.insert_or_assign(path_str, cached_secret{*stamp, content});
+		}
+		return expected_t{std::move(content)};
+	}
+	return expected_t{unexpected_t{fmt::format("Secret file '{}' kept changing while reading it", path)}};
+}
+
+} // namespace detail
+
+void clear_secret_file_cache()
+{
+	auto released = std::unordered_map<std::string, detail::cached_secret>{};
+	{
+		const auto lock = std::lock_guard(detail::g_secret_cache_mutex);
+		released.swap(detail::g_secret_cache);
+	}
+}
+
+} // namespace env
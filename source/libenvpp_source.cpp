@@ -0,0 +1,139 @@
+#include <libenvpp/detail/source.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+
+#include <fmt/core.h>
+
+#include <libenvpp/detail/errors.hpp>
+
+namespace env {
+
+namespace {
+
+[[nodiscard]] std::string_view trim(std::string_view str)
+{
+	constexpr auto whitespace = std::string_view{" \t\r\n"};
+	const auto begin = str.find_first_not_of(whitespace);
+	if (begin == std::string_view::npos) {
+		return {};
+	}
+	str.remove_prefix(begin);
+	str.remove_suffix(str.size() - str.find_last_not_of(whitespace) - 1);
+	return str;
+}
+
+// Compares a command line option such as 'num-threads' with a registered variable name such as 'NUM_THREADS'.
+[[nodiscard]] bool option_matches_variable(const std::string_view option, const std::string_view var_name)
+{
+	constexpr auto to_option_char = [](const char c) -> char {
+		if ('A' <= c && c <= 'Z') {
+			return c + ('a' - 'A');
+		} else if (c == '_') {
+			return '-';
+		} else {
+			return c;
+		}
+	};
+	return std::equal(option.begin(), option.end(), var_name.begin(), var_name.end(),
+	                  [to_option_char](const char o, const char v) { return o == to_option_char(v); });
+}
+
+} // namespace
+
+[[nodiscard]] std::optional<std::string_view> environment_source::find(const std::string_view full_name,
+                                                                       const std::string_view) const
+{
+	// 'std::unordered_map' only supports looking up a 'std::string_view' from C++20 on, so the name is copied into a
+	// string of the calling thread instead, which is reused for all lookups.
+	thread_local auto lookup_key = std::string();
+	lookup_key.assign(full_name);
+	if (const auto it = m_environment.find(lookup_key); it != m_environment.end()) {
+		return it->second;
+	}
+	return std::nullopt;
+}
+
+command_line_source::command_line_source(const int argc, const char* const* argv)
+{
+	constexpr auto option_prefix = std::string_view{"--"};
+	for (int i = 1; i < argc; ++i) {
+		const auto arg = std::string_view(argv[i]);
+		if (arg == option_prefix) {
+			break;
+		}
+		if (arg.substr(0, option_prefix.size()) != option_prefix) {
+			continue;
+		}
+		const auto separator = arg.find('=');
+		if (separator == std::string_view::npos || separator == option_prefix.size()) {
+			continue;
+		}
+		m_options.emplace_back(arg.substr(option_prefix.size(), separator - option_prefix.size()),
+		                       arg.substr(separator + 1));
+	}
+}
+
+[[nodiscard]] std::optional<std::string_view> command_line_source::find(const std::string_view,
+                                                                        const std::string_view name) const
+{
+	const auto it = std::find_if(m_options.rbegin(), m_options.rend(),
+	                             [&name](const auto& option) { return option_matches_variable(option.first, name); });
+	if (it != m_options.rend()) {
+		return it->second;
+	}
+	return std::nullopt;
+}
+
+[[nodiscard]] std::optional<std::string_view> map_source::find(const std::string_view full_name,
+                                                               const std::string_view name) const
+{
+	if (const auto it = m_values.find(full_name); it != m_values.end()) {
+		return it->second;
+	}
+	if (const auto it = m_values.find(name); it != m_values.end()) {
+		return it->second;
+	}
+	return std::nullopt;
+}
+
+file_source::file_source(const std::filesystem::path& path)
+    : map_source(path.string(), detail::parse_config_file(path))
+{
+}
+
+namespace detail {
+
+[[nodiscard]] std::unordered_map<std::string, std::string> parse_config_file(const std::filesystem::path& path)
+{
+	auto file = std::ifstream(path);
+	if (!file) {
+		throw source_error{fmt::format("Failed to open configuration file '{}'", path.string())};
+	}
+
+	auto values = std::unordered_map<std::string, std::string>{};
+	auto line = std::string();
+	for (std::size_t line_number = 1; std::getline(file, line); ++line_number) {
+		const auto trimmed_line = trim(line);
+		if (trimmed_line.empty() || trimmed_line.front() == '#') {
+			continue;
+		}
+		const auto separator = trimmed_line.find('=');
+		if (separator == std::string_view::npos || separator == 0) {
+			throw source_error{fmt::format("Malformed line {} in configuration file '{}', expected 'KEY=VALUE'",
+			                               line_number, path.string())};
+		}
+		const auto key = trim(trimmed_line.substr(0, separator));
+		auto value = trim(trimmed_line.substr(separator + 1));
+		if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front()) {
+			value = value.substr(1, value.size() - 2);
+		}
+		values.insert_or_assign(std::string(key), std::string(value));
+	}
+	return values;
+}
+
+} // namespace detail
+
+} // namespace env
@@ -1,39 +1,140 @@
 #include <libenvpp/detail/testing.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
 #include <fmt/core.h>
 
+#include <libenvpp/detail/check.hpp>
 #include <libenvpp/detail/errors.hpp>
+#include <libenvpp/detail/levenshtein.hpp>
 
 namespace env {
 
 namespace detail {
 
-std::unordered_map<std::string, std::string> g_testing_environment;
+testing_environment_frames g_testing_environment;
+
+namespace {
+
+struct thread_testing_environment {
+	testing_environment_frames m_frames;
+	std::size_t m_global_fallbacks = 0;
+};
+
+thread_local thread_testing_environment t_thread_testing_environment;
+
+[[nodiscard]] bool uses_global_testing_environment()
+{
+	return t_thread_testing_environment.m_frames.empty() || t_thread_testing_environment.m_global_fallbacks > 0;
+}
+
+} // namespace
+
+void testing_environment_frames::pop(const frame& variables)
+{
+	const auto it = std::find(m_frames.rbegin(), m_frames.rend(), &variables);
+	LIBENVPP_CHECK(it != m_frames.rend());
+	m_frames.erase(std::next(it).base());
+}
 
-[[nodiscard]] std::unordered_map<std::string, std::string>
-merge_environments(const std::unordered_map<std::string, std::string>& high_precedence_env,
-                   const std::unordered_map<std::string, std::string>& low_precedence_env)
+[[nodiscard]] std::optional<std::string_view> testing_environment_frames::find(const std::string_view name) const
 {
-	auto merged = low_precedence_env;
-	for (const auto& [name, value] : high_precedence_env) {
-		merged[name] = value;
+	if (m_frames.empty()) {
+		return std::nullopt;
 	}
-	return merged;
+	for (auto it = m_frames.rbegin(); it != m_frames.rend(); ++it) {
+		if (const auto var_it = (*it)->find(name); var_it != (*it)->end()) {
+			return var_it->second;
+		}
+	}
+	return std::nullopt;
 }
 
-} // namespace detail
+[[nodiscard]] std::size_t testing_environment_frames::size() const noexcept
+{
+	auto size = std::size_t{0};
+	for (const auto* frame : m_frames) {
+		size += frame->size();
+	}
+	return size;
+}
 
-scoped_test_environment::scoped_test_environment(const std::unordered_map<std::string, std::string>& environment)
+void testing_environment_frames::append_frames(std::vector<const frame*>& frames) const
+{
+	frames.insert(frames.end(), m_frames.rbegin(), m_frames.rend());
+}
+
+[[nodiscard]] std::optional<std::string_view> find_testing_variable(const std::string_view name)
+{
+	if (const auto value = t_thread_testing_environment.m_frames.find(name); value.has_value()) {
+		return value;
+	}
+	if (uses_global_testing_environment()) {
+		return g_testing_environment.find(name);
+	}
+	return std::nullopt;
+}
+
+testing_environment_view::testing_environment_view(const std::unordered_map<std::string, std::string>& environment)
     : m_environment(environment)
+{
+	t_thread_testing_environment.m_frames.append_frames(m_frames);
+	if (uses_global_testing_environment()) {
+		g_testing_environment.append_frames(m_frames);
+	}
+}
+
+[[nodiscard]] std::optional<std::string_view> testing_environment_view::find(const std::string_view name) const
+{
+	for (const auto* frame : m_frames) {
+		if (const auto var_it = frame->find(name); var_it != frame->end()) {
+			return var_it->second;
+		}
+	}
+	m_lookup_key.assign(name);
+	if (const auto var_it = m_environment.find(m_lookup_key); var_it != m_environment.end()) {
+		return var_it->second;
+	}
+	return std::nullopt;
+}
+
+[[nodiscard]] std::optional<std::string_view>
+testing_environment_view::find_similar(const std::string_view name, const int edit_distance_cutoff) const
+{
+	auto similar_name = std::optional<std::string_view>{};
+	auto similar_distance = edit_distance_cutoff + 1;
+	for_each([&](const std::string_view var_name, const std::string_view) {
+		if (const auto distance = levenshtein::distance(name, var_name, similar_distance);
+		    distance < similar_distance) {
+			similar_name = var_name;
+			similar_distance = distance;
+		}
+	});
+	return similar_name;
+}
+
+[[nodiscard]] bool testing_environment_view::is_shadowed(const std::string_view name,
+                                                         const std::size_t frame_count) const
+{
+	return std::any_of(m_frames.begin(), std::next(m_frames.begin(), static_cast<std::ptrdiff_t>(frame_count)),
+	                   [&](const auto* frame) { return frame->find(name) != frame->end(); });
+}
+
+} // namespace detail
+
+scoped_test_environment::scoped_test_environment(std::unordered_map<std::string, std::string> environment)
+    : m_environment(std::make_move_iterator(environment.begin()), std::make_move_iterator(environment.end()))
 {
 	for (const auto& [name, value] : m_environment) {
-		if (const auto it = detail::g_testing_environment.find(name); it != detail::g_testing_environment.end()) {
+		if (const auto existing_value = detail::g_testing_environment.find(name); existing_value.has_value()) {
 			throw test_environment_error{fmt::format("The global test environment already contains the value '{}' for "
 			                                         "variable '{}', while trying to set it to '{}'",
-			                                         it->second, name, value)};
+			                                         *existing_value, name, value)};
 		}
-		detail::g_testing_environment[name] = value;
 	}
+	detail::g_testing_environment.push(m_environment);
 }
 
 scoped_test_environment::scoped_test_environment(const std::string_view name, const std::string_view value)
@@ -43,8 +144,33 @@ scoped_test_environment::scoped_test_environment(const std::string_view name, co
 
 scoped_test_environment::~scoped_test_environment()
 {
-	for (const auto& [name, _] : m_environment) {
-		detail::g_testing_environment.erase(name);
+	detail::g_testing_environment.pop(m_environment);
+}
+
+scoped_thread_test_environment::scoped_thread_test_environment(
+    std::unordered_map<std::string, std::string> environment, const global_test_environment global)
+    : m_environment(std::make_move_iterator(environment.begin()), std::make_move_iterator(environment.end())),
+      m_global(global)
+{
+	detail::t_thread_testing_environment.m_frames.push(m_environment);
+	if (m_global == global_test_environment::fallback) {
+		++detail::t_thread_testing_environment.m_global_fallbacks;
+	}
+}
+
+scoped_thread_test_environment::scoped_thread_test_environment(const std::string_view name,
+                                                               const std::string_view value,
+                                                               const global_test_environment global)
+    : scoped_thread_test_environment(
+          std::unordered_map<std::string, std::string>{{std::string(name), std::string(value)}}, global)
+{
+}
+
+scoped_thread_test_environment::~scoped_thread_test_environment()
+{
+	detail::t_thread_testing_environment.m_frames.pop(m_environment);
+	if (m_global == global_test_environment::fallback) {
+		--detail::t_thread_testing_environment.m_global_fallbacks;
 	}
 }
 
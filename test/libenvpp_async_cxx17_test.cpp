@@ -0,0 +1,24 @@
+#include <string>
+#include <unordered_map>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+// Compiled without coroutines and linked together with the asynchronous tests, which must not be affected by the
+// parsing code instantiated here.
+static_assert(!LIBENVPP_COROUTINES_ENABLED);
+
+TEST_CASE("Parsing without coroutines in the same program", "[libenvpp_async]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto num_threads_id = pre.register_variable<int>("NUM_THREADS");
+	auto parsed_and_validated_pre =
+	    pre.parse_and_validate(std::unordered_map<std::string, std::string>{{"LIBENVPP_TESTING_NUM_THREADS", "8"}});
+	REQUIRE(parsed_and_validated_pre.ok());
+	CHECK(parsed_and_validated_pre.get(num_threads_id) == 8);
+}
+
+} // namespace env
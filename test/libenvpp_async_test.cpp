@@ -0,0 +1,307 @@
+#include <libenvpp/env.hpp>
+
+#if LIBENVPP_COROUTINES_ENABLED
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+#include <fmt/core.h>
+
+#if LIBENVPP_PLATFORM_UNIX
+#include <cerrno>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace env {
+
+using Catch::Matchers::ContainsSubstring;
+
+namespace {
+
+task<int> sleep_and_parse(const std::string_view str)
+{
+	co_await sleep_for(std::chrono::milliseconds(100));
+	co_return default_parser<int>{}(str);
+}
+
+task<int> sleep_and_fail(const std::string_view str)
+{
+	co_await sleep_for(std::chrono::milliseconds(1));
+	throw validation_error{fmt::format("Rejected '{}'", str)};
+}
+
+#if LIBENVPP_PLATFORM_UNIX
+class file_descriptor {
+  public:
+	explicit file_descriptor(const int fd) : m_fd(fd)
+	{
+		if (m_fd < 0) {
+			throw std::runtime_error(fmt::format("Failed to create socket: {}", std::strerror(errno)));
+		}
+	}
+
+	file_descriptor(const file_descriptor&) = delete;
+	file_descriptor& operator=(const file_descriptor&) = delete;
+
+	~file_descriptor() { ::close(m_fd); }
+
+	[[nodiscard]] int get() const noexcept { return m_fd; }
+
+  private:
+	int m_fd;
+};
+
+[[nodiscard]] sockaddr_un make_address(const std::string& path)
+{
+	auto address = sockaddr_un{};
+	address.sun_family = AF_UNIX;
+	std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+	return address;
+}
+
+// Unix domain socket server standing in for a remote service, which answers every connection with "READY" or, if it
+// is unresponsive, accepts connections without ever answering.
+class unix_socket_stub {
+  public:
+	explicit unix_socket_stub(const bool is_responsive)
+	    : m_path((std::filesystem::temp_directory_path()
+	              / fmt::format("libenvpp_async_test_{}_{}.sock", ::getpid(), s_instance_count++))
+	                 .string()),
+	      m_socket(::socket(AF_UNIX, SOCK_STREAM, 0))
+	{
+		const auto address = make_address(m_path);
+		std::filesystem::remove(m_path);
+		if (::bind(m_socket.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+		    || ::listen(m_socket.get(), 16) != 0) {
+			throw std::runtime_error(fmt::format("Failed to listen on '{}': {}", m_path, std::strerror(errno)));
+		}
+		m_thread = std::thread([this, is_responsive] { serve(is_responsive); });
+	}
+
+	unix_socket_stub(const unix_socket_stub&) = delete;
+	unix_socket_stub& operator=(const unix_socket_stub&) = delete;
+
+	~unix_socket_stub()
+	{
+		m_stopping = true;
+		m_thread.join();
+		for (const auto fd : m_unanswered) {
+			::close(fd);
+		}
+		std::filesystem::remove(m_path);
+	}
+
+	[[nodiscard]] const std::string& path() const noexcept { return m_path; }
+
+  private:
+	void serve(const bool is_responsive)
+	{
+		while (!m_stopping) {
+			auto listening = pollfd{m_socket.get(), POLLIN, 0};
+			if (::poll(&listening, 1, 10) <= 0) {
+				continue;
+			}
+			const auto fd = ::accept(m_socket.get(), nullptr, nullptr);
+			if (fd < 0) {
+				continue;
+			}
+			if (is_responsive) {
+				constexpr auto response = std::string_view("READY");
+				[[maybe_unused]] const auto written = ::write(fd, response.data(), response.size());
+				::close(fd);
+			} else {
+				m_unanswered.push_back(fd);
+			}
+		}
+	}
+
+	static inline std::atomic<int> s_instance_count = 0;
+
+	std::string m_path;
+	file_descriptor m_socket;
+	std::atomic<bool> m_stopping = false;
+	std::vector<int> m_unanswered;
+	std::thread m_thread;
+};
+
+task<std::string> read_until_closed(const int fd)
+{
+	auto response = std::string{};
+	char buffer[64];
+	while (true) {
+		co_await wait_readable(fd);
+		const auto count = ::read(fd, buffer, sizeof(buffer));
+		if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			continue;
+		}
+		if (count < 0) {
+			throw validation_error{fmt::format("Failed to read: {}", std::strerror(errno))};
+		}
+		if (count == 0) {
+			co_return response;
+		}
+		response.append(buffer, static_cast<std::size_t>(count));
+	}
+}
+
+// Asynchronous validator checking that the service listening on the socket at 'path' is ready.
+task<std::string> service_socket(const std::string_view path)
+{
+	const auto socket = file_descriptor(::socket(AF_UNIX, SOCK_STREAM, 0));
+	::fcntl(socket.get(), F_SETFL, ::fcntl(socket.get(), F_GETFL) | O_NONBLOCK);
+	const auto address = make_address(std::string(path));
+	if (::connect(socket.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+		if (errno != EINPROGRESS && errno != EAGAIN) {
+			throw validation_error{fmt::format("Failed to connect: {}", std::strerror(errno))};
+		}
+		co_await wait_writable(socket.get());
+	}
+	const auto response = co_await read_until_closed(socket.get());
+	if (response != "READY") {
+		throw validation_error{fmt::format("Service is not ready, it responded with '{}'", response)};
+	}
+	co_return std::string(path);
+}
+#endif
+
+} // namespace
+
+TEST_CASE("Asynchronous validators run concurrently", "[libenvpp_async]")
+{
+	auto pre = prefix("CONCURRENT");
+	const auto first_id = pre.register_variable<int>("FIRST", sleep_and_parse);
+	const auto second_id = pre.register_variable<int>("SECOND", sleep_and_parse);
+	const auto third_id = pre.register_variable<int>("THIRD", sleep_and_parse);
+	const auto fourth_id = pre.register_variable<int>("FOURTH", sleep_and_parse);
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto parsed_and_validated_pre = pre.parse_and_validate_async(
+	    default_async_timeout,
+	    {{"CONCURRENT_FIRST", "1"}, {"CONCURRENT_SECOND", "2"}, {"CONCURRENT_THIRD", "3"}, {"CONCURRENT_FOURTH", "4"}});
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	REQUIRE(parsed_and_validated_pre.ok());
+	CHECK(parsed_and_validated_pre.get(first_id) == 1);
+	CHECK(parsed_and_validated_pre.get(second_id) == 2);
+	CHECK(parsed_and_validated_pre.get(third_id) == 3);
+	CHECK(parsed_and_validated_pre.get(fourth_id) == 4);
+	// Sleeping one after another would take at least 400ms.
+	CHECK(elapsed < std::chrono::milliseconds(350));
+}
+
+TEST_CASE("Asynchronous parsing yields the same result as parsing synchronously", "[libenvpp_async]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{
+	    {"ASYNC_VALID", "1"},          {"ASYNC_REJECTED", "abc"},  {"ASYNC_NOT_AN_INT", "abc"},
+	    {"ASYNC_OUT_OF_RANGE", "100"}, {"ASYNC_UNUSED", "unused"}, {"ASYNC_VALID_2", "2"},
+	};
+	const auto parse = [&](const bool is_async) {
+		auto pre = prefix("ASYNC");
+		const auto valid_id = pre.register_required_variable<int>("VALID", sleep_and_parse);
+		[[maybe_unused]] const auto rejected_id = pre.register_variable<int>("REJECTED", sleep_and_fail);
+		[[maybe_unused]] const auto not_an_int_id = pre.register_variable<int>("NOT_AN_INT", sleep_and_parse);
+		[[maybe_unused]] const auto out_of_range_id = pre.register_range<int>("OUT_OF_RANGE", 0, 10);
+		[[maybe_unused]] const auto missing_id = pre.register_required_variable<int>("MISSING", sleep_and_parse);
+		const auto valid_2_id = pre.register_variable<int>("VALID_2");
+		auto parsed_and_validated_pre = is_async ? pre.parse_and_validate_async(default_async_timeout, environment)
+		                                         : pre.parse_and_validate(environment);
+		CHECK(parsed_and_validated_pre.get(valid_id) == 1);
+		CHECK(parsed_and_validated_pre.get(valid_2_id) == 2);
+		return parsed_and_validated_pre;
+	};
+
+	const auto sequential = parse(false);
+	REQUIRE(sequential.errors().size() == 4);
+	CHECK_THAT(sequential.error_message(), ContainsSubstring("Rejected 'abc'"));
+
+	const auto async = parse(true);
+	CHECK(async.error_message() == sequential.error_message());
+	CHECK(async.warning_message() == sequential.warning_message());
+}
+
+#if LIBENVPP_PLATFORM_UNIX
+TEST_CASE("Asynchronous validator querying a service", "[libenvpp_async]")
+{
+	const auto service = unix_socket_stub(true);
+	auto pre = prefix("SERVICE");
+	const auto socket_id = pre.register_required_variable<std::string>("SOCKET", service_socket);
+	const auto parsed_and_validated_pre = pre.parse_and_validate_async(default_async_timeout,
+	                                                                   {{"SERVICE_SOCKET", service.path()}});
+	REQUIRE(parsed_and_validated_pre.ok());
+	CHECK(parsed_and_validated_pre.get(socket_id) == service.path());
+}
+
+TEST_CASE("Asynchronous validators time out", "[libenvpp_async]")
+{
+	const auto responsive_service = unix_socket_stub(true);
+	const auto unresponsive_service = unix_socket_stub(false);
+	auto pre = prefix("TIMEOUT");
+	const auto responsive_id = pre.register_variable<std::string>("RESPONSIVE", service_socket);
+	const auto unresponsive_id = pre.register_variable<std::string>("UNRESPONSIVE", service_socket);
+
+	SECTION("Per variable timeout")
+	{
+		pre.set_timeout(unresponsive_id, std::chrono::milliseconds(100));
+		const auto start = std::chrono::steady_clock::now();
+		const auto parsed_and_validated_pre = pre.parse_and_validate_async(
+		    default_async_timeout,
+		    {{"TIMEOUT_RESPONSIVE", responsive_service.path()}, {"TIMEOUT_UNRESPONSIVE", unresponsive_service.path()}});
+		CHECK(std::chrono::steady_clock::now() - start < default_async_timeout);
+		CHECK(parsed_and_validated_pre.get(responsive_id) == responsive_service.path());
+		CHECK_FALSE(parsed_and_validated_pre.get(unresponsive_id).has_value());
+		REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+		CHECK(std::string(parsed_and_validated_pre.errors()[0].what())
+		      == "Parser and validator of environment variable 'TIMEOUT_UNRESPONSIVE' timed out after 100ms");
+	}
+
+	SECTION("Default timeout")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate_async(
+		    std::chrono::milliseconds(50),
+		    {{"TIMEOUT_RESPONSIVE", responsive_service.path()}, {"TIMEOUT_UNRESPONSIVE", unresponsive_service.path()}});
+		CHECK(parsed_and_validated_pre.get(responsive_id) == responsive_service.path());
+		REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+		CHECK_THAT(parsed_and_validated_pre.errors()[0].what(), ContainsSubstring("timed out after 50ms"));
+	}
+
+	SECTION("Without an event loop")
+	{
+		pre.set_timeout(unresponsive_id, std::chrono::milliseconds(100));
+		const auto parsed_and_validated_pre = pre.parse_and_validate(
+		    {{"TIMEOUT_RESPONSIVE", responsive_service.path()}, {"TIMEOUT_UNRESPONSIVE", unresponsive_service.path()}});
+		CHECK(parsed_and_validated_pre.get(responsive_id) == responsive_service.path());
+		CHECK_FALSE(parsed_and_validated_pre.get(unresponsive_id).has_value());
+		REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+		CHECK(std::string(parsed_and_validated_pre.errors()[0].what())
+		      == "Parser and validator of environment variable 'TIMEOUT_UNRESPONSIVE' timed out after 100ms");
+	}
+}
+
+TEST_CASE("Asynchronous validator failing to connect", "[libenvpp_async]")
+{
+	auto pre = prefix("MISSING_SERVICE");
+	[[maybe_unused]] const auto socket_id = pre.register_variable<std::string>("SOCKET", service_socket);
+	const auto parsed_and_validated_pre =
+	    pre.parse_and_validate_async(default_async_timeout, {{"MISSING_SERVICE_SOCKET", "/nonexistent/service.sock"}});
+	REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+	CHECK_THAT(parsed_and_validated_pre.errors()[0].what(), ContainsSubstring("Failed to connect"));
+}
+#endif
+
+} // namespace env
+
+#endif
@@ -0,0 +1,297 @@
+#include <any>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+#include <fmt/core.h>
+
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+using Catch::Matchers::ContainsSubstring;
+using Catch::Matchers::Equals;
+
+class cache_file_fixture {
+  public:
+	cache_file_fixture()
+	    : m_cache(std::filesystem::temp_directory_path()
+	              / fmt::format("libenvpp_cache_test_{}.bin", std::random_device{}()))
+	{
+	}
+
+	~cache_file_fixture() { std::filesystem::remove(m_cache.path()); }
+
+	config_cache m_cache;
+};
+
+// Stateless, as variables with stateful parsers are not cached.
+struct counting_parser {
+	int operator()(const std::string_view str) const
+	{
+		++calls;
+		return default_parser<int>{}(str);
+	}
+
+	static inline int calls = 0;
+};
+
+struct point {
+	int x;
+	int y;
+};
+
+enum class color { red, green };
+
+enum plain_color { plain_red, plain_green };
+
+TEST_CASE("Hashes are computable at compile time", "[libenvpp_cache]")
+{
+	static_assert(detail::fnv1a("") == detail::FNV1A_OFFSET_BASIS);
+	static_assert(detail::fnv1a("a") == 0xaf63dc4c8601ec8cull);
+	static_assert(detail::hash_combine(1, 2) != detail::hash_combine(2, 1));
+}
+
+TEST_CASE("Cacheable types", "[libenvpp_cache]")
+{
+	static_assert(detail::is_cacheable_v<int>);
+	static_assert(detail::is_cacheable_v<double>);
+	static_assert(detail::is_cacheable_v<bool>);
+	static_assert(detail::is_cacheable_v<std::string>);
+	static_assert(detail::is_cacheable_v<color>);
+	static_assert(detail::is_cacheable_v<std::chrono::milliseconds>);
+	static_assert(detail::is_cacheable_v<byte_size>);
+	static_assert(!detail::is_cacheable_v<plain_color>);
+	static_assert(!detail::is_cacheable_v<point>);
+	static_assert(!detail::is_cacheable_v<const char*>);
+	static_assert(!detail::is_cacheable_v<std::string_view>);
+	static_assert(!detail::is_cacheable_v<std::filesystem::path>);
+	static_assert(!detail::is_cacheable_v<std::vector<int>>);
+}
+
+TEST_CASE("Invalid cached values are rejected", "[libenvpp_cache]")
+{
+	const auto true_value = true;
+	const auto true_bytes = std::string_view(reinterpret_cast<const char*>(&true_value), sizeof(bool));
+	const auto value = detail::deserialize_cached_value<bool>(true_bytes);
+	REQUIRE(value.has_value());
+	CHECK(std::any_cast<bool>(*value));
+
+	const auto invalid_bytes = std::string(sizeof(bool), '\x02');
+	CHECK_FALSE(detail::deserialize_cached_value<bool>(invalid_bytes).has_value());
+	CHECK_FALSE(detail::deserialize_cached_value<int>(std::string(sizeof(int) + 1, '\0')).has_value());
+}
+
+TEST_CASE_METHOD(cache_file_fixture, "Cached values skip parsing", "[libenvpp_cache]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{
+	    {"LIBENVPP_TESTING_NUM_THREADS", "8"},
+	    {"LIBENVPP_TESTING_NAME", "cached"},
+	};
+	auto& calls = counting_parser::calls;
+	calls = 0;
+	const auto parse = [&] {
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		const auto num_threads_id = pre.register_required_variable<int>("NUM_THREADS", counting_parser{});
+		const auto name_id = pre.register_variable<std::string>("NAME");
+		const auto timeout_id = pre.register_variable<int>("TIMEOUT");
+		auto parsed_and_validated_pre = pre.parse_and_validate(m_cache, environment);
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(num_threads_id) == 8);
+		CHECK(parsed_and_validated_pre.get_source(num_threads_id) == "environment");
+		CHECK_THAT(parsed_and_validated_pre.get_or(name_id, ""), Equals("cached"));
+		CHECK_FALSE(parsed_and_validated_pre.get(timeout_id).has_value());
+	};
+
+	parse();
+	CHECK(calls == 1);
+	CHECK(std::filesystem::exists(m_cache.path()));
+	parse();
+	CHECK(calls == 1);
+}
+
+TEST_CASE_METHOD(cache_file_fixture, "Changed environment invalidates the cache", "[libenvpp_cache]")
+{
+	auto& calls = counting_parser::calls;
+	calls = 0;
+	const auto parse = [&](const std::unordered_map<std::string, std::string>& environment) {
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		const auto num_threads_id = pre.register_variable<int>("NUM_THREADS", counting_parser{});
+		auto parsed_and_validated_pre = pre.parse_and_validate(m_cache, environment);
+		return std::pair{parsed_and_validated_pre.get(num_threads_id), parsed_and_validated_pre.warnings().size()};
+	};
+
+	CHECK(parse({{"LIBENVPP_TESTING_NUM_THREADS", "8"}}) == std::pair{std::optional{8}, std::size_t{0}});
+	CHECK(parse({{"LIBENVPP_TESTING_NUM_THREADS", "16"}}) == std::pair{std::optional{16}, std::size_t{0}});
+	CHECK(calls == 2);
+	CHECK(parse({{"LIBENVPP_TESTING_NUM_THREADS", "16"}, {"LIBENVPP_TESTING_UNUSED", "1"}})
+	      == std::pair{std::optional{16}, std::size_t{1}});
+	CHECK(calls == 3);
+}
+
+TEST_CASE_METHOD(cache_file_fixture, "Changed schema invalidates the cache", "[libenvpp_cache]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{{"LIBENVPP_TESTING_NUM_THREADS", "8"}};
+
+	{
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		[[maybe_unused]] const auto num_threads_id = pre.register_range<int>("NUM_THREADS", 1, 10);
+		REQUIRE(pre.parse_and_validate(m_cache, environment).ok());
+	}
+	{
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		[[maybe_unused]] const auto num_threads_id = pre.register_range<int>("NUM_THREADS", 1, 4);
+		auto parsed_and_validated_pre = pre.parse_and_validate(m_cache, environment);
+		REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+		CHECK_THAT(parsed_and_validated_pre.errors()[0].what(), ContainsSubstring("outside of range"));
+	}
+	{
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		const auto num_threads_id = pre.register_variable<double>("NUM_THREADS");
+		auto parsed_and_validated_pre = pre.parse_and_validate(m_cache, environment);
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(num_threads_id) == 8.0);
+	}
+}
+
+TEST_CASE_METHOD(cache_file_fixture, "Errors are not cached", "[libenvpp_cache]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{{"LIBENVPP_TESTING_NUM_THREADS", "many"}};
+	auto& calls = counting_parser::calls;
+	calls = 0;
+	for (int i = 0; i < 2; ++i) {
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		[[maybe_unused]] const auto num_threads_id = pre.register_variable<int>("NUM_THREADS", counting_parser{});
+		auto parsed_and_validated_pre = pre.parse_and_validate(m_cache, environment);
+		CHECK(parsed_and_validated_pre.errors().size() == 1);
+	}
+	CHECK(calls == 2);
+	CHECK_FALSE(std::filesystem::exists(m_cache.path()));
+}
+
+TEST_CASE_METHOD(cache_file_fixture, "Corrupt cache file falls back to parsing", "[libenvpp_cache]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{{"LIBENVPP_TESTING_NUM_THREADS", "8"}};
+	auto& calls = counting_parser::calls;
+	calls = 0;
+	const auto parse = [&] {
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		const auto num_threads_id = pre.register_variable<int>("NUM_THREADS", counting_parser{});
+		auto parsed_and_validated_pre = pre.parse_and_validate(m_cache, environment);
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(num_threads_id) == 8);
+	};
+
+	parse();
+	const auto size = std::filesystem::file_size(m_cache.path());
+	std::filesystem::resize_file(m_cache.path(), size - 1);
+	parse();
+	CHECK(calls == 2);
+
+	{
+		auto file = std::ofstream(m_cache.path(), std::ios::binary | std::ios::trunc);
+		file << "garbage";
+	}
+	parse();
+	CHECK(calls == 3);
+	parse();
+	CHECK(calls == 3);
+
+	{
+		auto file = std::fstream(m_cache.path(), std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(-1, std::ios::end);
+		file.put('\x09');
+	}
+	parse();
+	CHECK(calls == 4);
+}
+
+#if LIBENVPP_PLATFORM_UNIX
+TEST_CASE_METHOD(cache_file_fixture, "Cache files writable by others are ignored", "[libenvpp_cache]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{{"LIBENVPP_TESTING_NUM_THREADS", "8"}};
+	auto& calls = counting_parser::calls;
+	calls = 0;
+	const auto parse = [&] {
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		const auto num_threads_id = pre.register_variable<int>("NUM_THREADS", counting_parser{});
+		auto parsed_and_validated_pre = pre.parse_and_validate(m_cache, environment);
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(num_threads_id) == 8);
+	};
+
+	using std::filesystem::perms;
+	parse();
+	CHECK(std::filesystem::status(m_cache.path()).permissions() == (perms::owner_read | perms::owner_write));
+	parse();
+	CHECK(calls == 1);
+
+	std::filesystem::permissions(m_cache.path(), perms::others_write, std::filesystem::perm_options::add);
+	parse();
+	CHECK(calls == 2);
+	CHECK(std::filesystem::status(m_cache.path()).permissions() == (perms::owner_read | perms::owner_write));
+}
+#endif
+
+TEST_CASE_METHOD(cache_file_fixture, "Uncacheable prefixes bypass the cache", "[libenvpp_cache]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{
+	    {"LIBENVPP_TESTING_NUM_THREADS", "8"},
+	    {"LIBENVPP_TESTING_LOG_PATH", "/dev/null"},
+	};
+	auto& calls = counting_parser::calls;
+	calls = 0;
+	for (int i = 0; i < 2; ++i) {
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		const auto num_threads_id = pre.register_variable<int>("NUM_THREADS", counting_parser{});
+		const auto log_path_id = pre.register_variable<std::filesystem::path>("LOG_PATH");
+		auto parsed_and_validated_pre = pre.parse_and_validate(m_cache, environment);
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(num_threads_id) == 8);
+		CHECK(parsed_and_validated_pre.get(log_path_id) == "/dev/null");
+	}
+	CHECK(calls == 2);
+	CHECK_FALSE(std::filesystem::exists(m_cache.path()));
+}
+
+TEST_CASE_METHOD(cache_file_fixture, "Stateful parsers bypass the cache", "[libenvpp_cache]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{{"LIBENVPP_TESTING_NUM_THREADS", "8"}};
+	const auto parse = [&](const int limit) {
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		[[maybe_unused]] const auto num_threads_id =
+		    pre.register_variable<int>("NUM_THREADS", [limit](const std::string_view str) {
+			    const auto value = default_parser<int>{}(str);
+			    if (value > limit) {
+				    throw validation_error{"Too many threads"};
+			    }
+			    return value;
+		    });
+		return pre.parse_and_validate(m_cache, environment).ok();
+	};
+
+	CHECK(parse(10));
+	CHECK_FALSE(parse(5));
+	CHECK_FALSE(std::filesystem::exists(m_cache.path()));
+}
+
+TEST_CASE_METHOD(cache_file_fixture, "Variables set for testing bypass the cache", "[libenvpp_cache]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{{"LIBENVPP_TESTING_NUM_THREADS", "8"}};
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto num_threads_id = pre.register_variable<int>("NUM_THREADS");
+	pre.set_for_testing(num_threads_id, 4);
+	auto parsed_and_validated_pre = pre.parse_and_validate(m_cache, environment);
+	REQUIRE(parsed_and_validated_pre.ok());
+	CHECK(parsed_and_validated_pre.get(num_threads_id) == 4);
+	CHECK_FALSE(std::filesystem::exists(m_cache.path()));
+}
+
+} // namespace env
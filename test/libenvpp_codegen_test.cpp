@@ -0,0 +1,108 @@
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+#include <libenvpp/env.hpp>
+#include <libenvpp_codegen_test.hpp>
+
+namespace env {
+
+using Catch::Matchers::ContainsSubstring;
+using Catch::Matchers::Equals;
+
+using testing::codegen_config;
+using testing::codegen_config_schema;
+
+static_assert(std::is_same_v<decltype(codegen_config::num_threads), unsigned int>);
+static_assert(std::is_same_v<decltype(codegen_config::log_file_path), std::optional<std::filesystem::path>>);
+static_assert(std::is_same_v<decltype(codegen_config::is_verbose), std::optional<bool>>);
+
+static_assert(codegen_config_schema::size == 13);
+static_assert(codegen_config_schema::names[4] == "LIBENVPP_TESTING_NAME");
+static_assert(codegen_config_schema::required[0] && !codegen_config_schema::required[1]);
+
+TEST_CASE("Generated schema finds all variables", "[libenvpp_codegen]")
+{
+	for (std::size_t i = 0; i < codegen_config_schema::size; ++i) {
+		CHECK(codegen_config_schema::find(codegen_config_schema::names[i]) == i);
+	}
+	static_assert(codegen_config_schema::find("LIBENVPP_TESTING_RATIO") == 3);
+	CHECK(codegen_config_schema::find("LIBENVPP_TESTING_OTHER") == codegen_config_schema::size);
+	CHECK(codegen_config_schema::find("LIBENVPP_TESTING_NAM") == codegen_config_schema::size);
+	CHECK(codegen_config_schema::find("") == codegen_config_schema::size);
+}
+
+TEST_CASE("Generated config is parsed", "[libenvpp_codegen]")
+{
+	const auto parsed_config = testing::parse_codegen_config({
+	    {"LIBENVPP_TESTING_NUM_THREADS", "8"},
+	    {"LIBENVPP_TESTING_VERBOSE", "true"},
+	    {"LIBENVPP_TESTING_RATIO", "0.5"},
+	    {"LIBENVPP_TESTING_NAME", "generated"},
+	    {"OTHER_VARIABLE", "1"},
+	});
+	REQUIRE(parsed_config.ok());
+
+	const auto& config = parsed_config.get();
+	CHECK(config.num_threads == 8);
+	CHECK_FALSE(config.log_file_path.has_value());
+	CHECK(config.is_verbose == true);
+	CHECK(config.ratio == 0.5);
+	CHECK_THAT(config.name, Equals("generated"));
+	CHECK_FALSE(config.a.has_value());
+}
+
+TEST_CASE("Generated config reports errors and warnings like a prefix", "[libenvpp_codegen]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{
+	    {"LIBENVPP_TESTING_NUM_THREADS", "many"},
+	    {"LIBENVPP_TESTING_NAEM", "typo"},
+	    {"LIBENVPP_TESTING_RATO", "0.5"},
+	    {"LIBENVPP_TESTING_UNUSED", "1"},
+	};
+	const auto parsed_config = testing::parse_codegen_config(environment);
+
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	[[maybe_unused]] const auto num_threads_id = pre.register_required_variable<unsigned int>("NUM_THREADS");
+	[[maybe_unused]] const auto log_file_path_id = pre.register_variable<std::filesystem::path>("LOG_FILE_PATH");
+	[[maybe_unused]] const auto verbose_id = pre.register_variable<bool>("VERBOSE");
+	[[maybe_unused]] const auto ratio_id = pre.register_variable<double>("RATIO");
+	[[maybe_unused]] const auto name_id = pre.register_required_variable<std::string>("NAME");
+	for (const auto* name : {"A", "B", "C", "D", "E", "F", "G", "H"}) {
+		[[maybe_unused]] const auto id = pre.register_variable<int>(name);
+	}
+	const auto parsed_and_validated_pre = pre.parse_and_validate(environment);
+
+	REQUIRE(parsed_config.errors().size() == 2);
+	REQUIRE(parsed_config.errors().size() == parsed_and_validated_pre.errors().size());
+	for (std::size_t i = 0; i < parsed_config.errors().size(); ++i) {
+		CHECK(parsed_config.errors()[i].get_id() == parsed_and_validated_pre.errors()[i].get_id());
+		CHECK(parsed_config.errors()[i].get_name() == parsed_and_validated_pre.errors()[i].get_name());
+		CHECK(parsed_config.errors()[i].what() == parsed_and_validated_pre.errors()[i].what());
+	}
+	CHECK_THAT(parsed_config.error_message(), ContainsSubstring("LIBENVPP_TESTING_NAEM"));
+
+	REQUIRE(parsed_config.warnings().size() == 2);
+	REQUIRE(parsed_config.warnings().size() == parsed_and_validated_pre.warnings().size());
+	for (std::size_t i = 0; i < parsed_config.warnings().size(); ++i) {
+		CHECK(parsed_config.warnings()[i].what() == parsed_and_validated_pre.warnings()[i].what());
+	}
+	CHECK_THAT(parsed_config.warning_message(), ContainsSubstring("LIBENVPP_TESTING_UNUSED"));
+}
+
+TEST_CASE("Generated config considers the testing environment", "[libenvpp_codegen]")
+{
+	const auto _ = scoped_test_environment({
+	    {"LIBENVPP_TESTING_NUM_THREADS", "4"},
+	    {"LIBENVPP_TESTING_NAME", "test"},
+	});
+	const auto parsed_config = testing::parse_codegen_config({{"LIBENVPP_TESTING_NUM_THREADS", "8"}});
+	REQUIRE(parsed_config.ok());
+	CHECK(parsed_config.get().num_threads == 4);
+	CHECK_THAT(parsed_config.get().name, Equals("test"));
+}
+
+} // namespace env
@@ -0,0 +1,120 @@
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+#include <libenvpp/detail/name_table.hpp>
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+using Catch::Matchers::ContainsSubstring;
+
+namespace {
+
+enum class mode {
+	fast,
+	balanced,
+	thorough,
+};
+
+} // namespace
+
+TEST_CASE("Name table", "[libenvpp_enum]")
+{
+	SECTION("Case-sensitive")
+	{
+		const auto table = detail::name_table({"fast", "balanced", "thorough"}, case_sensitivity::sensitive);
+		CHECK(table.size() == 3);
+		CHECK(table.find("fast") == 0);
+		CHECK(table.find("balanced") == 1);
+		CHECK(table.find("thorough") == 2);
+		CHECK(table.find("Fast") == 3);
+		CHECK(table.find("") == 3);
+		CHECK(table.find_similar("balansed", 1) == "balanced");
+		CHECK(table.find_similar("balansd", 1) == std::nullopt);
+	}
+
+	SECTION("Case-insensitive")
+	{
+		const auto table = detail::name_table({"Fast", "BALANCED"}, case_sensitivity::insensitive);
+		CHECK(table.find("fast") == 0);
+		CHECK(table.find("FAST") == 0);
+		CHECK(table.find("Balanced") == 1);
+		CHECK(table.find("slow") == 2);
+		CHECK(table.find_similar("balansed", 1) == "BALANCED");
+	}
+
+	SECTION("Many names")
+	{
+		auto names = std::vector<std::string>();
+		for (auto i = 0; i < 500; ++i) {
+			names.push_back("name_" + std::to_string(i));
+		}
+		const auto table = detail::name_table(names, case_sensitivity::sensitive);
+		for (std::size_t i = 0; i < names.size(); ++i) {
+			CHECK(table.find(names[i]) == i);
+		}
+		CHECK(table.find("name_500") == names.size());
+	}
+
+	SECTION("Invalid")
+	{
+		CHECK_THROWS_AS(detail::name_table({}, case_sensitivity::sensitive), empty_option);
+		CHECK_THROWS_AS(detail::name_table({"a", "a"}, case_sensitivity::sensitive), duplicate_option);
+		CHECK_NOTHROW(detail::name_table({"a", "A"}, case_sensitivity::sensitive));
+		CHECK_THROWS_AS(detail::name_table({"a", "A"}, case_sensitivity::insensitive), duplicate_option);
+	}
+}
+
+TEST_CASE("Enum variables", "[libenvpp_enum]")
+{
+	auto pre = prefix("MYPROG");
+	const auto mode_id = pre.register_enum<mode>(
+	    "MODE", {{"fast", mode::fast}, {"balanced", mode::balanced}, {"thorough", mode::thorough}});
+	const auto level_id = pre.register_required_enum<mode>(
+	    "LEVEL", {{"low", mode::fast}, {"medium", mode::balanced}, {"high", mode::thorough}, {"max", mode::thorough}},
+	    case_sensitivity::insensitive);
+
+	SECTION("Well-formed")
+	{
+		const auto parsed_and_validated_pre =
+		    pre.parse_and_validate({{"MYPROG_MODE", "balanced"}, {"MYPROG_LEVEL", "MAX"}});
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(mode_id) == mode::balanced);
+		CHECK(parsed_and_validated_pre.get(level_id) == mode::thorough);
+	}
+
+	SECTION("Typo")
+	{
+		const auto parsed_and_validated_pre =
+		    pre.parse_and_validate({{"MYPROG_MODE", "thourough"}, {"MYPROG_LEVEL", "Mediun"}});
+		REQUIRE(parsed_and_validated_pre.errors().size() == 2);
+		CHECK(parsed_and_validated_pre.errors()[0].kind() == error_kind::option);
+		CHECK_THAT(parsed_and_validated_pre.error_message(),
+		           ContainsSubstring("Unrecognized option 'thourough', did you mean 'thorough'?")
+		               && ContainsSubstring("Unrecognized option 'Mediun', did you mean 'medium'?"));
+	}
+
+	SECTION("Unrecognized")
+	{
+		const auto parsed_and_validated_pre =
+		    pre.parse_and_validate({{"MYPROG_MODE", "Fast"}, {"MYPROG_LEVEL", "extreme"}});
+		REQUIRE(parsed_and_validated_pre.errors().size() == 2);
+		CHECK_THAT(parsed_and_validated_pre.errors()[0].what(), ContainsSubstring("Unrecognized option 'Fast'"));
+		CHECK_THAT(parsed_and_validated_pre.errors()[1].what(),
+		           ContainsSubstring("Unrecognized option 'extreme'") && !ContainsSubstring("did you mean"));
+	}
+}
+
+TEST_CASE("Invalid enum registration", "[libenvpp_enum]")
+{
+	auto pre = prefix("MYPROG");
+	CHECK_THROWS_WITH(pre.register_enum<mode>("EMPTY", {}), ContainsSubstring("No names provided for 'MYPROG_EMPTY'"));
+	CHECK_THROWS_WITH(pre.register_enum<mode>("DUPLICATE", {{"fast", mode::fast}, {"FAST", mode::fast}},
+	                                          case_sensitivity::insensitive),
+	                  ContainsSubstring("Duplicate name 'fast' specified for 'MYPROG_DUPLICATE'"));
+}
+
+} // namespace env
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+#include <fmt/core.h>
+
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+using Catch::Matchers::ContainsSubstring;
+
+class inline_executor final : public executor {
+  public:
+	void execute(std::function<void()> task) override
+	{
+		if (m_fail_after.has_value() && m_calls == *m_fail_after) {
+			throw std::runtime_error("Executor is full");
+		}
+		++m_calls;
+		task();
+	}
+
+	std::size_t m_calls = 0;
+	std::optional<std::size_t> m_fail_after;
+};
+
+// Parser which blocks until 'm_expected' parsers are running at the same time, or a timeout elapses.
+struct rendezvous_parser {
+	struct state {
+		std::mutex m_mutex;
+		std::condition_variable m_arrived;
+		int m_running = 0;
+		int m_max_running = 0;
+	};
+
+	int operator()(const std::string_view str) const
+	{
+		auto lock = std::unique_lock(m_state->m_mutex);
+		++m_state->m_running;
+		m_state->m_max_running = std::max(m_state->m_max_running, m_state->m_running);
+		m_state->m_arrived.notify_all();
+		m_state->m_arrived.wait_for(lock, std::chrono::seconds(5),
+		                            [&] { return m_state->m_max_running >= m_expected; });
+		--m_state->m_running;
+		return default_parser<int>{}(str);
+	}
+
+	state* m_state;
+	int m_expected;
+};
+
+TEST_CASE("Thread pool runs all tasks", "[libenvpp_executor]")
+{
+	auto counter = std::atomic<int>{0};
+	{
+		auto pool = thread_pool(3);
+		CHECK(pool.thread_count() == 3);
+		for (int i = 0; i < 100; ++i) {
+			pool.execute([&] { ++counter; });
+		}
+	}
+	CHECK(counter == 100);
+
+	CHECK(thread_pool(0).thread_count() == 1);
+}
+
+TEST_CASE("Parsing on an executor yields the same result as parsing sequentially", "[libenvpp_executor]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{
+	    {"EXECUTOR_VALID", "1"},         {"EXECUTOR_NOT_AN_INT", "abc"}, {"EXECUTOR_OUT_OF_RANGE", "100"},
+	    {"EXECUTOR_INVALID_OPTION", "c"}, {"EXECUTOR_OPTINAL", "5"},     {"EXECUTOR_UNUSED", "unused"},
+	    {"EXECUTOR_VALID_2", "2"},
+	};
+	const auto parse = [&](executor* exec) {
+		auto pre = prefix("EXECUTOR");
+		const auto valid_id = pre.register_required_variable<int>("VALID");
+		[[maybe_unused]] const auto not_an_int_id = pre.register_variable<int>("NOT_AN_INT");
+		[[maybe_unused]] const auto out_of_range_id = pre.register_range<int>("OUT_OF_RANGE", 0, 10);
+		[[maybe_unused]] const auto invalid_option_id = pre.register_option<std::string>("INVALID_OPTION", {"a", "b"});
+		[[maybe_unused]] const auto optional_id = pre.register_variable<int>("OPTIONAL");
+		[[maybe_unused]] const auto missing_id = pre.register_required_variable<int>("MISSING");
+		const auto valid_2_id = pre.register_variable<int>("VALID_2");
+		auto parsed_and_validated_pre = exec ? pre.parse_and_validate(*exec, environment)
+		                                     : pre.parse_and_validate(environment);
+		CHECK(parsed_and_validated_pre.get(valid_id) == 1);
+		CHECK(parsed_and_validated_pre.get(valid_2_id) == 2);
+		return parsed_and_validated_pre;
+	};
+
+	const auto sequential = parse(nullptr);
+	REQUIRE(sequential.errors().size() == 4);
+
+	SECTION("Thread pool")
+	{
+		auto pool = thread_pool(4);
+		const auto parallel = parse(&pool);
+		CHECK(parallel.error_message() == sequential.error_message());
+		CHECK(parallel.warning_message() == sequential.warning_message());
+	}
+
+	SECTION("Caller-supplied executor")
+	{
+		auto exec = inline_executor{};
+		const auto parallel = parse(&exec);
+		CHECK(exec.m_calls == 5);
+		CHECK(parallel.error_message() == sequential.error_message());
+		CHECK(parallel.warning_message() == sequential.warning_message());
+	}
+}
+
+TEST_CASE("Validators run concurrently on an executor", "[libenvpp_executor]")
+{
+	constexpr auto variable_count = 4;
+	auto state = rendezvous_parser::state{};
+	auto pre = prefix("CONCURRENT");
+	auto environment = std::unordered_map<std::string, std::string>{};
+	for (int i = 0; i < variable_count; ++i) {
+		[[maybe_unused]] const auto id =
+		    pre.register_variable<int>(std::to_string(i), rendezvous_parser{&state, variable_count});
+		environment.emplace(fmt::format("CONCURRENT_{}", i), std::to_string(i));
+	}
+
+	auto pool = thread_pool(variable_count);
+	const auto parsed_and_validated_pre = pre.parse_and_validate(pool, environment);
+	CHECK(parsed_and_validated_pre.ok());
+	CHECK(state.m_max_running == variable_count);
+}
+
+TEST_CASE("Errors are reported in registration order regardless of completion order", "[libenvpp_executor]")
+{
+	auto pre = prefix("ORDER");
+	auto environment = std::unordered_map<std::string, std::string>{};
+	for (int i = 0; i < 8; ++i) {
+		// Earlier variables take longer to validate, and therefore finish later.
+		[[maybe_unused]] const auto id = pre.register_variable<int>(std::to_string(i), [i](const std::string_view) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(2 * (8 - i)));
+			throw validation_error{std::to_string(i)};
+			return 0;
+		});
+		environment.emplace(fmt::format("ORDER_{}", i), "value");
+	}
+
+	auto pool = thread_pool(8);
+	const auto parsed_and_validated_pre = pre.parse_and_validate(pool, environment);
+	REQUIRE(parsed_and_validated_pre.errors().size() == 8);
+	for (std::size_t i = 0; i < 8; ++i) {
+		CHECK(parsed_and_validated_pre.errors()[i].get_id() == i);
+	}
+}
+
+TEST_CASE("Failure to execute is propagated after submitted parses finished", "[libenvpp_executor]")
+{
+	auto pre = prefix("FAILING");
+	[[maybe_unused]] const auto first_id = pre.register_variable<int>("FIRST");
+	[[maybe_unused]] const auto second_id = pre.register_variable<int>("SECOND");
+	auto exec = inline_executor{};
+	exec.m_fail_after = 1;
+	CHECK_THROWS_WITH(pre.parse_and_validate(exec, {{"FAILING_FIRST", "1"}, {"FAILING_SECOND", "2"}}),
+	                  ContainsSubstring("Executor is full"));
+	CHECK(exec.m_calls == 1);
+}
+
+} // namespace env
@@ -0,0 +1,224 @@
+#if LIBENVPP_INSTRUMENTATION_ENABLED
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+class parse_observer_fixture {
+  public:
+	parse_observer_fixture()
+	{
+		set_parse_observer([this](const parse_stats& stats) { m_observed.push_back(stats); });
+	}
+
+	~parse_observer_fixture() { set_parse_observer({}); }
+
+	std::vector<parse_stats> m_observed;
+};
+
+namespace {
+
+thread_local std::size_t t_custom_allocation_count = 0;
+
+std::size_t count_custom_allocations() noexcept
+{
+	return t_custom_allocation_count;
+}
+
+struct alignas(4 * __STDCPP_DEFAULT_NEW_ALIGNMENT__) over_aligned {
+	int value = 0;
+};
+
+} // namespace
+
+TEST_CASE("Allocations of the calling thread are counted", "[libenvpp_instrumentation]")
+{
+	const auto allocations_before = detail::allocation_count();
+	const auto value = std::make_unique<int>(42);
+	CHECK(*value == 42);
+	CHECK(detail::allocation_count() == allocations_before + 1);
+
+	const auto values = std::make_unique<int[]>(8);
+	CHECK(detail::allocation_count() == allocations_before + 2);
+
+	const auto nothrow_value = std::unique_ptr<int>(new (std::nothrow) int(42));
+	REQUIRE(nothrow_value);
+	CHECK(detail::allocation_count() == allocations_before + 3);
+
+	const auto aligned_value = std::make_unique<over_aligned>();
+	CHECK(reinterpret_cast<std::uintptr_t>(aligned_value.get()) % alignof(over_aligned) == 0);
+	CHECK(detail::allocation_count() == allocations_before + 4);
+
+	const auto aligned_values = std::make_unique<over_aligned[]>(8);
+	CHECK(reinterpret_cast<std::uintptr_t>(aligned_values.get()) % alignof(over_aligned) == 0);
+	CHECK(detail::allocation_count() == allocations_before + 5);
+}
+
+TEST_CASE("Installed allocation counter", "[libenvpp_instrumentation]")
+{
+	const auto previous_counter = set_allocation_counter(count_custom_allocations);
+	CHECK(previous_counter != nullptr);
+	t_custom_allocation_count = 42;
+	CHECK(detail::allocation_count() == 42);
+
+	CHECK(set_allocation_counter(nullptr) == count_custom_allocations);
+	CHECK(detail::allocation_count() == 0);
+
+	CHECK(set_allocation_counter(previous_counter) == nullptr);
+}
+
+TEST_CASE("Statistics of each phase and variable", "[libenvpp_instrumentation]")
+{
+	auto pre = prefix("INSTRUMENTATION");
+	const auto int_id = pre.register_variable<int>("INT");
+	const auto string_id = pre.register_variable<std::string>("STRING");
+	const auto unset_id = pre.register_variable<int>("UNSET");
+	const auto parsed_and_validated_pre = pre.parse_and_validate({
+	    {"INSTRUMENTATION_INT", "42"},
+	    {"INSTRUMENTATION_STRING", "a string long enough to not fit into the small string buffer"},
+	    {"INSTRUMENTATION_UNSTE", "misspelled"},
+	    {"INSTRUMENTATION_SUPERFLUOUS_VARIABLE", "unused"},
+	    {"UNRELATED", "unrelated"},
+	});
+	CHECK(parsed_and_validated_pre.get(int_id) == 42);
+	CHECK(parsed_and_validated_pre.get(string_id).has_value());
+	CHECK_FALSE(parsed_and_validated_pre.get(unset_id).has_value());
+
+	const auto& stats = parsed_and_validated_pre.stats();
+	CHECK(stats.prefix_name == "INSTRUMENTATION_");
+	CHECK_FALSE(stats.cache_hit);
+
+	REQUIRE(stats.variables.size() == 3);
+	CHECK(stats.variables[0].name == "INT");
+	CHECK(stats.variables[1].name == "STRING");
+	CHECK(stats.variables[2].name == "UNSET");
+	CHECK(stats.variables[1].parse.allocations > 0);
+	CHECK(stats.variables[0].typo_detection.allocations == 0);
+	CHECK(stats.variables[1].typo_detection.allocations == 0);
+	CHECK(stats.variables[2].typo_detection.allocations > 0);
+
+	// The testing environment is read through instead of being merged into a copy of the environment, while reporting
+	// the misspelled and the unused variable allocates.
+	CHECK(stats.environment.allocations == 0);
+	CHECK(stats.unused_detection.allocations > 0);
+	CHECK(stats.cache.allocations == 0);
+
+	auto parse = phase_stats{};
+	auto typo_detection = phase_stats{};
+	for (const auto& var_stats : stats.variables) {
+		parse += var_stats.parse;
+		typo_detection += var_stats.typo_detection;
+	}
+	CHECK(stats.parse.allocations == parse.allocations);
+	CHECK(stats.parse.duration == parse.duration);
+	CHECK(stats.typo_detection.allocations == typo_detection.allocations);
+	CHECK(stats.typo_detection.duration == typo_detection.duration);
+
+	CHECK(stats.total.allocations
+	      >= stats.environment.allocations + stats.cache.allocations + stats.parse.allocations
+	             + stats.typo_detection.allocations + stats.unused_detection.allocations);
+	CHECK(stats.total.duration
+	      >= stats.environment.duration + stats.cache.duration + stats.parse.duration + stats.typo_detection.duration
+	             + stats.unused_detection.duration);
+}
+
+TEST_CASE("Capturing the environment is part of the environment phase", "[libenvpp_instrumentation]")
+{
+	const auto _ = detail::set_scoped_environment_variable{"INSTRUMENTATION_CAPTURED", "captured"};
+	auto pre = prefix("INSTRUMENTATION");
+	const auto captured_id = pre.register_variable<std::string>("CAPTURED");
+	const auto parsed_and_validated_pre = pre.parse_and_validate();
+	CHECK(parsed_and_validated_pre.get(captured_id) == "captured");
+	CHECK(parsed_and_validated_pre.stats().environment.allocations > 0);
+}
+
+TEST_CASE_METHOD(parse_observer_fixture, "Parse observer", "[libenvpp_instrumentation]")
+{
+	{
+		auto pre = prefix("OBSERVED");
+		[[maybe_unused]] const auto required_id = pre.register_required_variable<int>("REQUIRED");
+		const auto parsed_and_validated_pre = pre.parse_and_validate({{"OBSERVED_REQUIERD", "1"}});
+		CHECK_FALSE(parsed_and_validated_pre.ok());
+
+		REQUIRE(m_observed.size() == 1);
+		CHECK(m_observed[0].prefix_name == "OBSERVED_");
+		REQUIRE(m_observed[0].variables.size() == 1);
+		CHECK(m_observed[0].variables[0].name == "REQUIRED");
+		CHECK(m_observed[0].total.duration == parsed_and_validated_pre.stats().total.duration);
+		CHECK(m_observed[0].total.allocations == parsed_and_validated_pre.stats().total.allocations);
+	}
+
+	SECTION("Uninstalled observer is not called")
+	{
+		set_parse_observer({});
+		auto pre = prefix("OBSERVED");
+		[[maybe_unused]] const auto parsed_and_validated_pre = pre.parse_and_validate({{"UNRELATED", "unrelated"}});
+		CHECK(m_observed.size() == 1);
+	}
+
+	SECTION("Observer may replace itself")
+	{
+		auto replaced_observer_calls = 0;
+		set_parse_observer([&](const parse_stats&) {
+			++replaced_observer_calls;
+			set_parse_observer({});
+		});
+		for (int i = 0; i < 2; ++i) {
+			auto pre = prefix("OBSERVED");
+			[[maybe_unused]] const auto parsed_and_validated_pre = pre.parse_and_validate({{"UNRELATED", "unrelated"}});
+		}
+		CHECK(replaced_observer_calls == 1);
+	}
+}
+
+TEST_CASE("Statistics of cache hits", "[libenvpp_instrumentation]")
+{
+	const auto cache = config_cache(std::filesystem::temp_directory_path()
+	                                / fmt::format("libenvpp_instrumentation_test_{}.bin", std::random_device{}()));
+	const auto parse = [&] {
+		auto pre = prefix("CACHED");
+		const auto int_id = pre.register_variable<int>("INT");
+		auto parsed_and_validated_pre = pre.parse_and_validate(cache, {{"CACHED_INT", "42"}});
+		CHECK(parsed_and_validated_pre.get(int_id) == 42);
+		return parsed_and_validated_pre;
+	};
+
+	const auto miss = parse();
+	CHECK_FALSE(miss.stats().cache_hit);
+	CHECK(miss.stats().cache.allocations > 0);
+
+	const auto hit = parse();
+	CHECK(hit.stats().cache_hit);
+	REQUIRE(hit.stats().variables.size() == 1);
+	CHECK(hit.stats().variables[0].name == "INT");
+	CHECK(hit.stats().parse.allocations == 0);
+
+	std::filesystem::remove(cache.path());
+}
+
+TEST_CASE("Statistics are moved with the parsed and validated prefix", "[libenvpp_instrumentation]")
+{
+	auto pre = prefix("MOVED");
+	[[maybe_unused]] const auto int_id = pre.register_variable<int>("INT");
+	auto parsed_and_validated_pre = pre.parse_and_validate({{"UNRELATED", "unrelated"}});
+	const auto moved = std::move(parsed_and_validated_pre);
+	CHECK(moved.stats().prefix_name == "MOVED_");
+	CHECK_THROWS_AS(parsed_and_validated_pre.stats(), invalidated_prefix);
+}
+
+} // namespace env
+
+#endif
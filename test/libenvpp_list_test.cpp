@@ -0,0 +1,157 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+#include <libenvpp/detail/environment.hpp>
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+using Catch::Matchers::ContainsSubstring;
+
+namespace {
+
+struct port {
+	int value;
+};
+
+} // namespace
+
+template <>
+struct default_parser<port> {
+	[[nodiscard]] port operator()(const std::string_view str) const { return {default_parser<int>{}(str)}; }
+};
+
+template <>
+struct default_validator<port> {
+	void operator()(const port& p) const
+	{
+		if (p.value <= 0 || p.value > 65535) {
+			throw validation_error{"Port out of range"};
+		}
+	}
+};
+
+TEST_CASE("Parsing lists", "[libenvpp_list]")
+{
+	SECTION("Strings")
+	{
+		CHECK(list_parser<std::string>{}("a:1,b:2,c:3") == std::vector<std::string>{"a:1", "b:2", "c:3"});
+		CHECK(list_parser<std::string>{}(" a , b ") == std::vector<std::string>{"a", "b"});
+		CHECK(list_parser<std::string>{}("single") == std::vector<std::string>{"single"});
+		CHECK(list_parser<std::string>{}("").empty());
+	}
+
+	SECTION("Custom delimiter")
+	{
+		CHECK(list_parser<std::string, ':'>{}("/usr/bin:/bin") == std::vector<std::string>{"/usr/bin", "/bin"});
+		CHECK(list_parser<int, ';'>{}("1;2;3") == std::vector<int>{1, 2, 3});
+	}
+
+	SECTION("Integers and ranges")
+	{
+		CHECK(list_parser<int>{}("0,2,4-7") == std::vector<int>{0, 2, 4, 5, 6, 7});
+		CHECK(list_parser<int>{}("-3--1,5") == std::vector<int>{-3, -2, -1, 5});
+		CHECK(list_parser<int>{}("3-3") == std::vector<int>{3});
+		CHECK(list_parser<int>{}("1 - 2") == std::vector<int>{1, 2});
+		CHECK(list_parser<std::uint16_t>{}("65534-65535") == std::vector<std::uint16_t>{65534, 65535});
+		CHECK(list_parser<unsigned>{}("10") == std::vector<unsigned>{10});
+	}
+
+	SECTION("Other element types")
+	{
+		CHECK(list_parser<bool>{}("true,false") == std::vector<bool>{true, false});
+		CHECK(list_parser<double>{}("0.5,2") == std::vector<double>{0.5, 2.0});
+	}
+}
+
+TEST_CASE("Parsing ill-formed lists", "[libenvpp_list]")
+{
+	CHECK_THROWS_AS(list_parser<int>{}("1,x,3"), parser_error);
+	CHECK_THROWS_WITH(list_parser<int>{}("1,x,3"), ContainsSubstring("Element 1 'x'"));
+	CHECK_THROWS_WITH(list_parser<int>{}("1,2,"), ContainsSubstring("Element 2 ''"));
+	CHECK_THROWS_WITH(list_parser<int>{}("7-4"),
+	                  ContainsSubstring("Element 0 '7-4'") && ContainsSubstring("ends before"));
+	CHECK_THROWS_WITH(list_parser<int>{}("1-"), ContainsSubstring("Element 0"));
+	CHECK_THROWS_WITH(list_parser<int>{}("1,2a"), ContainsSubstring("Element 1 '2a'"));
+	CHECK_THROWS_WITH(list_parser<unsigned>{}("1,-1"), ContainsSubstring("Element 1 '-1'"));
+	CHECK_THROWS_WITH(list_parser<std::uint16_t>{}("65536"), ContainsSubstring("out of range"));
+	CHECK_THROWS_WITH(list_parser<bool>{}("true,maybe"), ContainsSubstring("Element 1 'maybe'"));
+}
+
+TEST_CASE("List size is limited", "[libenvpp_list]")
+{
+	CHECK(list_parser<int>{}("0-65535").size() == default_max_list_size);
+	CHECK_THROWS_WITH(list_parser<int>{}("1,0-65535"),
+	                  ContainsSubstring("Element 1 '0-65535'") && ContainsSubstring("exceed 65536 elements"));
+	CHECK_THROWS_WITH(list_parser<int>{}("-2147483648-2147483647"), ContainsSubstring("Element 0"));
+	CHECK_THROWS_WITH(list_parser<std::uint64_t>{}("0-18446744073709551615"), ContainsSubstring("Element 0"));
+
+	CHECK((list_parser<int, ',', 4>{}("1,2-4")) == std::vector<int>{1, 2, 3, 4});
+	CHECK_THROWS_WITH((list_parser<int, ',', 4>{}("1,2-4,5")),
+	                  ContainsSubstring("Element 2 '5'") && ContainsSubstring("more than 4 elements"));
+	CHECK_THROWS_WITH((list_parser<int, ',', 3>{}("1,2-4")), ContainsSubstring("Element 1 '2-4'"));
+	CHECK_THROWS_WITH((list_parser<std::string, ',', 2>{}("a,b,c")), ContainsSubstring("Element 2 'c'"));
+}
+
+TEST_CASE("List variables", "[libenvpp_list]")
+{
+	auto pre = prefix("MYPROG");
+	const auto peers_id = pre.register_variable<std::vector<std::string>>("PEERS");
+	const auto cpu_set_id = pre.register_required_variable<std::vector<int>>("CPU_SET");
+	const auto path_id = pre.register_variable<std::vector<std::string>>("PATH", list_parser<std::string, ':'>{});
+
+	SECTION("Well-formed")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate(
+		    {{"MYPROG_PEERS", "a:1,b:2,c:3"}, {"MYPROG_CPU_SET", "0,2,4-7"}, {"MYPROG_PATH", "/a:/b"}});
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(peers_id) == std::vector<std::string>{"a:1", "b:2", "c:3"});
+		CHECK(parsed_and_validated_pre.get(cpu_set_id) == std::vector<int>{0, 2, 4, 5, 6, 7});
+		CHECK(parsed_and_validated_pre.get(path_id) == std::vector<std::string>{"/a", "/b"});
+	}
+
+	SECTION("Ill-formed")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({{"MYPROG_CPU_SET", "0,2,four"}});
+		REQUIRE_FALSE(parsed_and_validated_pre.ok());
+		REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+		CHECK(parsed_and_validated_pre.errors()[0].kind() == error_kind::parser);
+		CHECK_THAT(parsed_and_validated_pre.error_message(), ContainsSubstring("Element 2 'four'"));
+	}
+}
+
+TEST_CASE("List elements are validated", "[libenvpp_list]")
+{
+	auto pre = prefix("LIST");
+	const auto ports_id = pre.register_variable<std::vector<port>>("PORTS");
+
+	SECTION("Valid")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({{"LIST_PORTS", "80,443"}});
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(ports_id)->size() == 2);
+	}
+
+	SECTION("Invalid")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({{"LIST_PORTS", "80,0"}});
+		REQUIRE_FALSE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.errors()[0].kind() == error_kind::validation);
+		CHECK_THAT(parsed_and_validated_pre.error_message(), ContainsSubstring("Element 1 of list: Port out of range"));
+	}
+}
+
+TEST_CASE("Retrieving list with get", "[libenvpp_list][get]")
+{
+	const auto _ = detail::set_scoped_environment_variable{"LIBENVPP_TESTING_LIST", "1-3,5"};
+
+	const auto list = get<std::vector<int>>("LIBENVPP_TESTING_LIST");
+	REQUIRE(list.has_value());
+	CHECK(*list == std::vector<int>{1, 2, 3, 5});
+}
+
+} // namespace env
@@ -0,0 +1,103 @@
+#include <string>
+#include <unordered_map>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+#include <libenvpp/detail/environment.hpp>
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+using Catch::Matchers::ContainsSubstring;
+
+TEST_CASE("Parsing maps", "[libenvpp_map]")
+{
+	using string_map = std::unordered_map<std::string, std::string>;
+
+	SECTION("Strings")
+	{
+		CHECK(map_parser<std::string, std::string>{}("region=eu,tier=gold")
+		      == string_map{{"region", "eu"}, {"tier", "gold"}});
+		CHECK(map_parser<std::string, std::string>{}(" region = eu , tier=gold ")
+		      == string_map{{"region", "eu"}, {"tier", "gold"}});
+		CHECK(map_parser<std::string, std::string>{}("query=a=b") == string_map{{"query", "a=b"}});
+		CHECK(map_parser<std::string, std::string>{}("empty=") == string_map{{"empty", ""}});
+		CHECK(map_parser<std::string, std::string>{}("").empty());
+	}
+
+	SECTION("Custom delimiters")
+	{
+		CHECK(map_parser<std::string, int, ';', ':'>{}("a:1;b:2")
+		      == std::unordered_map<std::string, int>{{"a", 1}, {"b", 2}});
+	}
+
+	SECTION("Composes with default parser")
+	{
+		CHECK(map_parser<int, bool>{}("1=true,2=false") == std::unordered_map<int, bool>{{1, true}, {2, false}});
+		CHECK(map_parser<std::string, double>{}("ratio=0.5")
+		      == std::unordered_map<std::string, double>{{"ratio", 0.5}});
+	}
+
+	SECTION("Flat map")
+	{
+		const auto map = flat_map_parser<std::string, int>{}("c=3,a=1,b=2");
+		CHECK(map == flat_map<std::string, int>{{"a", 1}, {"b", 2}, {"c", 3}});
+		REQUIRE(flat_map_find(map, "b") != nullptr);
+		CHECK(*flat_map_find(map, "b") == 2);
+		CHECK(flat_map_find(map, std::string("d")) == nullptr);
+		CHECK(flat_map_find(map, "0") == nullptr);
+	}
+}
+
+TEST_CASE("Parsing ill-formed maps", "[libenvpp_map]")
+{
+	CHECK_THROWS_AS((map_parser<std::string, std::string>{}("a=1,b")), parser_error);
+	CHECK_THROWS_WITH((map_parser<std::string, std::string>{}("a=1,b")),
+	                  ContainsSubstring("Element 1 'b'") && ContainsSubstring("Missing '='"));
+	CHECK_THROWS_WITH((map_parser<std::string, int>{}("a=1,b=x")), ContainsSubstring("Element 1 'b=x'"));
+	CHECK_THROWS_WITH((map_parser<int, int>{}("a=1")), ContainsSubstring("Element 0 'a=1'"));
+	CHECK_THROWS_WITH((map_parser<std::string, std::string>{}("a=1,b=2,a=3")),
+	                  ContainsSubstring("Element 2 'a=3' of map: Duplicate key 'a'"));
+	CHECK_THROWS_WITH((flat_map_parser<std::string, std::string>{}("b=1,a=2,c=3,a=4")),
+	                  ContainsSubstring("Element 3 'a=4' of map: Duplicate key 'a'"));
+	CHECK_THROWS_WITH((flat_map_parser<std::string, int>{}("a=1,b=x")), ContainsSubstring("Element 1 'b=x'"));
+}
+
+TEST_CASE("Map variables", "[libenvpp_map]")
+{
+	auto pre = prefix("MYPROG");
+	const auto labels_id = pre.register_variable<std::unordered_map<std::string, std::string>>("LABELS");
+	const auto limits_id = pre.register_variable<flat_map<std::string, unsigned int>>(
+	    "LIMITS", flat_map_parser<std::string, unsigned int>{});
+
+	SECTION("Well-formed")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate(
+		    {{"MYPROG_LABELS", "region=eu,tier=gold"}, {"MYPROG_LIMITS", "tenant_b=5,tenant_a=10"}});
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(labels_id)
+		      == std::unordered_map<std::string, std::string>{{"region", "eu"}, {"tier", "gold"}});
+		CHECK(parsed_and_validated_pre.get(limits_id)
+		      == flat_map<std::string, unsigned int>{{"tenant_a", 10}, {"tenant_b", 5}});
+	}
+
+	SECTION("Duplicate key")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({{"MYPROG_LABELS", "region=eu,region=us"}});
+		REQUIRE_FALSE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.errors()[0].kind() == error_kind::parser);
+		CHECK_THAT(parsed_and_validated_pre.error_message(), ContainsSubstring("Duplicate key 'region'"));
+	}
+}
+
+TEST_CASE("Retrieving map with get", "[libenvpp_map][get]")
+{
+	const auto _ = detail::set_scoped_environment_variable{"LIBENVPP_TESTING_MAP", "a=1,b=2"};
+
+	const auto map = get<std::unordered_map<std::string, int>>("LIBENVPP_TESTING_MAP");
+	REQUIRE(map.has_value());
+	CHECK(*map == std::unordered_map<std::string, int>{{"a", 1}, {"b", 2}});
+}
+
+} // namespace env
@@ -0,0 +1,294 @@
+#include <any>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+#include <fmt/core.h>
+
+#include <libenvpp/detail/environment.hpp>
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+using Catch::Matchers::ContainsSubstring;
+
+namespace {
+
+[[nodiscard]] std::string format_parsed_address(const std::string_view str)
+{
+	return fmt::format("{}", default_parser<ip_address>{}(str));
+}
+
+template <typename T>
+[[nodiscard]] std::string cached_representation_of(const T& value)
+{
+	auto bytes = std::string();
+	detail::serialize_cached_value<T>(std::any(value), bytes);
+	return bytes;
+}
+
+template <typename T>
+[[nodiscard]] bool is_loaded_from_cache(const std::string& bytes)
+{
+	return detail::deserialize_cached_value<T>(bytes).has_value();
+}
+
+} // namespace
+
+TEST_CASE("Parsing IP addresses", "[libenvpp_network]")
+{
+	SECTION("IPv4")
+	{
+		const auto address = default_parser<ip_address>{}("10.0.0.5");
+		CHECK(address.is_v4());
+		CHECK(address == ip_address::v4({10, 0, 0, 5}));
+		CHECK(default_parser<ip_address>{}("0.0.0.0") == ip_address{});
+		CHECK(default_parser<ip_address>{}("255.255.255.255") == ip_address::v4({255, 255, 255, 255}));
+	}
+
+	SECTION("IPv6")
+	{
+		auto loopback = std::array<std::uint8_t, 16>{};
+		loopback[15] = 1;
+		CHECK(default_parser<ip_address>{}("::1") == ip_address::v6(loopback));
+		CHECK(default_parser<ip_address>{}("0:0:0:0:0:0:0:1") == ip_address::v6(loopback));
+		CHECK(default_parser<ip_address>{}("::") == ip_address::v6({}));
+
+		const auto address = default_parser<ip_address>{}("2001:DB8::ff00:42:8329");
+		CHECK(address.is_v6());
+		CHECK(address.bytes()[0] == 0x20);
+		CHECK(address.bytes()[1] == 0x01);
+		CHECK(address.bytes()[2] == 0x0d);
+		CHECK(address.bytes()[3] == 0xb8);
+		CHECK(address.bytes()[10] == 0xff);
+		CHECK(address.bytes()[15] == 0x29);
+
+		const auto mapped = default_parser<ip_address>{}("::ffff:10.0.0.5");
+		CHECK(mapped.bytes()[10] == 0xff);
+		CHECK(mapped.bytes()[11] == 0xff);
+		CHECK(mapped.bytes()[12] == 10);
+		CHECK(mapped.bytes()[15] == 5);
+	}
+
+	SECTION("Zone IDs")
+	{
+		const auto address = default_parser<ip_address>{}("fe80::1%eth0");
+		CHECK(address.zone_id() == "eth0");
+		CHECK(address != default_parser<ip_address>{}("fe80::1"));
+		CHECK(default_parser<ip_address>{}("fe80::1%3").zone_id() == "3");
+	}
+
+	SECTION("Ill-formed")
+	{
+		CHECK_THROWS_AS(default_parser<ip_address>{}(""), parser_error);
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("10.0.0.256"),
+		                  ContainsSubstring("Invalid IP address '10.0.0.256': Octets must be at most 255"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("10.0.0.1000"), ContainsSubstring("at most 255"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("10.0.0"), ContainsSubstring("4 decimal octets"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("10.0.0.5.6"), ContainsSubstring("4 decimal octets"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("10.0.0.05"), ContainsSubstring("leading zeros"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}(" 10.0.0.5"), ContainsSubstring("4 decimal octets"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("10.0.0.5%eth0"), ContainsSubstring("only supported for IPv6"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("1::2::3"), ContainsSubstring("'::' at most once"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("1:2:3:4:5:6:7"), ContainsSubstring("8 groups"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("1:2:3:4:5:6:7:8:9"), ContainsSubstring("more than 8 groups"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("1:2:3:4::5:6:7:8"), ContainsSubstring("more than 8 groups"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("12345::"), ContainsSubstring("at most 4 hexadecimal"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}(":1::"), ContainsSubstring("start with a single ':'"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("1::2:"), ContainsSubstring("end with a single ':'"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("1:::2"), ContainsSubstring("hexadecimal digits"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("::g"), ContainsSubstring("hexadecimal digits"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("::1.2.3"), ContainsSubstring("embedded IPv4"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("fe80::1%"), ContainsSubstring("must not be empty"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("fe80::1%a/b"), ContainsSubstring("must only contain"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("fe80::1%abcdefghijklmnopq"), ContainsSubstring("too long"));
+		CHECK_THROWS_WITH(default_parser<ip_address>{}("localhost"), ContainsSubstring("4 decimal octets"));
+	}
+}
+
+TEST_CASE("Formatting IP addresses", "[libenvpp_network]")
+{
+	CHECK(format_parsed_address("10.0.0.5") == "10.0.0.5");
+	CHECK(format_parsed_address("0:0:0:0:0:0:0:1") == "::1");
+	CHECK(format_parsed_address("::") == "::");
+	CHECK(format_parsed_address("2001:DB8:0:0:0:0:0:1") == "2001:db8::1");
+	CHECK(format_parsed_address("2001:db8:0:0:1:0:0:1") == "2001:db8::1:0:0:1");
+	CHECK(format_parsed_address("2001:db8:0:1:1:1:1:1") == "2001:db8:0:1:1:1:1:1");
+	CHECK(format_parsed_address("1:0:0:0:0:0:0:0") == "1::");
+	CHECK(format_parsed_address("0:0:0:0:0:ffff:a00:5") == "::ffff:10.0.0.5");
+	CHECK(format_parsed_address("fe80::1%eth0") == "fe80::1%eth0");
+	CHECK(format_parsed_address("1:ffff:ffff:ffff:ffff:ffff:ffff:ffff") == "1:ffff:ffff:ffff:ffff:ffff:ffff:ffff");
+}
+
+TEST_CASE("Parsing CIDR networks", "[libenvpp_network]")
+{
+	SECTION("Well-formed")
+	{
+		const auto network = default_parser<cidr>{}("10.1.2.3/8");
+		CHECK(network.address() == ip_address::v4({10, 1, 2, 3}));
+		CHECK(network.prefix_length() == 8);
+		CHECK(network.network() == ip_address::v4({10, 0, 0, 0}));
+		CHECK(network.contains(ip_address::v4({10, 255, 0, 1})));
+		CHECK_FALSE(network.contains(ip_address::v4({11, 0, 0, 1})));
+		CHECK(fmt::format("{}", network) == "10.1.2.3/8");
+
+		const auto v6_network = default_parser<cidr>{}("fd00::/60");
+		CHECK(v6_network.contains(default_parser<ip_address>{}("fd00:0:0:f::1")));
+		CHECK_FALSE(v6_network.contains(default_parser<ip_address>{}("fd00:0:0:10::1")));
+		CHECK_FALSE(v6_network.contains(ip_address::v4({10, 0, 0, 1})));
+
+		CHECK(default_parser<cidr>{}("0.0.0.0/0").contains(ip_address::v4({192, 168, 1, 1})));
+		CHECK(default_parser<cidr>{}("192.168.1.1/32").contains(ip_address::v4({192, 168, 1, 1})));
+		CHECK_FALSE(default_parser<cidr>{}("192.168.1.1/32").contains(ip_address::v4({192, 168, 1, 2})));
+		CHECK(default_parser<cidr>{}("192.168.1.0/23").network() == ip_address::v4({192, 168, 0, 0}));
+	}
+
+	SECTION("Ill-formed")
+	{
+		CHECK_THROWS_WITH(default_parser<cidr>{}("10.0.0.0"),
+		                  ContainsSubstring("Invalid CIDR '10.0.0.0': Missing prefix length"));
+		CHECK_THROWS_WITH(default_parser<cidr>{}("10.0.0.0/33"), ContainsSubstring("from 0 to 32"));
+		CHECK_THROWS_WITH(default_parser<cidr>{}("::/129"), ContainsSubstring("from 0 to 128"));
+		CHECK_THROWS_WITH(default_parser<cidr>{}("10.0.0.0/"), ContainsSubstring("Prefix length"));
+		CHECK_THROWS_WITH(default_parser<cidr>{}("10.0.0.0/08"), ContainsSubstring("Prefix length"));
+		CHECK_THROWS_WITH(default_parser<cidr>{}("10.0.0/8"), ContainsSubstring("4 decimal octets"));
+		CHECK_THROWS_WITH(default_parser<cidr>{}("fe80::%eth0/64"), ContainsSubstring("zone ID"));
+	}
+}
+
+TEST_CASE("Parsing endpoints", "[libenvpp_network]")
+{
+	SECTION("Well-formed")
+	{
+		const auto upstream = default_parser<endpoint>{}("10.0.0.5:9000");
+		CHECK(upstream.address() == ip_address::v4({10, 0, 0, 5}));
+		CHECK(upstream.port() == 9000);
+
+		const auto listen = default_parser<endpoint>{}("[::1]:8443");
+		CHECK(listen.address() == default_parser<ip_address>{}("::1"));
+		CHECK(listen.port() == 8443);
+
+		const auto scoped = default_parser<endpoint>{}("[fe80::1%eth0]:80");
+		CHECK(scoped.address().zone_id() == "eth0");
+
+		CHECK(default_parser<endpoint>{}("0.0.0.0:0").port() == 0);
+		CHECK(default_parser<endpoint>{}("0.0.0.0:65535").port() == 65535);
+		CHECK(fmt::format("{}", upstream) == "10.0.0.5:9000");
+		CHECK(fmt::format("{}", scoped) == "[fe80::1%eth0]:80");
+	}
+
+	SECTION("Ill-formed")
+	{
+		CHECK_THROWS_WITH(default_parser<endpoint>{}("10.0.0.5"), ContainsSubstring("Missing port"));
+		CHECK_THROWS_WITH(default_parser<endpoint>{}("10.0.0.5:"), ContainsSubstring("Missing port"));
+		CHECK_THROWS_WITH(default_parser<endpoint>{}("[::1]"), ContainsSubstring("Missing port"));
+		CHECK_THROWS_WITH(default_parser<endpoint>{}("10.0.0.5:65536"), ContainsSubstring("from 0 to 65535"));
+		CHECK_THROWS_WITH(default_parser<endpoint>{}("10.0.0.5:http"), ContainsSubstring("from 0 to 65535"));
+		CHECK_THROWS_WITH(default_parser<endpoint>{}("::1:8443"), ContainsSubstring("enclosed in brackets"));
+		CHECK_THROWS_WITH(default_parser<endpoint>{}("[::1:8443"), ContainsSubstring("Missing ']'"));
+		CHECK_THROWS_WITH(default_parser<endpoint>{}("[::1]8443"), ContainsSubstring("Expected ':' after ']'"));
+		CHECK_THROWS_WITH(default_parser<endpoint>{}("[10.0.0.5]:80"), ContainsSubstring("Only IPv6"));
+		CHECK_THROWS_WITH(default_parser<endpoint>{}("localhost:80"),
+		                  ContainsSubstring("Invalid endpoint 'localhost:80': Host names are not resolved"));
+		CHECK_THROWS_WITH(default_parser<endpoint>{}("db.internal:5432"), ContainsSubstring("Host names"));
+	}
+}
+
+TEST_CASE("Network variables", "[libenvpp_network]")
+{
+	auto pre = prefix("MYPROG");
+	const auto listen_id = pre.register_required_variable<endpoint>("LISTEN");
+	const auto allowed_id = pre.register_variable<std::vector<cidr>>("ALLOWED");
+	const auto upstream_id =
+	    pre.register_range<endpoint>("UPSTREAM", endpoint{ip_address::v4({10, 0, 0, 5}), 9000},
+	                                 endpoint{ip_address::v4({10, 0, 0, 5}), 9099});
+
+	SECTION("Well-formed")
+	{
+		const auto parsed_and_validated_pre =
+		    pre.parse_and_validate({{"MYPROG_LISTEN", "[::1]:8443"},
+		                            {"MYPROG_ALLOWED", "10.0.0.0/8, fd00::/8"},
+		                            {"MYPROG_UPSTREAM", "10.0.0.5:9010"}});
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(listen_id).port() == 8443);
+		const auto allowed = parsed_and_validated_pre.get(allowed_id);
+		REQUIRE(allowed.has_value());
+		REQUIRE(allowed->size() == 2);
+		CHECK((*allowed)[1].address().is_v6());
+		CHECK(parsed_and_validated_pre.get(upstream_id) == endpoint{ip_address::v4({10, 0, 0, 5}), 9010});
+	}
+
+	SECTION("Out of range")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate(
+		    {{"MYPROG_LISTEN", "0.0.0.0:80"}, {"MYPROG_UPSTREAM", "10.0.0.5:8080"}});
+		REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+		CHECK(parsed_and_validated_pre.errors()[0].kind() == error_kind::range);
+		CHECK_THAT(parsed_and_validated_pre.error_message(),
+		           ContainsSubstring("Value 10.0.0.5:8080 outside of range [10.0.0.5:9000, 10.0.0.5:9099]"));
+	}
+
+	SECTION("Ill-formed")
+	{
+		const auto parsed_and_validated_pre =
+		    pre.parse_and_validate({{"MYPROG_LISTEN", "localhost:80"}, {"MYPROG_ALLOWED", "10.0.0.0/8,10.0.0.0"}});
+		REQUIRE(parsed_and_validated_pre.errors().size() == 2);
+		CHECK(parsed_and_validated_pre.errors()[0].kind() == error_kind::parser);
+		CHECK_THAT(parsed_and_validated_pre.error_message(),
+		           ContainsSubstring("Host names are not resolved") && ContainsSubstring("Missing prefix length"));
+	}
+}
+
+TEST_CASE("Cached network values are checked", "[libenvpp_network]")
+{
+	static_assert(detail::is_cacheable_v<ip_address>);
+	static_assert(detail::is_cacheable_v<cidr>);
+	static_assert(detail::is_cacheable_v<endpoint>);
+
+	// The zone ID size and the family are the last two bytes of an address.
+	const auto zone_id_size_offset = sizeof(ip_address) - 2;
+	const auto family_offset = sizeof(ip_address) - 1;
+
+	const auto scoped_address = default_parser<ip_address>{}("fe80::1%eth0");
+	auto bytes = cached_representation_of(scoped_address);
+	const auto loaded = detail::deserialize_cached_value<ip_address>(bytes);
+	REQUIRE(loaded.has_value());
+	CHECK(std::any_cast<ip_address>(*loaded) == scoped_address);
+
+	bytes[zone_id_size_offset] = static_cast<char>(ip_address::MAX_ZONE_ID_SIZE + 1);
+	CHECK_FALSE(is_loaded_from_cache<ip_address>(bytes));
+
+	bytes = cached_representation_of(scoped_address);
+	bytes[family_offset] = 2;
+	CHECK_FALSE(is_loaded_from_cache<ip_address>(bytes));
+
+	bytes = cached_representation_of(ip_address::v4({10, 0, 0, 5}));
+	CHECK(is_loaded_from_cache<ip_address>(bytes));
+	bytes[4] = 1;
+	CHECK_FALSE(is_loaded_from_cache<ip_address>(bytes));
+
+	bytes = cached_representation_of(default_parser<cidr>{}("10.0.0.0/8"));
+	CHECK(is_loaded_from_cache<cidr>(bytes));
+	bytes[sizeof(ip_address)] = 33;
+	CHECK_FALSE(is_loaded_from_cache<cidr>(bytes));
+
+	bytes = cached_representation_of(default_parser<endpoint>{}("[::1]:8443"));
+	CHECK(is_loaded_from_cache<endpoint>(bytes));
+	bytes[zone_id_size_offset] = static_cast<char>(0xff);
+	CHECK_FALSE(is_loaded_from_cache<endpoint>(bytes));
+}
+
+TEST_CASE("Retrieving endpoint with get", "[libenvpp_network][get]")
+{
+	const auto _ = detail::set_scoped_environment_variable{"LIBENVPP_TESTING_ENDPOINT", "[::1]:8443"};
+
+	const auto upstream = get<endpoint>("LIBENVPP_TESTING_ENDPOINT");
+	REQUIRE(upstream.has_value());
+	CHECK(upstream->port() == 8443);
+}
+
+} // namespace env
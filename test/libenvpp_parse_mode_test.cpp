@@ -0,0 +1,169 @@
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+using Catch::Matchers::ContainsSubstring;
+
+namespace {
+
+// Parser counting its invocations, to check which variables were parsed.
+struct counting_parser {
+	int operator()(const std::string_view str) const
+	{
+		++*m_count;
+		return default_parser<int>{}(str);
+	}
+
+	std::shared_ptr<int> m_count;
+};
+
+} // namespace
+
+TEST_CASE("Parse modes", "[libenvpp_parse_mode]")
+{
+	CHECK_FALSE(collect_all.is_budgeted());
+	CHECK(fail_fast.error_budget() == 1);
+	CHECK(max_errors(3).error_budget() == 3);
+	CHECK(max_errors(0).error_budget() == 1);
+}
+
+TEST_CASE("Parse modes stop once the error budget is spent", "[libenvpp_parse_mode]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{
+	    {"BUDGET_FIRST", "abc"},    {"BUDGET_SECOND", "1"}, {"BUDGET_THIRD", "def"},
+	    {"BUDGET_FOURTH", "ghi"},   {"BUDGET_FIFTH", "5"},  {"BUDGET_UNUSED", "unused"},
+	    {"BUDGET_OPTINAL", "typo"},
+	};
+	const auto count = std::make_shared<int>(0);
+	auto pre = prefix("BUDGET");
+	[[maybe_unused]] const auto first_id = pre.register_variable<int>("FIRST", counting_parser{count});
+	const auto second_id = pre.register_variable<int>("SECOND", counting_parser{count});
+	[[maybe_unused]] const auto third_id = pre.register_variable<int>("THIRD", counting_parser{count});
+	[[maybe_unused]] const auto fourth_id = pre.register_variable<int>("FOURTH", counting_parser{count});
+	const auto fifth_id = pre.register_variable<int>("FIFTH", counting_parser{count});
+	[[maybe_unused]] const auto optional_id = pre.register_variable<int>("OPTIONAL", counting_parser{count});
+
+	SECTION("Collect all")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate(environment);
+		CHECK(*count == 5);
+		CHECK(parsed_and_validated_pre.errors().size() == 3);
+		CHECK(parsed_and_validated_pre.warnings().size() == 2);
+		CHECK(parsed_and_validated_pre.get(fifth_id) == 5);
+	}
+
+	SECTION("Fail fast")
+	{
+		pre.set_parse_mode(fail_fast);
+		const auto parsed_and_validated_pre = pre.parse_and_validate(environment);
+		CHECK(*count == 1);
+		REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+		CHECK_THAT(parsed_and_validated_pre.errors()[0].what(), ContainsSubstring("BUDGET_FIRST"));
+		CHECK(parsed_and_validated_pre.warnings().empty());
+		CHECK_FALSE(parsed_and_validated_pre.get(second_id).has_value());
+	}
+
+	SECTION("Maximum number of errors")
+	{
+		pre.set_parse_mode(max_errors(2));
+		const auto parsed_and_validated_pre = pre.parse_and_validate(environment);
+		CHECK(*count == 3);
+		REQUIRE(parsed_and_validated_pre.errors().size() == 2);
+		CHECK_THAT(parsed_and_validated_pre.errors()[1].what(), ContainsSubstring("BUDGET_THIRD"));
+		CHECK(parsed_and_validated_pre.warnings().empty());
+		CHECK(parsed_and_validated_pre.get(second_id) == 1);
+		CHECK_FALSE(parsed_and_validated_pre.get(fifth_id).has_value());
+	}
+
+	SECTION("Error budget which is not spent")
+	{
+		pre.set_parse_mode(max_errors(4));
+		const auto parsed_and_validated_pre = pre.parse_and_validate(environment);
+		CHECK(*count == 5);
+		CHECK(parsed_and_validated_pre.errors().size() == 3);
+		CHECK(parsed_and_validated_pre.warnings().empty());
+		CHECK(parsed_and_validated_pre.get(fifth_id) == 5);
+	}
+}
+
+TEST_CASE("Parse modes skip typo detection of missing required variables", "[libenvpp_parse_mode]")
+{
+	const auto count = std::make_shared<int>(0);
+	auto pre = prefix("MISSING");
+	[[maybe_unused]] const auto required_id = pre.register_required_variable<int>("REQUIRED");
+	[[maybe_unused]] const auto other_id = pre.register_variable<int>("OTHER", counting_parser{count});
+	const auto environment = std::unordered_map<std::string, std::string>{
+	    {"MISSING_REQUIRD", "1"},
+	    {"MISSING_OTHER", "2"},
+	};
+
+	SECTION("Collect all")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate(environment);
+		REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+		CHECK_THAT(parsed_and_validated_pre.errors()[0].what(), ContainsSubstring("MISSING_REQUIRD"));
+		CHECK(*count == 1);
+	}
+
+	SECTION("Fail fast")
+	{
+		pre.set_parse_mode(fail_fast);
+		const auto parsed_and_validated_pre = pre.parse_and_validate(environment);
+		REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+		CHECK(parsed_and_validated_pre.errors()[0].what() == "Environment variable 'MISSING_REQUIRED' not set");
+		CHECK(parsed_and_validated_pre.warnings().empty());
+		CHECK(*count == 0);
+	}
+}
+
+TEST_CASE("Parse modes without errors report warnings", "[libenvpp_parse_mode]")
+{
+	auto pre = prefix("WITHOUT_ERRORS");
+	const auto int_id = pre.register_variable<int>("INT");
+	pre.set_parse_mode(fail_fast);
+	const auto parsed_and_validated_pre =
+	    pre.parse_and_validate({{"WITHOUT_ERRORS_INT", "1"}, {"WITHOUT_ERRORS_UNUSED", "unused"}});
+	CHECK(parsed_and_validated_pre.errors().empty());
+	CHECK(parsed_and_validated_pre.warnings().size() == 1);
+	CHECK(parsed_and_validated_pre.get(int_id) == 1);
+}
+
+TEST_CASE("Parse modes on an executor yield the same result as parsing sequentially", "[libenvpp_parse_mode]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{
+	    {"EXECUTOR_BUDGET_FIRST", "1"}, {"EXECUTOR_BUDGET_SECOND", "abc"},
+	    {"EXECUTOR_BUDGET_THIRD", "3"}, {"EXECUTOR_BUDGET_FIFTH", "def"},
+	    {"EXECUTOR_BUDGET_SIXTH", "6"},
+	};
+	const auto parse = [&](const parse_mode mode, executor* exec) {
+		auto pre = prefix("EXECUTOR_BUDGET");
+		const auto first_id = pre.register_variable<int>("FIRST");
+		[[maybe_unused]] const auto second_id = pre.register_variable<int>("SECOND");
+		const auto third_id = pre.register_variable<int>("THIRD");
+		[[maybe_unused]] const auto fourth_id = pre.register_required_variable<int>("FOURTH");
+		[[maybe_unused]] const auto fifth_id = pre.register_variable<int>("FIFTH");
+		const auto sixth_id = pre.register_variable<int>("SIXTH");
+		pre.set_parse_mode(mode);
+		const auto parsed_and_validated_pre =
+		    exec ? pre.parse_and_validate(*exec, environment) : pre.parse_and_validate(environment);
+		CHECK(parsed_and_validated_pre.get(first_id) == 1);
+		CHECK(parsed_and_validated_pre.get(third_id).has_value() == (mode.error_budget() > 1));
+		CHECK(parsed_and_validated_pre.get(sixth_id).has_value() == (mode.error_budget() > 3));
+		return parsed_and_validated_pre.error_message();
+	};
+
+	auto pool = thread_pool(4);
+	for (const auto mode : {fail_fast, max_errors(2), max_errors(3), collect_all}) {
+		CHECK(parse(mode, &pool) == parse(mode, nullptr));
+	}
+}
+
+} // namespace env
@@ -1,3 +1,9 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <random>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -184,6 +190,9 @@ TEST_CASE("Parsing well-formed input of built-in type", "[libenvpp_parser]")
 		test_parser<bool>("Yes", true);
 		test_parser<bool>("NO", false);
 		test_parser<bool>("YES", true);
+		test_parser<bool>("+1", true);
+		test_parser<bool>("-0", false);
+		test_parser<bool>("0001", true);
 
 		test_parser<char>("0", '0');
 		test_parser<char>("a", 'a');
@@ -235,6 +244,10 @@ TEST_CASE("Parsing well-formed input of built-in type", "[libenvpp_parser]")
 		test_parser<double>("-0.1234567890123456789", -0.1234567890123456789);
 		test_parser<double>("1234567890.0123456789", 1234567890.0123456789);
 		test_parser<double>("-1234567890.0123456789", -1234567890.0123456789);
+		test_parser<double>("+1.5", 1.5);
+		test_parser<double>("1.", 1.0);
+		test_parser<double>("2.5e-3", 2.5e-3);
+		test_parser<double>("1E300", 1e300);
 
 		test_parser<std::string>("", "");
 	}
@@ -251,6 +264,7 @@ TEST_CASE("Parsing well-formed input of built-in type", "[libenvpp_parser]")
 		test_parser<bool>("0 ", false);
 		test_parser<bool>(" TrUe ", true);
 		test_parser<bool>(" \r \t \n oFf \r \t \n ", false);
+		test_parser<bool>("\v\fyEs\f\v", true);
 		test_parser<char>("a ", 'a');
 		test_parser<short>(" -12345 ", -12345);
 		test_parser<unsigned short>("\t65000", 65000);
@@ -306,6 +320,13 @@ TEST_CASE("Parsing ill-formed input of primitive type", "[libenvpp_parser]")
 	test_parser_error<bool>("2");
 	test_parser_error<bool>("yas");
 	test_parser_error<bool>("nope");
+	test_parser_error<bool>("+");
+	test_parser_error<bool>("-");
+	test_parser_error<bool>("1x");
+	test_parser_error<bool>("10");
+	test_parser_error<bool>("truex");
+	test_parser_error<bool>("true x");
+	test_parser_error<bool>("falsehood");
 
 	test_parser_error<short>("");
 	test_parser_error<short>(" ");
@@ -328,8 +349,113 @@ TEST_CASE("Parsing ill-formed input of primitive type", "[libenvpp_parser]")
 	test_parser_error<unsigned long long>("123456789012345678901");
 
 	test_parser_error<float>("a");
+	test_parser_error<float>("1e39");
 
 	test_parser_error<double>("b");
+	test_parser_error<double>("");
+	test_parser_error<double>(".");
+	test_parser_error<double>("1.5.2");
+	test_parser_error<double>("1,5");
+	test_parser_error<double>("1e");
+	test_parser_error<double>("--1");
+	test_parser_error<double>("+-1");
+	test_parser_error<double>("1e999");
+	test_parser_error<double>("inf");
+	test_parser_error<double>("nan");
+	test_parser_error<double>("0x1p3");
+}
+
+TEST_CASE("Parsing floating point numbers with extended syntax", "[libenvpp_parser]")
+{
+	using extended_parser = float_parser<double, float_syntax::extended>;
+
+	CHECK(extended_parser{}("0x1.8p3") == 12.0);
+	CHECK(extended_parser{}(" -0X1P-2 ") == -0.25);
+	CHECK(extended_parser{}("0xff") == 255.0);
+	CHECK(extended_parser{}("1.5") == 1.5);
+	CHECK(extended_parser{}("inf") == std::numeric_limits<double>::infinity());
+	CHECK(extended_parser{}("-Infinity") == -std::numeric_limits<double>::infinity());
+	CHECK(std::isnan(extended_parser{}("NaN")));
+	CHECK(std::isnan(float_parser<float, float_syntax::extended>{}("nan")));
+
+	CHECK_THROWS_AS(extended_parser{}("0x"), parser_error);
+	CHECK_THROWS_AS(extended_parser{}("0x-1"), parser_error);
+	CHECK_THROWS_AS(extended_parser{}("0x1g"), parser_error);
+	CHECK_THROWS_AS(extended_parser{}("infinit"), parser_error);
+	CHECK_THROWS_AS(float_parser<double>{}("0x1p3"), parser_error);
+	CHECK_THROWS_WITH(float_parser<float>{}("1e39"), ContainsSubstring("out of range"));
+}
+
+namespace {
+
+struct decimal_comma : std::numpunct<char> {
+	char do_decimal_point() const override { return ','; }
+};
+
+class scoped_global_locale {
+  public:
+	explicit scoped_global_locale(const std::locale& locale) : m_previous(std::locale::global(locale)) {}
+	~scoped_global_locale() { std::locale::global(m_previous); }
+
+	scoped_global_locale(const scoped_global_locale&) = delete;
+	scoped_global_locale& operator=(const scoped_global_locale&) = delete;
+
+  private:
+	std::locale m_previous;
+};
+
+template <typename T>
+[[nodiscard]] bool round_trips(const T value)
+{
+	const auto parsed = construct_from_string<T>(fmt::format("{}", value));
+	return std::memcmp(&parsed, &value, sizeof(T)) == 0;
+}
+
+template <typename T, typename Bits>
+void check_random_round_trips(std::mt19937_64& random)
+{
+	for (auto i = 0; i < 10'000; ++i) {
+		const auto bits = static_cast<Bits>(random());
+		auto value = T{};
+		std::memcpy(&value, &bits, sizeof(T));
+		if (std::isfinite(value) && !round_trips(value)) {
+			FAIL_CHECK(fmt::format("{} does not round-trip", value));
+		}
+	}
+}
+
+} // namespace
+
+TEST_CASE("Parsing floating point numbers independent of the locale", "[libenvpp_parser]")
+{
+	const auto _ = scoped_global_locale{std::locale(std::locale::classic(), new decimal_comma)};
+
+	test_parser<double>("1.5", 1.5);
+	test_parser<float>(" -0.25 ", -0.25f);
+	test_parser_error<double>("1,5");
+}
+
+TEST_CASE("Floating point numbers round-trip through fmt", "[libenvpp_parser]")
+{
+	CHECK(round_trips(0.0));
+	CHECK(round_trips(-0.0));
+	CHECK(round_trips(0.1));
+	CHECK(round_trips(std::numeric_limits<double>::max()));
+	CHECK(round_trips(std::numeric_limits<double>::lowest()));
+	CHECK(round_trips(std::numeric_limits<double>::min()));
+	CHECK(round_trips(std::numeric_limits<double>::denorm_min()));
+	CHECK(round_trips(std::numeric_limits<float>::max()));
+	CHECK(round_trips(std::numeric_limits<float>::denorm_min()));
+
+	auto random = std::mt19937_64{42};
+	check_random_round_trips<double, std::uint64_t>(random);
+	check_random_round_trips<float, std::uint32_t>(random);
+
+	using extended_parser = float_parser<double, float_syntax::extended>;
+	const auto infinity = std::numeric_limits<double>::infinity();
+	CHECK(extended_parser{}(fmt::format("{}", infinity)) == infinity);
+	CHECK(extended_parser{}(fmt::format("{}", -infinity)) == -infinity);
+	CHECK(std::isnan(extended_parser{}(fmt::format("{}", std::numeric_limits<double>::quiet_NaN()))));
 }
 
 struct not_string_constructible_0 {
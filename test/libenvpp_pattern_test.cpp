@@ -0,0 +1,137 @@
+#include <string>
+#include <string_view>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+#include <libenvpp/detail/pattern.hpp>
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+using Catch::Matchers::ContainsSubstring;
+using detail::compiled_pattern;
+
+TEST_CASE("Matching patterns", "[libenvpp_pattern]")
+{
+	SECTION("Literals and wildcards")
+	{
+		const auto pattern = compiled_pattern("ab.d");
+		CHECK(pattern.matches("abcd"));
+		CHECK(pattern.matches("ab-d"));
+		CHECK_FALSE(pattern.matches("ab\nd"));
+		CHECK_FALSE(pattern.matches("abc"));
+		CHECK_FALSE(pattern.matches("abcde"));
+		CHECK(compiled_pattern("").matches(""));
+		CHECK_FALSE(compiled_pattern("").matches("a"));
+		CHECK(compiled_pattern("a\\.b\\*").matches("a.b*"));
+		CHECK_FALSE(compiled_pattern("a\\.b").matches("axb"));
+	}
+
+	SECTION("Character classes")
+	{
+		CHECK(compiled_pattern("[a-c_]+").matches("abc_cba"));
+		CHECK_FALSE(compiled_pattern("[a-c_]+").matches("abcd"));
+		CHECK(compiled_pattern("[^0-9]*").matches("abc"));
+		CHECK_FALSE(compiled_pattern("[^0-9]*").matches("ab1"));
+		CHECK(compiled_pattern("[]a-]+").matches("]-a"));
+		CHECK(compiled_pattern("[\\d.]+").matches("1.2.3"));
+		CHECK(compiled_pattern("\\d\\w\\s\\D\\W\\S").matches("1a a!b"));
+		CHECK(compiled_pattern("[\\]]").matches("]"));
+	}
+
+	SECTION("Repetition and alternation")
+	{
+		CHECK(compiled_pattern("ab*c").matches("ac"));
+		CHECK(compiled_pattern("ab*c").matches("abbbc"));
+		CHECK_FALSE(compiled_pattern("ab+c").matches("ac"));
+		CHECK(compiled_pattern("ab?c").matches("abc"));
+		CHECK_FALSE(compiled_pattern("ab?c").matches("abbc"));
+		CHECK(compiled_pattern("a{3}").matches("aaa"));
+		CHECK_FALSE(compiled_pattern("a{3}").matches("aa"));
+		CHECK(compiled_pattern("a{2,}").matches("aaaaa"));
+		CHECK_FALSE(compiled_pattern("a{2,}").matches("a"));
+		CHECK(compiled_pattern("a{1,3}").matches("aaa"));
+		CHECK_FALSE(compiled_pattern("a{1,3}").matches("aaaa"));
+		CHECK(compiled_pattern("cat|dog").matches("dog"));
+		CHECK_FALSE(compiled_pattern("cat|dog").matches("cog"));
+		CHECK(compiled_pattern("(ab|cd)+").matches("abcdab"));
+		CHECK(compiled_pattern("(?:ab)*").matches(""));
+		CHECK(compiled_pattern("^a|b$").matches("b"));
+		CHECK(compiled_pattern("()").matches(""));
+	}
+
+	SECTION("Real world patterns")
+	{
+		const auto label = std::string("[a-z0-9]([a-z0-9-]{0,61}[a-z0-9])?");
+		const auto hostname = compiled_pattern(label + "(\\." + label + ")*");
+		CHECK(hostname.matches("db-1.internal.example.com"));
+		CHECK_FALSE(hostname.matches("-db.example.com"));
+		CHECK_FALSE(hostname.matches("db..example.com"));
+
+		const auto arn = compiled_pattern("arn:aws:[a-z0-9-]+:[a-z0-9-]*:\\d{12}:.+");
+		CHECK(arn.matches("arn:aws:s3:eu-west-1:123456789012:bucket/key"));
+		CHECK_FALSE(arn.matches("arn:aws:s3:eu-west-1:12345:bucket/key"));
+	}
+}
+
+TEST_CASE("Pattern mismatch offset", "[libenvpp_pattern]")
+{
+	const auto pattern = compiled_pattern("tenant-\\d{4}");
+	CHECK(pattern.find_mismatch("tenant-1234") == compiled_pattern::NO_MISMATCH);
+	CHECK(pattern.find_mismatch("tenant-12a4") == 9);
+	CHECK(pattern.find_mismatch("tenent-1234") == 3);
+	CHECK(pattern.find_mismatch("tenant-123") == 10);
+	CHECK(pattern.find_mismatch("tenant-12345") == 11);
+	CHECK(pattern.find_mismatch("") == 0);
+}
+
+TEST_CASE("Invalid patterns", "[libenvpp_pattern]")
+{
+	CHECK_THROWS_AS(compiled_pattern("(ab"), invalid_pattern);
+	CHECK_THROWS_WITH(compiled_pattern("(ab"), ContainsSubstring("at offset 3: Missing ')'"));
+	CHECK_THROWS_WITH(compiled_pattern("ab)"), ContainsSubstring("at offset 2: Unmatched ')'"));
+	CHECK_THROWS_WITH(compiled_pattern("[ab"), ContainsSubstring("Missing ']'"));
+	CHECK_THROWS_WITH(compiled_pattern("*a"), ContainsSubstring("at offset 0: Nothing to repeat"));
+	CHECK_THROWS_WITH(compiled_pattern("a{2"), ContainsSubstring("Missing '}'"));
+	CHECK_THROWS_WITH(compiled_pattern("a{3,2}"), ContainsSubstring("Invalid repetition count"));
+	CHECK_THROWS_WITH(compiled_pattern("a{256}"), ContainsSubstring("Repetition count too large"));
+	CHECK_THROWS_WITH(compiled_pattern("[z-a]"), ContainsSubstring("Invalid character range"));
+	CHECK_THROWS_WITH(compiled_pattern("\\q"), ContainsSubstring("at offset 1: Unknown escape sequence"));
+	CHECK_THROWS_WITH(compiled_pattern("a\\"), ContainsSubstring("Trailing '\\'"));
+	CHECK_THROWS_WITH(compiled_pattern("[ab]*a[ab]{20}"), ContainsSubstring("more than 4096 states"));
+}
+
+TEST_CASE("Pattern variables", "[libenvpp_pattern]")
+{
+	auto pre = prefix("MYPROG");
+	const auto tenant_id = pre.register_required_pattern("TENANT", "tenant-\\d{4}");
+	const auto shard_id = pre.register_pattern<int>("SHARD", "[1-9]\\d?");
+
+	SECTION("Matching")
+	{
+		const auto parsed_and_validated_pre =
+		    pre.parse_and_validate({{"MYPROG_TENANT", "tenant-0042"}, {"MYPROG_SHARD", "12"}});
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(tenant_id) == "tenant-0042");
+		CHECK(parsed_and_validated_pre.get(shard_id) == 12);
+	}
+
+	SECTION("Not matching")
+	{
+		const auto parsed_and_validated_pre =
+		    pre.parse_and_validate({{"MYPROG_TENANT", "tenant-42x"}, {"MYPROG_SHARD", "012"}});
+		REQUIRE(parsed_and_validated_pre.errors().size() == 2);
+		CHECK(parsed_and_validated_pre.errors()[0].kind() == error_kind::validation);
+		CHECK_THAT(parsed_and_validated_pre.errors()[0].what(),
+		           ContainsSubstring("Value 'tenant-42x' does not match pattern 'tenant-\\d{4}' at offset 9"));
+		CHECK_THAT(parsed_and_validated_pre.errors()[1].what(), ContainsSubstring("at offset 0"));
+	}
+
+	SECTION("Invalid pattern")
+	{
+		CHECK_THROWS_WITH(pre.register_pattern("INVALID", "[a-"), ContainsSubstring("for 'MYPROG_INVALID'"));
+	}
+}
+
+} // namespace env
@@ -0,0 +1,69 @@
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include <libenvpp/detail/perfect_hash.hpp>
+
+namespace env::detail {
+
+namespace {
+
+constexpr auto schema = perfect_hash_table<5>({
+    "LIBENVPP_TESTING_LOG_FILE_PATH",
+    "LIBENVPP_TESTING_NUM_THREADS",
+    "LIBENVPP_TESTING_NAME",
+    "LIBENVPP_TESTING_A",
+    "LIBENVPP_TESTING_B",
+});
+
+static_assert(schema.find("LIBENVPP_TESTING_LOG_FILE_PATH") == 0);
+static_assert(schema.find("LIBENVPP_TESTING_NUM_THREADS") == 1);
+static_assert(schema.find("LIBENVPP_TESTING_NAME") == 2);
+static_assert(schema.find("LIBENVPP_TESTING_A") == 3);
+static_assert(schema.find("LIBENVPP_TESTING_B") == 4);
+static_assert(schema.find("LIBENVPP_TESTING_C") == schema.size());
+static_assert(schema.find("") == schema.size());
+
+constexpr auto empty_schema = perfect_hash_table<0>({});
+static_assert(empty_schema.find("LIBENVPP_TESTING_A") == 0);
+
+} // namespace
+
+TEST_CASE("Perfect hash table finds all keys", "[perfect_hash]")
+{
+	for (const auto key_count : {1, 2, 3, 10, 100, 1000, 10000}) {
+		auto names = std::vector<std::string>{};
+		for (int i = 0; i < key_count; ++i) {
+			names.push_back(fmt::format("LIBENVPP_TESTING_VAR_{}", i));
+		}
+		const auto keys = std::vector<std::string_view>(names.begin(), names.end());
+		auto displacements = std::vector<std::uint32_t>(perfect_hash_bucket_count(keys.size()));
+		auto slots = std::vector<std::size_t>(perfect_hash_table_size(keys.size()));
+		auto scratch = std::vector<std::size_t>(perfect_hash_scratch_size(keys.size()));
+		build_perfect_hash(keys.data(), keys.size(), displacements.data(), slots.data(), scratch.data());
+
+		const auto find = [&](const std::string_view key) {
+			return perfect_hash_find(key, keys.data(), keys.size(), displacements.data(), displacements.size(),
+			                         slots.data(), slots.size());
+		};
+		for (std::size_t i = 0; i < keys.size(); ++i) {
+			REQUIRE(find(keys[i]) == i);
+		}
+		CHECK(find("LIBENVPP_TESTING_VAR_") == keys.size());
+		CHECK(find(fmt::format("LIBENVPP_TESTING_VAR_{}", key_count)) == keys.size());
+	}
+}
+
+TEST_CASE("Perfect hash table of duplicate keys throws", "[perfect_hash]")
+{
+	const auto keys = std::array<std::string_view, 3>{"LIBENVPP_TESTING_A", "LIBENVPP_TESTING_B", "LIBENVPP_TESTING_A"};
+	CHECK_THROWS_AS(perfect_hash_table<3>(keys), std::invalid_argument);
+}
+
+} // namespace env::detail
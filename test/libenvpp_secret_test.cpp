@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+#include <fmt/core.h>
+
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+using Catch::Matchers::ContainsSubstring;
+using Catch::Matchers::Equals;
+
+class secret_file_fixture {
+  public:
+	secret_file_fixture()
+	    : m_path(std::filesystem::temp_directory_path()
+	             / fmt::format("libenvpp_secret_test_{}", std::random_device{}())),
+	      m_path_str(m_path.string())
+	{
+		write("hunter2\n");
+	}
+
+	~secret_file_fixture()
+	{
+		clear_secret_file_cache();
+		std::filesystem::remove(m_path);
+	}
+
+	void write(const std::string_view content) const
+	{
+		auto file = std::ofstream(m_path, std::ios::binary | std::ios::trunc);
+		file << content;
+	}
+
+	void touch() const
+	{
+		std::filesystem::last_write_time(m_path, std::filesystem::last_write_time(m_path) + std::chrono::seconds(1));
+	}
+
+	std::filesystem::path m_path;
+	std::string m_path_str;
+};
+
+TEST_CASE_METHOD(secret_file_fixture, "Secret is read from file", "[libenvpp_secret]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto secret_id = pre.register_required_secret<std::string>("PASSWORD");
+	auto parsed_and_validated_pre = pre.parse_and_validate({{"LIBENVPP_TESTING_PASSWORD_FILE", m_path_str}});
+	REQUIRE(parsed_and_validated_pre.ok());
+	CHECK_THAT(parsed_and_validated_pre.get(secret_id), Equals("hunter2"));
+}
+
+TEST_CASE_METHOD(secret_file_fixture, "Secret is read from environment variable", "[libenvpp_secret]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto secret_id = pre.register_secret<std::string>("PASSWORD");
+	auto parsed_and_validated_pre = pre.parse_and_validate({{"LIBENVPP_TESTING_PASSWORD", "swordfish"}});
+	REQUIRE(parsed_and_validated_pre.ok());
+	CHECK(parsed_and_validated_pre.get_or(secret_id, "") == "swordfish");
+}
+
+TEST_CASE_METHOD(secret_file_fixture, "Secret file content is fed to the variable's parser", "[libenvpp_secret]")
+{
+	write("42\r\n");
+
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto secret_id = pre.register_secret<int>("PIN");
+	auto parsed_and_validated_pre = pre.parse_and_validate({{"LIBENVPP_TESTING_PIN_FILE", m_path_str}});
+	REQUIRE(parsed_and_validated_pre.ok());
+	CHECK(parsed_and_validated_pre.get_or(secret_id, 0) == 42);
+}
+
+TEST_CASE_METHOD(secret_file_fixture, "Only a single trailing newline is trimmed from secret files",
+                 "[libenvpp_secret]")
+{
+	write("line1\nline2\n\n");
+
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto secret_id = pre.register_required_secret<std::string>("CERT");
+	auto parsed_and_validated_pre = pre.parse_and_validate({{"LIBENVPP_TESTING_CERT_FILE", m_path_str}});
+	REQUIRE(parsed_and_validated_pre.ok());
+	CHECK_THAT(parsed_and_validated_pre.get(secret_id), Equals("line1\nline2\n"));
+}
+
+TEST_CASE_METHOD(secret_file_fixture, "Setting secret and secret file is an error", "[libenvpp_secret]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	[[maybe_unused]] const auto secret_id = pre.register_required_secret<std::string>("PASSWORD");
+	auto parsed_and_validated_pre = pre.parse_and_validate({
+	    {"LIBENVPP_TESTING_PASSWORD", "swordfish"},
+	    {"LIBENVPP_TESTING_PASSWORD_FILE", m_path_str},
+	});
+	REQUIRE_FALSE(parsed_and_validated_pre.ok());
+	REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+	CHECK(parsed_and_validated_pre.warnings().empty());
+	CHECK_THAT(parsed_and_validated_pre.errors()[0].what(), ContainsSubstring("'LIBENVPP_TESTING_PASSWORD_FILE'")
+	                                                            && ContainsSubstring("mutually exclusive"));
+}
+
+TEST_CASE_METHOD(secret_file_fixture, "Missing secret file is an error", "[libenvpp_secret]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	[[maybe_unused]] const auto secret_id = pre.register_secret<std::string>("PASSWORD");
+	auto parsed_and_validated_pre =
+	    pre.parse_and_validate({{"LIBENVPP_TESTING_PASSWORD_FILE", m_path_str + "_does_not_exist"}});
+	REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+	CHECK_THAT(parsed_and_validated_pre.errors()[0].what(), ContainsSubstring("Failed to open secret file"));
+}
+
+TEST_CASE_METHOD(secret_file_fixture, "Secret file exceeding the size limit is an error", "[libenvpp_secret]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	[[maybe_unused]] const auto secret_id =
+	    pre.register_secret<std::string>("PASSWORD", default_parser_and_validator<std::string>{}, 4);
+	auto parsed_and_validated_pre = pre.parse_and_validate({{"LIBENVPP_TESTING_PASSWORD_FILE", m_path_str}});
+	REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+	CHECK_THAT(parsed_and_validated_pre.errors()[0].what(), ContainsSubstring("exceeds the size limit of 4 bytes"));
+}
+
+TEST_CASE_METHOD(secret_file_fixture, "Secret file is cached until it is modified", "[libenvpp_secret]")
+{
+	const auto first = detail::read_secret_file(m_path_str, default_secret_file_size_limit);
+	REQUIRE(first.has_value());
+	const auto second = detail::read_secret_file(m_path_str, default_secret_file_size_limit);
+	REQUIRE(second.has_value());
+	CHECK(first->get() == second->get());
+
+	write("letmein");
+	touch();
+
+	const auto third = detail::read_secret_file(m_path_str, default_secret_file_size_limit);
+	REQUIRE(third.has_value());
+	CHECK(first->get() != third->get());
+	CHECK((*first)->view() == "hunter2");
+	CHECK((*third)->view() == "letmein");
+}
+
+TEST_CASE("Suffixed variable of non-secret is reported as unused", "[libenvpp_secret]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	[[maybe_unused]] const auto var_id = pre.register_variable<std::string>("PASSWORD");
+	auto parsed_and_validated_pre = pre.parse_and_validate({{"LIBENVPP_TESTING_PASSWORD_FILE", "/dev/null"}});
+	REQUIRE(parsed_and_validated_pre.warnings().size() == 1);
+	CHECK_THAT(parsed_and_validated_pre.warnings()[0].what(), ContainsSubstring("LIBENVPP_TESTING_PASSWORD_FILE"));
+}
+
+TEST_CASE("Help message mentions secret file variable", "[libenvpp_secret]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	[[maybe_unused]] const auto secret_id = pre.register_required_secret<std::string>("PASSWORD");
+	CHECK_THAT(pre.help_message(), ContainsSubstring("'LIBENVPP_TESTING_PASSWORD' required (or "
+	                                                 "'LIBENVPP_TESTING_PASSWORD_FILE')"));
+}
+
+TEST_CASE("Secret buffer is zeroed when truncated", "[libenvpp_secret]")
+{
+	auto buffer = detail::secret_buffer(4);
+	std::copy_n("abcd", 4, buffer.data());
+	buffer.truncate(2);
+	CHECK(buffer.view() == "ab");
+	CHECK(buffer.data()[2] == '\0');
+	CHECK(buffer.data()[3] == '\0');
+}
+
+} // namespace env
@@ -0,0 +1,183 @@
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+#include <fmt/core.h>
+
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+using Catch::Matchers::ContainsSubstring;
+using Catch::Matchers::Equals;
+
+class config_file_fixture {
+  public:
+	config_file_fixture()
+	    : m_path(std::filesystem::temp_directory_path()
+	             / fmt::format("libenvpp_source_test_{}.env", std::random_device{}()))
+	{
+	}
+
+	~config_file_fixture() { std::filesystem::remove(m_path); }
+
+	void write(const std::string_view content) const
+	{
+		auto file = std::ofstream(m_path, std::ios::binary | std::ios::trunc);
+		file << content;
+	}
+
+	std::filesystem::path m_path;
+};
+
+TEST_CASE("Command line options map onto registered variables", "[libenvpp_source]")
+{
+	const char* argv[] = {"program", "--num-threads=8", "positional", "--verbose", "--log-file-path=/dev/null",
+	                      "--num-threads=16", "--", "--ignored=1"};
+	const auto cmd_line = command_line_source(static_cast<int>(std::size(argv)), argv);
+
+	CHECK(cmd_line.find("LIBENVPP_TESTING_NUM_THREADS", "NUM_THREADS") == "16");
+	CHECK(cmd_line.find("LIBENVPP_TESTING_LOG_FILE_PATH", "LOG_FILE_PATH") == "/dev/null");
+	CHECK_FALSE(cmd_line.find("LIBENVPP_TESTING_VERBOSE", "VERBOSE").has_value());
+	CHECK_FALSE(cmd_line.find("LIBENVPP_TESTING_IGNORED", "IGNORED").has_value());
+	CHECK_FALSE(cmd_line.find("LIBENVPP_TESTING_NUM", "NUM").has_value());
+}
+
+TEST_CASE("Map source looks up full and registered names", "[libenvpp_source]")
+{
+	const auto defaults = map_source("defaults", {{"NUM_THREADS", "4"}, {"LIBENVPP_TESTING_LOG_LEVEL", "info"}});
+
+	CHECK(defaults.name() == "defaults");
+	CHECK(defaults.find("LIBENVPP_TESTING_NUM_THREADS", "NUM_THREADS") == "4");
+	CHECK(defaults.find("LIBENVPP_TESTING_LOG_LEVEL", "LOG_LEVEL") == "info");
+	CHECK_FALSE(defaults.find("LIBENVPP_TESTING_OTHER", "OTHER").has_value());
+}
+
+TEST_CASE_METHOD(config_file_fixture, "Configuration file is parsed", "[libenvpp_source]")
+{
+	write("# Comment\n"
+	      "\n"
+	      "NUM_THREADS = 8\n"
+	      "  LIBENVPP_TESTING_LOG_FILE_PATH=\"/var/log/my file\"  \r\n"
+	      "NAME='quoted'\n"
+	      "EMPTY=\n");
+
+	const auto file = file_source(m_path);
+	CHECK(file.name() == m_path.string());
+	CHECK(file.find("LIBENVPP_TESTING_NUM_THREADS", "NUM_THREADS") == "8");
+	CHECK(file.find("LIBENVPP_TESTING_LOG_FILE_PATH", "LOG_FILE_PATH") == "/var/log/my file");
+	CHECK(file.find("LIBENVPP_TESTING_NAME", "NAME") == "quoted");
+	CHECK(file.find("LIBENVPP_TESTING_EMPTY", "EMPTY") == "");
+}
+
+TEST_CASE_METHOD(config_file_fixture, "Malformed configuration file throws", "[libenvpp_source]")
+{
+	write("NUM_THREADS=8\n"
+	      "NOT A KEY VALUE PAIR\n");
+
+	CHECK_THROWS_AS(file_source(m_path), source_error);
+	CHECK_THROWS_WITH(file_source(m_path), ContainsSubstring("line 2"));
+}
+
+TEST_CASE("Missing configuration file throws", "[libenvpp_source]")
+{
+	CHECK_THROWS_AS(file_source("libenvpp_file_that_does_not_exist.env"), source_error);
+}
+
+TEST_CASE_METHOD(config_file_fixture, "Layers are resolved in order of precedence", "[libenvpp_source]")
+{
+	write("NUM_THREADS=2\n"
+	      "LOG_LEVEL=debug\n"
+	      "NAME=file\n");
+
+	const char* argv[] = {"program", "--num-threads=8"};
+	const auto cmd_line = command_line_source(static_cast<int>(std::size(argv)), argv);
+	const auto environment = environment_source({
+	    {"LIBENVPP_TESTING_NUM_THREADS", "4"},
+	    {"LIBENVPP_TESTING_NAME", "env"},
+	});
+	const auto file = file_source(m_path);
+	const auto defaults = map_source("defaults", {{"NUM_THREADS", "1"}, {"TIMEOUT", "30"}});
+
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto num_threads_id = pre.register_required_variable<int>("NUM_THREADS");
+	const auto name_id = pre.register_required_variable<std::string>("NAME");
+	const auto log_level_id = pre.register_required_variable<std::string>("LOG_LEVEL");
+	const auto timeout_id = pre.register_required_variable<int>("TIMEOUT");
+	const auto unset_id = pre.register_variable<int>("UNSET");
+
+	auto parsed_and_validated_pre = pre.parse_and_validate({cmd_line, environment, file, defaults});
+	REQUIRE(parsed_and_validated_pre.ok());
+
+	CHECK(parsed_and_validated_pre.get(num_threads_id) == 8);
+	CHECK(parsed_and_validated_pre.get_source(num_threads_id) == "command line");
+	CHECK_THAT(parsed_and_validated_pre.get(name_id), Equals("env"));
+	CHECK(parsed_and_validated_pre.get_source(name_id) == "environment");
+	CHECK_THAT(parsed_and_validated_pre.get(log_level_id), Equals("debug"));
+	CHECK(parsed_and_validated_pre.get_source(log_level_id) == m_path.string());
+	CHECK(parsed_and_validated_pre.get(timeout_id) == 30);
+	CHECK(parsed_and_validated_pre.get_source(timeout_id) == "defaults");
+	CHECK_FALSE(parsed_and_validated_pre.get(unset_id).has_value());
+	CHECK_FALSE(parsed_and_validated_pre.get_source(unset_id).has_value());
+}
+
+TEST_CASE("Environment consumed by higher layer is not reported as unused", "[libenvpp_source]")
+{
+	const char* argv[] = {"program", "--num-threads=8"};
+	const auto cmd_line = command_line_source(static_cast<int>(std::size(argv)), argv);
+	const auto environment =
+	    environment_source(std::unordered_map<std::string, std::string>{{"LIBENVPP_TESTING_NUM_THREADS", "4"}});
+
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto num_threads_id = pre.register_variable<int>("NUM_THREADS");
+	auto parsed_and_validated_pre = pre.parse_and_validate({cmd_line, environment});
+	REQUIRE(parsed_and_validated_pre.ok());
+	CHECK(parsed_and_validated_pre.get_or(num_threads_id, 0) == 8);
+}
+
+TEST_CASE("Errors of lower layers are reported", "[libenvpp_source]")
+{
+	const auto environment =
+	    environment_source(std::unordered_map<std::string, std::string>{{"LIBENVPP_TESTING_NUM_TRHEADS", "4"}});
+	const auto defaults = map_source("defaults", {{"NUM_THREADS", "many"}});
+
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	[[maybe_unused]] const auto num_threads_id = pre.register_variable<int>("NUM_THREADS");
+	auto parsed_and_validated_pre = pre.parse_and_validate({environment, defaults});
+	REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+	CHECK_THAT(parsed_and_validated_pre.errors()[0].what(), ContainsSubstring("many"));
+	REQUIRE(parsed_and_validated_pre.warnings().size() == 1);
+	CHECK_THAT(parsed_and_validated_pre.warnings()[0].what(), ContainsSubstring("LIBENVPP_TESTING_NUM_TRHEADS"));
+}
+
+TEST_CASE("Chain without environment ignores the environment", "[libenvpp_source]")
+{
+	const auto _ = detail::set_scoped_environment_variable("LIBENVPP_TESTING_NUM_THREADS", "4");
+	const auto defaults = map_source("defaults", {{"NUM_THREADS", "1"}});
+
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto num_threads_id = pre.register_variable<int>("NUM_THREADS");
+	auto parsed_and_validated_pre = pre.parse_and_validate({defaults});
+	REQUIRE(parsed_and_validated_pre.ok());
+	CHECK(parsed_and_validated_pre.get_or(num_threads_id, 0) == 1);
+	CHECK(parsed_and_validated_pre.get_source(num_threads_id) == "defaults");
+}
+
+TEST_CASE("Values parsed from the environment record their source", "[libenvpp_source]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto num_threads_id = pre.register_variable<int>("NUM_THREADS");
+	const auto name_id = pre.register_variable<std::string>("NAME");
+	pre.set_for_testing(name_id, "test");
+	auto parsed_and_validated_pre = pre.parse_and_validate({{"LIBENVPP_TESTING_NUM_THREADS", "4"}});
+	REQUIRE(parsed_and_validated_pre.ok());
+	CHECK(parsed_and_validated_pre.get_source(num_threads_id) == "environment");
+	CHECK_FALSE(parsed_and_validated_pre.get_source(name_id).has_value());
+}
+
+} // namespace env
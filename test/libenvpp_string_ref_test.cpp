@@ -0,0 +1,89 @@
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+#include <libenvpp/detail/environment.hpp>
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+using Catch::Matchers::ContainsSubstring;
+
+TEST_CASE("String view variables reference the environment snapshot", "[libenvpp_string_ref]")
+{
+	const auto long_value = std::string(1000, 'x');
+	auto pre = prefix("VIEW");
+	const auto short_id = pre.register_variable<std::string_view>("SHORT");
+	const auto long_id = pre.register_required_variable<std::string_view>("LONG");
+	const auto unset_id = pre.register_variable<std::string_view>("UNSET");
+	auto parsed_and_validated_pre = pre.parse_and_validate({{"VIEW_SHORT", "short"}, {"VIEW_LONG", long_value}});
+	REQUIRE(parsed_and_validated_pre.ok());
+
+	// Moving the parsed and validated prefix must not invalidate the values, also not of short strings.
+	const auto moved_parsed_pre = std::move(parsed_and_validated_pre);
+	CHECK(moved_parsed_pre.get(short_id) == "short");
+	CHECK(moved_parsed_pre.get(long_id) == long_value);
+	CHECK(moved_parsed_pre.get(long_id).data() == moved_parsed_pre.get(long_id).data());
+	CHECK(moved_parsed_pre.get_or(unset_id, "default") == "default");
+}
+
+TEST_CASE("String references outlive the parsed and validated prefix", "[libenvpp_string_ref]")
+{
+	auto ref = std::optional<string_ref>();
+	{
+		auto pre = prefix("REF");
+		const auto ref_id = pre.register_required_variable<string_ref>("VALUE");
+		const auto parsed_and_validated_pre = pre.parse_and_validate({{"REF_VALUE", "referenced value"}});
+		REQUIRE(parsed_and_validated_pre.ok());
+		ref = parsed_and_validated_pre.get(ref_id);
+		CHECK(ref->data() == parsed_and_validated_pre.get(ref_id).data());
+	}
+	CHECK(*ref == "referenced value");
+	CHECK(ref->str() == "referenced value");
+	CHECK(std::string_view(*ref).size() == 16);
+}
+
+TEST_CASE("String views of other source layers are copied into the snapshot", "[libenvpp_string_ref]")
+{
+	auto pre = prefix("LAYERED");
+	const auto view_id = pre.register_variable<std::string_view>("VIEW");
+	auto parsed_and_validated_pre = std::optional<parsed_and_validated_prefix<prefix>>();
+	{
+		const auto defaults = map_source("defaults", {{"VIEW", "from defaults"}});
+		parsed_and_validated_pre.emplace(pre.parse_and_validate(source_chain{defaults}));
+	}
+	CHECK(parsed_and_validated_pre->get(view_id) == "from defaults");
+	CHECK(parsed_and_validated_pre->get_source(view_id) == "defaults");
+}
+
+TEST_CASE("String views parsed on an executor", "[libenvpp_string_ref]")
+{
+	auto pre = prefix("EXECUTOR_VIEW");
+	const auto first_id = pre.register_variable<std::string_view>("FIRST");
+	const auto second_id = pre.register_variable<string_ref>("SECOND");
+	auto pool = thread_pool(2);
+	const auto parsed_and_validated_pre =
+	    pre.parse_and_validate(pool, {{"EXECUTOR_VIEW_FIRST", "first"}, {"EXECUTOR_VIEW_SECOND", "second"}});
+	REQUIRE(parsed_and_validated_pre.ok());
+	CHECK(parsed_and_validated_pre.get(first_id) == "first");
+	CHECK(parsed_and_validated_pre.get(second_id) == "second");
+}
+
+TEST_CASE("Retrieving string reference with get", "[libenvpp_string_ref][get]")
+{
+	const auto _ = detail::set_scoped_environment_variable{"LIBENVPP_TESTING_REF", "value"};
+
+	const auto value = get<string_ref>("LIBENVPP_TESTING_REF");
+	REQUIRE(value.has_value());
+	CHECK(*value == "value");
+
+	const auto missing = get<string_ref>("LIBENVPP_TESTING_RFE");
+	REQUIRE_FALSE(missing.has_value());
+	CHECK_THAT(missing.error().what(), ContainsSubstring("did you mean 'LIBENVPP_TESTING_RFE'"));
+}
+
+} // namespace env
@@ -1,11 +1,15 @@
+#include <cstdio>
+#include <iterator>
 #include <limits>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers_all.hpp>
-#include <fmt/core.h>
+#include <fmt/format.h>
 
 #include <libenvpp/detail/environment.hpp>
 #include <libenvpp/env.hpp>
@@ -307,12 +311,49 @@ TEST_CASE("Retrieving errors", "[libenvpp]")
 	SECTION("Relating error to name")
 	{
 		for (const auto& err : parsed_pre.errors()) {
-			const auto err_name = err.get_name();
+			const auto err_name = std::string(err.get_name());
 			CHECK_THAT(err_name, Equals(prefix_name + "_" + foo_name));
 		}
 	}
 }
 
+TEST_CASE("Error kinds", "[libenvpp]")
+{
+	auto pre = env::prefix("KIND");
+	[[maybe_unused]] const auto int_id = pre.register_variable<int>("INT");
+	[[maybe_unused]] const auto range_id = pre.register_range<int>("RANGE", 0, 10);
+	[[maybe_unused]] const auto option_id = pre.register_option<int>("OPTION", {1, 2});
+	[[maybe_unused]] const auto required_id = pre.register_required_variable<int>("REQUIRED");
+	[[maybe_unused]] const auto optional_id = pre.register_variable<int>("OPTIONAL");
+	const auto parsed_pre = pre.parse_and_validate({
+	    {"KIND_INT", "abc"},
+	    {"KIND_RANGE", "100"},
+	    {"KIND_OPTION", "3"},
+	    {"KIND_OPTINAL", "1"},
+	    {"KIND_UNUSED", "unused"},
+	});
+
+	REQUIRE(parsed_pre.errors().size() == 4);
+	CHECK(parsed_pre.errors()[0].kind() == error_kind::parser);
+	CHECK(parsed_pre.errors()[1].kind() == error_kind::range);
+	CHECK(parsed_pre.errors()[2].kind() == error_kind::option);
+	CHECK(parsed_pre.errors()[3].kind() == error_kind::unset);
+	CHECK(parsed_pre.errors()[3].get_name() == "KIND_REQUIRED");
+	CHECK(parsed_pre.errors()[3].what() == "Environment variable 'KIND_REQUIRED' not set");
+
+	REQUIRE(parsed_pre.warnings().size() == 2);
+	CHECK(parsed_pre.warnings()[0].kind() == error_kind::misspelled);
+	CHECK(parsed_pre.warnings()[0].what()
+	      == "Unrecognized environment variable 'KIND_OPTINAL' set, did you mean 'KIND_OPTIONAL'?");
+	CHECK(parsed_pre.warnings()[1].kind() == error_kind::unused);
+	CHECK(parsed_pre.warnings()[1].what() == "Prefix environment variable 'KIND_UNUSED' specified but unused");
+
+	const auto custom = error(7, "CUSTOM", "Custom message");
+	CHECK(custom.kind() == error_kind::custom);
+	CHECK(custom.get_name() == "CUSTOM");
+	CHECK(custom.what() == "Custom message");
+}
+
 TEST_CASE_METHOD(int_var_fixture, "Typo detection using edit distance", "[libenvpp]")
 {
 	SECTION("Optional variable")
@@ -547,6 +588,62 @@ TEST_CASE("Help message", "[libenvpp]")
 	}
 }
 
+TEST_CASE("Streaming messages", "[libenvpp]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	[[maybe_unused]] const auto int_id = pre.register_required_variable<int>("INTEGER");
+	[[maybe_unused]] const auto secret_id = pre.register_secret<std::string>("PASSWORD");
+	const auto help_message = pre.help_message();
+	const auto parsed_pre = pre.parse_and_validate({{"LIBENVPP_TESTING_INTEGR", "1"}, {"LIBENVPP_TESTING_UNUSED", ""}});
+	REQUIRE_FALSE(parsed_pre.errors().empty());
+	REQUIRE_FALSE(parsed_pre.warnings().empty());
+
+	SECTION("Memory buffer")
+	{
+		auto buffer = fmt::memory_buffer();
+		buffer.append(std::string_view("> "));
+		parsed_pre.help_message(buffer);
+		CHECK(fmt::to_string(buffer) == "> " + help_message);
+
+		buffer.clear();
+		parsed_pre.error_message(buffer);
+		CHECK(fmt::to_string(buffer) == parsed_pre.error_message());
+
+		buffer.clear();
+		parsed_pre.warning_message(buffer);
+		CHECK(fmt::to_string(buffer) == parsed_pre.warning_message());
+	}
+
+	SECTION("Output iterator")
+	{
+		auto message = std::string();
+		parsed_pre.help_message(std::back_inserter(message));
+		CHECK(message == help_message);
+
+		auto messages = std::vector<char>();
+		parsed_pre.error_message(std::back_inserter(messages));
+		parsed_pre.warning_message(std::back_inserter(messages));
+		CHECK(std::string(messages.begin(), messages.end())
+		      == parsed_pre.error_message() + parsed_pre.warning_message());
+	}
+
+#if LIBENVPP_PLATFORM_UNIX
+	SECTION("File descriptor")
+	{
+		const auto file = std::unique_ptr<std::FILE, decltype(&std::fclose)>(std::tmpfile(), &std::fclose);
+		REQUIRE(file != nullptr);
+		parsed_pre.write_help_message(fileno(file.get()));
+		parsed_pre.write_error_message(fileno(file.get()));
+		std::rewind(file.get());
+		auto content = std::string(help_message.size() + parsed_pre.error_message().size() + 1, '\0');
+		content.resize(std::fread(content.data(), 1, content.size(), file.get()));
+		CHECK(content == help_message + parsed_pre.error_message());
+
+		CHECK_THROWS_AS(parsed_pre.write_warning_message(-1), write_error);
+	}
+#endif
+}
+
 TEST_CASE("Parser errors", "[libenvpp]")
 {
 	constexpr auto prefix_name = "LIBENVPP_TESTING";
@@ -808,6 +905,71 @@ TEST_CASE_METHOD(int_var_fixture, "Option environment variables", "[libenvpp]")
 	}
 }
 
+TEST_CASE("Large option sets", "[libenvpp]")
+{
+	auto pre = env::prefix("LARGE");
+	const auto int_id =
+	    pre.register_option<int>("INT", {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61});
+	const auto region_id = pre.register_option<std::string>(
+	    "REGION", {"af-south-1", "ap-east-1", "ap-northeast-1", "ap-south-1", "ca-central-1", "eu-central-1",
+	               "eu-north-1", "eu-west-1", "me-south-1", "sa-east-1", "us-east-1", "us-west-1"});
+	const auto view_id =
+	    pre.register_option<std::string_view>("VIEW", {"a", "b", "c", "d", "e", "f", "g", "h", "i"});
+
+	SECTION("Valid options")
+	{
+		const auto parsed_and_validated_pre =
+		    pre.parse_and_validate({{"LARGE_INT", "43"}, {"LARGE_REGION", "eu-west-1"}, {"LARGE_VIEW", "i"}});
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(int_id) == 43);
+		CHECK(parsed_and_validated_pre.get(region_id) == "eu-west-1");
+		CHECK(parsed_and_validated_pre.get(view_id) == "i");
+	}
+
+	SECTION("Invalid options")
+	{
+		const auto parsed_and_validated_pre =
+		    pre.parse_and_validate({{"LARGE_INT", "42"}, {"LARGE_REGION", "eu-west-3"}, {"LARGE_VIEW", "j"}});
+		REQUIRE(parsed_and_validated_pre.errors().size() == 3);
+		CHECK(parsed_and_validated_pre.errors()[0].kind() == error_kind::option);
+		CHECK_THAT(parsed_and_validated_pre.errors()[0].what(), ContainsSubstring("Unrecognized option '42'"));
+		CHECK_THAT(parsed_and_validated_pre.errors()[1].what(), ContainsSubstring("Unrecognized option 'eu-west-3'"));
+		CHECK_THAT(parsed_and_validated_pre.errors()[2].what(), ContainsSubstring("Unrecognized option 'j'"));
+	}
+}
+
+TEST_CASE("Option sets", "[libenvpp]")
+{
+	SECTION("Few options")
+	{
+		const auto ints = detail::option_set<int>({1, 2, 3});
+		CHECK(ints.contains(2));
+		CHECK_FALSE(ints.contains(4));
+		const auto strings = detail::option_set<std::string>({"a", "b"});
+		CHECK(strings.contains("a"));
+		CHECK_FALSE(strings.contains("c"));
+	}
+
+	SECTION("Many options")
+	{
+		auto int_options = std::vector<int>();
+		auto string_options = std::vector<std::string>();
+		for (auto i = 0; i < 100; ++i) {
+			int_options.push_back(2 * i);
+			string_options.push_back(fmt::format("option_{:03}", i));
+		}
+		const auto ints = detail::option_set<int>(int_options);
+		const auto strings = detail::option_set<std::string>(string_options);
+		for (auto i = 0; i < 100; ++i) {
+			CHECK(ints.contains(2 * i));
+			CHECK_FALSE(ints.contains(2 * i + 1));
+			CHECK(strings.contains(fmt::format("option_{:03}", i)));
+		}
+		CHECK_FALSE(strings.contains("option_100"));
+		CHECK_FALSE(strings.contains(""));
+	}
+}
+
 TEST_CASE("Empty option", "[libenvpp]")
 {
 	auto pre = env::prefix("LIBENVPP_TESTING");
@@ -1064,6 +1226,27 @@ TEST_CASE("Parsed and validated prefix can be moved", "[libenvpp]")
 	}
 }
 
+TEST_CASE("Error names remain valid when moving the parsed and validated prefix", "[libenvpp]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	// Long names do not fit into the first block of the arena storing the names.
+	const auto long_name = std::string(5000, 'L');
+	[[maybe_unused]] const auto short_id = pre.register_required_variable<int>("SHORT");
+	[[maybe_unused]] const auto long_id = pre.register_required_variable<int>(long_name);
+	[[maybe_unused]] const auto secret_id = pre.register_required_secret<std::string>("PASSWORD");
+	auto parsed_and_validated_pre = pre.parse_and_validate({{"LIBENVPP_TESTING_SHORT", "abc"}});
+
+	const auto moved_parsed_pre = std::move(parsed_and_validated_pre);
+	REQUIRE(moved_parsed_pre.errors().size() == 3);
+	CHECK(moved_parsed_pre.errors()[0].get_name() == "SHORT");
+	CHECK_THAT(moved_parsed_pre.errors()[0].what(),
+	           StartsWith("Parser error for environment variable 'LIBENVPP_TESTING_SHORT'"));
+	CHECK(moved_parsed_pre.errors()[1].get_name() == "LIBENVPP_TESTING_" + long_name);
+	CHECK(moved_parsed_pre.errors()[2].get_name() == "LIBENVPP_TESTING_PASSWORD");
+	CHECK_THAT(moved_parsed_pre.help_message(),
+	           ContainsSubstring("'LIBENVPP_TESTING_PASSWORD' required (or 'LIBENVPP_TESTING_PASSWORD_FILE')"));
+}
+
 TEST_CASE("Moved from parsed and validated prefix throws", "[libenvpp]")
 {
 	auto pre = env::prefix("LIBENVPP_TESTING");
@@ -1129,7 +1312,7 @@ TEST_CASE_METHOD(float_var_fixture, "Parsing error using get", "[libenvpp][get]"
 	CHECK_FALSE(int_value.has_value());
 	CHECK_THAT(int_value.error().what(),
 	           ContainsSubstring("Parser error") && ContainsSubstring("'LIBENVPP_TESTING_FLOAT'"));
-	CHECK_THAT(int_value.error().get_name(), Equals("LIBENVPP_TESTING_FLOAT"));
+	CHECK_THAT(std::string(int_value.error().get_name()), Equals("LIBENVPP_TESTING_FLOAT"));
 }
 
 TEST_CASE("Validation error using get", "[libenvpp][get]")
@@ -1140,7 +1323,7 @@ TEST_CASE("Validation error using get", "[libenvpp][get]")
 	CHECK_FALSE(value.has_value());
 	CHECK_THAT(value.error().what(), ContainsSubstring("Validation error") && ContainsSubstring("Unvalidatable")
 	                                     && ContainsSubstring("'LIBENVPP_TESTING_UNVALIDATABLE'"));
-	CHECK_THAT(value.error().get_name(), Equals("LIBENVPP_TESTING_UNVALIDATABLE"));
+	CHECK_THAT(std::string(value.error().get_name()), Equals("LIBENVPP_TESTING_UNVALIDATABLE"));
 }
 
 TEST_CASE("Environment variable does not exist when using get", "[libenvpp][get]")
@@ -1148,7 +1331,7 @@ TEST_CASE("Environment variable does not exist when using get", "[libenvpp][get]
 	const auto value = get<int>("LIBENVPP_TESTING_INT");
 	CHECK_FALSE(value.has_value());
 	CHECK_THAT(value.error().what(), ContainsSubstring("'LIBENVPP_TESTING_INT' not set"));
-	CHECK_THAT(value.error().get_name(), Equals("LIBENVPP_TESTING_INT"));
+	CHECK_THAT(std::string(value.error().get_name()), Equals("LIBENVPP_TESTING_INT"));
 }
 
 TEST_CASE_METHOD(int_var_fixture, "Typo detection when using get", "[libenvpp][get]")
@@ -1157,7 +1340,7 @@ TEST_CASE_METHOD(int_var_fixture, "Typo detection when using get", "[libenvpp][g
 	CHECK_FALSE(value.has_value());
 	CHECK_THAT(value.error().what(), ContainsSubstring("'LIBENVPP_TESTING_INT' set")
 	                                     && ContainsSubstring("did you mean 'LIBENVPP_TESTING_HINT'"));
-	CHECK_THAT(value.error().get_name(), Equals("LIBENVPP_TESTING_HINT"));
+	CHECK_THAT(std::string(value.error().get_name()), Equals("LIBENVPP_TESTING_HINT"));
 }
 
 TEST_CASE("Retrieving integer with get_or", "[libenvpp][get]")
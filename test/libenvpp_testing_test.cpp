@@ -1,7 +1,10 @@
 #include <limits>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_all.hpp>
@@ -135,24 +138,20 @@ TEST_CASE("Global testing environment is modified correctly", "[libenvpp_testing
 	CHECK(detail::g_testing_environment.empty());
 
 	constexpr auto check_env1 = [](bool contains = true) {
-		CHECK((detail::g_testing_environment.find("LIBENVPP_TESTING1_INT") != detail::g_testing_environment.end())
-		      == contains);
-		CHECK((detail::g_testing_environment.find("LIBENVPP_TESTING1_FLOAT") != detail::g_testing_environment.end())
-		      == contains);
+		CHECK(detail::g_testing_environment.find("LIBENVPP_TESTING1_INT").has_value() == contains);
+		CHECK(detail::g_testing_environment.find("LIBENVPP_TESTING1_FLOAT").has_value() == contains);
 		if (contains) {
-			CHECK(detail::g_testing_environment["LIBENVPP_TESTING1_INT"] == "42");
-			CHECK(detail::g_testing_environment["LIBENVPP_TESTING1_FLOAT"] == "3.1415");
+			CHECK(detail::g_testing_environment.find("LIBENVPP_TESTING1_INT") == "42");
+			CHECK(detail::g_testing_environment.find("LIBENVPP_TESTING1_FLOAT") == "3.1415");
 		}
 	};
 
 	constexpr auto check_env2 = [](bool contains = true) {
-		CHECK((detail::g_testing_environment.find("LIBENVPP_TESTING2_INT") != detail::g_testing_environment.end())
-		      == contains);
-		CHECK((detail::g_testing_environment.find("LIBENVPP_TESTING2_FLOAT") != detail::g_testing_environment.end())
-		      == contains);
+		CHECK(detail::g_testing_environment.find("LIBENVPP_TESTING2_INT").has_value() == contains);
+		CHECK(detail::g_testing_environment.find("LIBENVPP_TESTING2_FLOAT").has_value() == contains);
 		if (contains) {
-			CHECK(detail::g_testing_environment["LIBENVPP_TESTING2_INT"] == "24");
-			CHECK(detail::g_testing_environment["LIBENVPP_TESTING2_FLOAT"] == "6.28318");
+			CHECK(detail::g_testing_environment.find("LIBENVPP_TESTING2_INT") == "24");
+			CHECK(detail::g_testing_environment.find("LIBENVPP_TESTING2_FLOAT") == "6.28318");
 		}
 	};
 
@@ -187,6 +186,31 @@ TEST_CASE("Global testing environment is modified correctly", "[libenvpp_testing
 	check_env2(false);
 }
 
+TEST_CASE("Global testing environment scopes may end in any order", "[libenvpp_testing]")
+{
+	auto scoped_env1 = std::optional<env::scoped_test_environment>();
+	scoped_env1.emplace("LIBENVPP_TESTING1_INT", "42");
+	{
+		const auto scoped_env2 = env::scoped_test_environment("LIBENVPP_TESTING2_INT", "24");
+		scoped_env1.reset();
+		CHECK_FALSE(detail::g_testing_environment.find("LIBENVPP_TESTING1_INT").has_value());
+		CHECK(detail::g_testing_environment.find("LIBENVPP_TESTING2_INT") == "24");
+	}
+	CHECK(detail::g_testing_environment.empty());
+}
+
+TEST_CASE("Conflicting global testing environment is not applied partially", "[libenvpp_testing]")
+{
+	const auto scoped_env1 = env::scoped_test_environment("LIBENVPP_TESTING_INT", "42");
+	CHECK_THROWS_AS(env::scoped_test_environment({
+	                    {"LIBENVPP_TESTING_FLOAT", "3.1415"},
+	                    {"LIBENVPP_TESTING_INT", "24"},
+	                }),
+	                test_environment_error);
+	CHECK(detail::g_testing_environment.size() == 1);
+	CHECK_FALSE(detail::g_testing_environment.find("LIBENVPP_TESTING_FLOAT").has_value());
+}
+
 TEST_CASE("Global testing environment takes precedence over environment variables", "[libenvpp_testing]")
 {
 	const auto scoped_env_var = detail::set_scoped_environment_variable{"LIBENVPP_TESTING_INT", "7"};
@@ -284,4 +308,120 @@ TEST_CASE("Global testing environment takes precedence for prefixless variables"
 	}
 }
 
+
+TEST_CASE("Nested thread testing environments take precedence over outer ones", "[libenvpp_testing]")
+{
+	const auto outer = env::scoped_thread_test_environment({
+	    {"LIBENVPP_TESTING_INT", "1"},
+	    {"LIBENVPP_TESTING_FLOAT", "3.1415"},
+	});
+	CHECK(get_or<int>("LIBENVPP_TESTING_INT", 0) == 1);
+
+	SECTION("Conflicting inner scope")
+	{
+		const auto inner = env::scoped_thread_test_environment("LIBENVPP_TESTING_INT", "2");
+
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		const auto int_id = pre.register_required_variable<int>("INT");
+		const auto float_id = pre.register_required_variable<float>("FLOAT");
+		auto parsed_and_validated_pre = pre.parse_and_validate();
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(int_id) == 2);
+		CHECK(parsed_and_validated_pre.get(float_id) == 3.1415f);
+	}
+
+	CHECK(get_or<int>("LIBENVPP_TESTING_INT", 0) == 1);
+}
+
+TEST_CASE("Testing environment is read through without merging it into the environment", "[libenvpp_testing]")
+{
+	const auto environment = std::unordered_map<std::string, std::string>{
+	    {"LIBENVPP_TESTING_INT", "0"},
+	    {"LIBENVPP_TESTING_FLOAT", "2.71"},
+	};
+	const auto outer = env::scoped_thread_test_environment({
+	    {"LIBENVPP_TESTING_INT", "1"},
+	    {"LIBENVPP_TESTING_NAME", "outer"},
+	});
+	const auto inner = env::scoped_thread_test_environment("LIBENVPP_TESTING_INT", "2");
+
+	auto view = detail::testing_environment_view(environment);
+	CHECK(view.find("LIBENVPP_TESTING_INT") == "2");
+	CHECK(view.find("LIBENVPP_TESTING_NAME") == "outer");
+	CHECK(view.find("LIBENVPP_TESTING_FLOAT") == "2.71");
+	CHECK_FALSE(view.find("LIBENVPP_TESTING_OTHER").has_value());
+
+	const auto visited = [&view] {
+		auto variables = std::unordered_map<std::string, std::string>{};
+		view.for_each([&](const std::string_view name, const std::string_view value) {
+			CHECK(variables.emplace(name, value).second);
+		});
+		return variables;
+	};
+	CHECK(visited() == std::unordered_map<std::string, std::string>{
+	                       {"LIBENVPP_TESTING_INT", "2"},
+	                       {"LIBENVPP_TESTING_NAME", "outer"},
+	                       {"LIBENVPP_TESTING_FLOAT", "2.71"},
+	                   });
+
+	CHECK(view.find_similar("LIBENVPP_TESTING_IN", 2) == "LIBENVPP_TESTING_INT");
+	view.consume("LIBENVPP_TESTING_INT");
+	CHECK_FALSE(view.find_similar("LIBENVPP_TESTING_IN", 2).has_value());
+	CHECK(visited() == std::unordered_map<std::string, std::string>{
+	                       {"LIBENVPP_TESTING_NAME", "outer"},
+	                       {"LIBENVPP_TESTING_FLOAT", "2.71"},
+	                   });
+}
+
+TEST_CASE("Thread testing environment ignores global testing environment unless opted in", "[libenvpp_testing]")
+{
+	const auto global = env::scoped_test_environment({
+	    {"LIBENVPP_TESTING_INT", "1"},
+	    {"LIBENVPP_TESTING_FLOAT", "3.1415"},
+	});
+
+	SECTION("Ignore")
+	{
+		const auto local = env::scoped_thread_test_environment("LIBENVPP_TESTING_INT", "2");
+		CHECK(get_or<int>("LIBENVPP_TESTING_INT", 0) == 2);
+		CHECK_FALSE(get<float>("LIBENVPP_TESTING_FLOAT").has_value());
+	}
+	SECTION("Fallback")
+	{
+		const auto local =
+		    env::scoped_thread_test_environment("LIBENVPP_TESTING_INT", "2", global_test_environment::fallback);
+		CHECK(get_or<int>("LIBENVPP_TESTING_INT", 0) == 2);
+		CHECK(get_or<float>("LIBENVPP_TESTING_FLOAT", 0.f) == 3.1415f);
+	}
+
+	CHECK(get_or<int>("LIBENVPP_TESTING_INT", 0) == 1);
+}
+
+TEST_CASE("Thread testing environments of different threads are independent", "[libenvpp_testing]")
+{
+	constexpr auto thread_count = 8;
+	auto results = std::vector<std::optional<int>>(thread_count);
+	auto threads = std::vector<std::thread>{};
+	for (int i = 0; i < thread_count; ++i) {
+		threads.emplace_back([i, &result = results[i]] {
+			const auto _ = env::scoped_thread_test_environment("LIBENVPP_TESTING_INT", std::to_string(i));
+			for (int j = 0; j < 100; ++j) {
+				auto pre = env::prefix("LIBENVPP_TESTING");
+				const auto int_id = pre.register_required_variable<int>("INT");
+				auto parsed_and_validated_pre = pre.parse_and_validate();
+				result = parsed_and_validated_pre.get(int_id);
+				if (result != i) {
+					break;
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	for (int i = 0; i < thread_count; ++i) {
+		CHECK(results[i] == i);
+	}
+}
+
 } // namespace env
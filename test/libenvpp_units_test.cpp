@@ -0,0 +1,136 @@
+#include <chrono>
+#include <cstdint>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+#include <fmt/core.h>
+
+#include <libenvpp/detail/environment.hpp>
+#include <libenvpp/env.hpp>
+
+namespace env {
+
+using namespace std::chrono_literals;
+using Catch::Matchers::ContainsSubstring;
+
+TEST_CASE("Parsing durations", "[libenvpp_units]")
+{
+	SECTION("Units")
+	{
+		CHECK(default_parser<std::chrono::nanoseconds>{}("5ns") == 5ns);
+		CHECK(default_parser<std::chrono::nanoseconds>{}("5us") == 5us);
+		CHECK(default_parser<std::chrono::nanoseconds>{}("5\xc2\xb5s") == 5us);
+		CHECK(default_parser<std::chrono::milliseconds>{}("250ms") == 250ms);
+		CHECK(default_parser<std::chrono::milliseconds>{}("250 ms") == 250ms);
+		CHECK(default_parser<std::chrono::seconds>{}("30s") == 30s);
+		CHECK(default_parser<std::chrono::seconds>{}("2min") == 120s);
+		CHECK(default_parser<std::chrono::seconds>{}("2h") == 7200s);
+		CHECK(default_parser<std::chrono::hours>{}("2d") == 48h);
+	}
+
+	SECTION("Conversion and fractions")
+	{
+		CHECK(default_parser<std::chrono::milliseconds>{}("1.5s") == 1500ms);
+		CHECK(default_parser<std::chrono::milliseconds>{}("0.25min") == 15000ms);
+		CHECK(default_parser<std::chrono::minutes>{}("120s") == 2min);
+		CHECK(default_parser<std::chrono::seconds>{}("1.000s") == 1s);
+		CHECK(default_parser<std::chrono::milliseconds>{}("-250ms") == -250ms);
+		CHECK(default_parser<std::chrono::duration<double>>{}("250ms").count() == 0.25);
+		CHECK(default_parser<std::chrono::duration<double, std::milli>>{}("1.5us").count() == 0.0015);
+	}
+
+	SECTION("Inexact")
+	{
+		CHECK_THROWS_WITH(default_parser<std::chrono::milliseconds>{}("1.5ms"), ContainsSubstring("exactly"));
+		CHECK_THROWS_WITH(default_parser<std::chrono::minutes>{}("90s"), ContainsSubstring("exactly"));
+		CHECK_THROWS_WITH(default_parser<std::chrono::seconds>{}("1ns"), ContainsSubstring("exactly"));
+	}
+
+	SECTION("Overflow")
+	{
+		CHECK_THROWS_WITH(default_parser<std::chrono::nanoseconds>{}("300000d"), ContainsSubstring("out of range"));
+		CHECK_THROWS_WITH((default_parser<std::chrono::duration<std::int32_t, std::milli>>{}("30d")),
+		                  ContainsSubstring("out of range"));
+		CHECK_THROWS_WITH(default_parser<std::chrono::seconds>{}("99999999999999999999s"),
+		                  ContainsSubstring("out of range"));
+		CHECK_THROWS_WITH(default_parser<std::chrono::duration<std::uint32_t>>{}("-1s"),
+		                  ContainsSubstring("negative"));
+	}
+
+	SECTION("Ill-formed")
+	{
+		CHECK_THROWS_AS(default_parser<std::chrono::seconds>{}("30"), parser_error);
+		CHECK_THROWS_WITH(default_parser<std::chrono::seconds>{}("30"), ContainsSubstring("Missing unit"));
+		CHECK_THROWS_WITH(default_parser<std::chrono::seconds>{}("30sec"), ContainsSubstring("Unknown unit 'sec'"));
+		CHECK_THROWS_WITH(default_parser<std::chrono::seconds>{}("s"), ContainsSubstring("Cannot parse"));
+		CHECK_THROWS_AS(default_parser<std::chrono::seconds>{}(""), parser_error);
+		CHECK_THROWS_AS(default_parser<std::chrono::seconds>{}(" 1s"), parser_error);
+		CHECK_THROWS_AS(default_parser<std::chrono::seconds>{}("+1s"), parser_error);
+	}
+}
+
+TEST_CASE("Parsing byte sizes", "[libenvpp_units]")
+{
+	CHECK(default_parser<byte_size>{}("512") == byte_size{512});
+	CHECK(default_parser<byte_size>{}("512B") == byte_size{512});
+	CHECK(default_parser<byte_size>{}("64KiB") == byte_size{64 * 1024});
+	CHECK(default_parser<byte_size>{}("4GiB") == byte_size{std::uint64_t{4} << 30});
+	CHECK(default_parser<byte_size>{}("1.5GB") == byte_size{1'500'000'000});
+	CHECK(default_parser<byte_size>{}("1.5 KiB") == byte_size{1536});
+	CHECK(default_parser<byte_size>{}("2kB") == default_parser<byte_size>{}("2KB"));
+	CHECK(default_parser<byte_size>{}("15EiB") == byte_size{std::uint64_t{15} << 60});
+
+	CHECK_THROWS_WITH(default_parser<byte_size>{}("1.1B"), ContainsSubstring("exactly"));
+	CHECK_THROWS_WITH(default_parser<byte_size>{}("16EiB"), ContainsSubstring("out of range"));
+	CHECK_THROWS_WITH(default_parser<byte_size>{}("-1KiB"), ContainsSubstring("negative"));
+	CHECK_THROWS_WITH(default_parser<byte_size>{}("1kiB"), ContainsSubstring("Unknown unit 'kiB'"));
+}
+
+TEST_CASE("Formatting byte sizes", "[libenvpp_units]")
+{
+	CHECK(fmt::format("{}", byte_size{0}) == "0B");
+	CHECK(fmt::format("{}", byte_size{1000}) == "1000B");
+	CHECK(fmt::format("{}", byte_size{1536}) == "1536B");
+	CHECK(fmt::format("{}", byte_size{2048}) == "2KiB");
+	CHECK(fmt::format("{}", byte_size{std::uint64_t{4} << 30}) == "4GiB");
+}
+
+TEST_CASE("Unit variables", "[libenvpp_units]")
+{
+	auto pre = prefix("MYPROG");
+	const auto timeout_id = pre.register_required_variable<std::chrono::milliseconds>("TIMEOUT");
+	const auto cache_id = pre.register_range<byte_size>("CACHE", byte_size{1 << 20}, byte_size{std::uint64_t{8} << 30});
+	const auto interval_id = pre.register_range<std::chrono::seconds>("INTERVAL", 1s, 1h);
+
+	SECTION("Well-formed")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate(
+		    {{"MYPROG_TIMEOUT", "250ms"}, {"MYPROG_CACHE", "4GiB"}, {"MYPROG_INTERVAL", "5min"}});
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(timeout_id) == 250ms);
+		CHECK(parsed_and_validated_pre.get(cache_id) == byte_size{std::uint64_t{4} << 30});
+		CHECK(parsed_and_validated_pre.get(interval_id) == 5min);
+	}
+
+	SECTION("Out of range")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate(
+		    {{"MYPROG_TIMEOUT", "1s"}, {"MYPROG_CACHE", "16GiB"}, {"MYPROG_INTERVAL", "2h"}});
+		REQUIRE(parsed_and_validated_pre.errors().size() == 2);
+		CHECK(parsed_and_validated_pre.errors()[0].kind() == error_kind::range);
+		CHECK_THAT(parsed_and_validated_pre.error_message(),
+		           ContainsSubstring("Value 16GiB outside of range [1MiB, 8GiB]")
+		               && ContainsSubstring("Value 7200s outside of range [1s, 3600s]"));
+	}
+}
+
+TEST_CASE("Retrieving duration with get", "[libenvpp_units][get]")
+{
+	const auto _ = detail::set_scoped_environment_variable{"LIBENVPP_TESTING_DURATION", "1.5s"};
+
+	const auto duration = get<std::chrono::milliseconds>("LIBENVPP_TESTING_DURATION");
+	REQUIRE(duration.has_value());
+	CHECK(*duration == 1500ms);
+}
+
+} // namespace env
@@ -0,0 +1,500 @@
+// Generates a header containing a typed configuration struct, and a function parsing it from the environment, from a
+// JSON manifest of the form:
+//
+// {
+//     "prefix": "MYPROG",
+//     "namespace": "myprog",
+//     "struct": "config",
+//     "includes": ["<filesystem>"],
+//     "variables": [
+//         {"name": "LOG_FILE_PATH", "type": "std::filesystem::path"},
+//         {"name": "NUM_THREADS", "type": "unsigned int", "required": true, "member": "threads"}
+//     ]
+// }
+//
+// Usage: libenvpp_codegen <manifest.json> <output.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <libenvpp/detail/perfect_hash.hpp>
+
+namespace {
+
+class codegen_error : public std::runtime_error {
+  public:
+	codegen_error() = delete;
+	codegen_error(const std::string_view message) : std::runtime_error(std::string(message)) {}
+};
+
+struct json_value;
+using json_object = std::map<std::string, json_value, std::less<>>;
+using json_array = std::vector<json_value>;
+
+struct json_value {
+	std::variant<std::nullptr_t, bool, double, std::string, json_array, json_object> m_value;
+};
+
+// Minimal JSON parser, sufficient for manifests.
+class json_parser {
+  public:
+	explicit json_parser(const std::string_view text) : m_text(text) {}
+
+	[[nodiscard]] json_value parse()
+	{
+		auto value = parse_value();
+		skip_whitespace();
+		if (m_pos != m_text.size()) {
+			fail("Unexpected trailing characters");
+		}
+		return value;
+	}
+
+  private:
+	[[noreturn]] void fail(const std::string_view message) const
+	{
+		const auto line = std::count(m_text.begin(), m_text.begin() + static_cast<std::ptrdiff_t>(m_pos), '\n') + 1;
+		throw codegen_error{fmt::format("{} at line {}", message, line)};
+	}
+
+	void skip_whitespace()
+	{
+		while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) {
+			++m_pos;
+		}
+	}
+
+	[[nodiscard]] bool consume(const std::string_view token)
+	{
+		skip_whitespace();
+		if (m_text.substr(m_pos, token.size()) == token) {
+			m_pos += token.size();
+			return true;
+		}
+		return false;
+	}
+
+	void expect(const std::string_view token)
+	{
+		if (!consume(token)) {
+			fail(fmt::format("Expected '{}'", token));
+		}
+	}
+
+	[[nodiscard]] json_value parse_value()
+	{
+		skip_whitespace();
+		if (m_pos == m_text.size()) {
+			fail("Unexpected end of input");
+		}
+		const auto c = m_text[m_pos];
+		if (c == '{') {
+			return {parse_object()};
+		} else if (c == '[') {
+			return {parse_array()};
+		} else if (c == '"') {
+			return {parse_string()};
+		} else if (consume("true")) {
+			return {true};
+		} else if (consume("false")) {
+			return {false};
+		} else if (consume("null")) {
+			return {nullptr};
+		}
+		return {parse_number()};
+	}
+
+	[[nodiscard]] json_object parse_object()
+	{
+		expect("{");
+		auto object = json_object{};
+		if (consume("}")) {
+			return object;
+		}
+		do {
+			skip_whitespace();
+			auto key = parse_string();
+			expect(":");
+			if (!object.emplace(std::move(key), parse_value()).second) {
+				fail("Duplicate key");
+			}
+		} while (consume(","));
+		expect("}");
+		return object;
+	}
+
+	[[nodiscard]] json_array parse_array()
+	{
+		expect("[");
+		auto array = json_array{};
+		if (consume("]")) {
+			return array;
+		}
+		do {
+			array.push_back(parse_value());
+		} while (consume(","));
+		expect("]");
+		return array;
+	}
+
+	[[nodiscard]] std::string parse_string()
+	{
+		if (m_pos == m_text.size() || m_text[m_pos] != '"') {
+			fail("Expected string");
+		}
+		++m_pos;
+		auto str = std::string();
+		while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+			auto c = m_text[m_pos++];
+			if (c == '\\') {
+				if (m_pos == m_text.size()) {
+					break;
+				}
+				switch (c = m_text[m_pos++]) {
+				case '"':
+				case '\\':
+				case '/': break;
+				case 'n': c = '\n'; break;
+				case 't': c = '\t'; break;
+				default: fail("Unsupported escape sequence");
+				}
+			}
+			str += c;
+		}
+		if (m_pos == m_text.size()) {
+			fail("Unterminated string");
+		}
+		++m_pos;
+		return str;
+	}
+
+	[[nodiscard]] double parse_number()
+	{
+		const auto begin = m_pos;
+		constexpr auto number_chars = std::string_view("+-.eE0123456789");
+		while (m_pos < m_text.size() && number_chars.find(m_text[m_pos]) != std::string_view::npos) {
+			++m_pos;
+		}
+		if (begin == m_pos) {
+			fail("Unexpected character");
+		}
+		return std::stod(std::string(m_text.substr(begin, m_pos - begin)));
+	}
+
+	std::string_view m_text;
+	std::size_t m_pos = 0;
+};
+
+struct variable {
+	std::string name;
+	std::string full_name;
+	std::string type;
+	std::string member;
+	bool is_required;
+};
+
+struct manifest {
+	std::string prefix;
+	std::string name_space;
+	std::string struct_name;
+	std::vector<std::string> includes;
+	std::vector<variable> variables;
+};
+
+template <typename T>
+[[nodiscard]] const T* get_member(const json_object& object, const std::string_view key, const std::string_view context)
+{
+	const auto it = object.find(key);
+	if (it == object.end()) {
+		return nullptr;
+	}
+	const auto value = std::get_if<T>(&it->second.m_value);
+	if (!value) {
+		throw codegen_error{fmt::format("Invalid type of '{}' in {}", key, context)};
+	}
+	return value;
+}
+
+template <typename T>
+[[nodiscard]] const T& get_required_member(const json_object& object, const std::string_view key,
+                                           const std::string_view context)
+{
+	const auto value = get_member<T>(object, key, context);
+	if (!value) {
+		throw codegen_error{fmt::format("Missing '{}' in {}", key, context)};
+	}
+	return *value;
+}
+
+[[nodiscard]] bool is_identifier(const std::string_view str, const std::string_view extra_chars = {})
+{
+	return !str.empty() && !std::isdigit(static_cast<unsigned char>(str.front()))
+	       && std::all_of(str.begin(), str.end(), [&](const char c) {
+		          return std::isalnum(static_cast<unsigned char>(c)) || c == '_'
+		                 || extra_chars.find(c) != std::string_view::npos;
+	          });
+}
+
+// Keywords and alternative tokens up to C++20, none of which may be used as a member name.
+constexpr std::string_view CPP_KEYWORDS[] = {
+    "alignas",      "alignof",   "and",          "and_eq",      "asm",        "auto",          "bitand",
+    "bitor",        "bool",      "break",        "case",        "catch",      "char",          "char8_t",
+    "char16_t",     "char32_t",  "class",        "compl",       "concept",    "const",         "consteval",
+    "constexpr",    "constinit", "const_cast",   "continue",    "co_await",   "co_return",     "co_yield",
+    "decltype",     "default",   "delete",       "do",          "double",     "dynamic_cast",  "else",
+    "enum",         "explicit",  "export",       "extern",      "false",      "float",         "for",
+    "friend",       "goto",      "if",           "inline",      "int",        "long",          "mutable",
+    "namespace",    "new",       "noexcept",     "not",         "not_eq",     "nullptr",       "operator",
+    "or",           "or_eq",     "private",      "protected",   "public",     "register",      "reinterpret_cast",
+    "requires",     "return",    "short",        "signed",      "sizeof",     "static",        "static_assert",
+    "static_cast",  "struct",    "switch",       "template",    "this",       "thread_local",  "throw",
+    "true",         "try",       "typedef",      "typeid",      "typename",   "union",         "unsigned",
+    "using",        "virtual",   "void",         "volatile",    "wchar_t",    "while",         "xor",
+    "xor_eq",
+};
+
+// Identifiers starting with an underscore followed by an uppercase letter, or containing a double underscore, are
+// reserved for the implementation.
+[[nodiscard]] bool is_member_name(const std::string_view str)
+{
+	return is_identifier(str)
+	       && std::find(std::begin(CPP_KEYWORDS), std::end(CPP_KEYWORDS), str) == std::end(CPP_KEYWORDS)
+	       && !(str.size() >= 2 && str[0] == '_' && std::isupper(static_cast<unsigned char>(str[1])))
+	       && str.find("__") == std::string_view::npos;
+}
+
+[[nodiscard]] manifest read_manifest(const std::filesystem::path& path)
+{
+	auto file = std::ifstream(path, std::ios::binary);
+	if (!file) {
+		throw codegen_error{fmt::format("Failed to open manifest '{}'", path.string())};
+	}
+	const auto text = std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	const auto root_value = json_parser(text).parse();
+	const auto root = std::get_if<json_object>(&root_value.m_value);
+	if (!root) {
+		throw codegen_error{"Manifest must be a JSON object"};
+	}
+
+	auto result = manifest{};
+	result.prefix = get_required_member<std::string>(*root, "prefix", "manifest");
+	result.name_space = get_required_member<std::string>(*root, "namespace", "manifest");
+	result.struct_name = get_required_member<std::string>(*root, "struct", "manifest");
+	if (!is_identifier(result.prefix)) {
+		throw codegen_error{fmt::format("Invalid prefix '{}'", result.prefix)};
+	}
+	if (!is_identifier(result.name_space, ":")) {
+		throw codegen_error{fmt::format("Invalid namespace '{}'", result.name_space)};
+	}
+	if (!is_identifier(result.struct_name)) {
+		throw codegen_error{fmt::format("Invalid struct name '{}'", result.struct_name)};
+	}
+
+	if (const auto includes = get_member<json_array>(*root, "includes", "manifest")) {
+		for (const auto& include : *includes) {
+			const auto str = std::get_if<std::string>(&include.m_value);
+			const auto is_delimited = [&](const char open, const char close) {
+				return str->size() >= 2 && str->front() == open && str->back() == close;
+			};
+			if (!str || !(is_delimited('<', '>') || is_delimited('"', '"'))) {
+				throw codegen_error{"Includes must be strings of the form '<header>' or '\"header\"'"};
+			}
+			result.includes.push_back(*str);
+		}
+	}
+
+	auto names = std::set<std::string>{};
+	auto members = std::set<std::string>{};
+	for (const auto& var_value : get_required_member<json_array>(*root, "variables", "manifest")) {
+		const auto var_object = std::get_if<json_object>(&var_value.m_value);
+		if (!var_object) {
+			throw codegen_error{"Variables must be JSON objects"};
+		}
+		auto var = variable{};
+		var.name = get_required_member<std::string>(*var_object, "name", "variable");
+		const auto context = fmt::format("variable '{}'", var.name);
+		var.full_name = result.prefix + "_" + var.name;
+		var.type = get_required_member<std::string>(*var_object, "type", context);
+		const auto is_required = get_member<bool>(*var_object, "required", context);
+		var.is_required = is_required && *is_required;
+		const auto member = get_member<std::string>(*var_object, "member", context);
+		if (member) {
+			var.member = *member;
+		} else {
+			std::transform(var.name.begin(), var.name.end(), std::back_inserter(var.member),
+			               [](const char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+		}
+
+		if (!is_identifier(var.name)) {
+			throw codegen_error{fmt::format("Invalid name of {}", context)};
+		}
+		if (var.type.empty() || var.type.find_first_of(";{}") != std::string::npos) {
+			throw codegen_error{fmt::format("Invalid type of {}", context)};
+		}
+		if (!is_member_name(var.member)) {
+			if (member) {
+				throw codegen_error{fmt::format("Invalid member name of {}", context)};
+			}
+			throw codegen_error{fmt::format(
+			    "Default member name '{}' of {} is not a valid C++ identifier, set 'member'", var.member, context)};
+		}
+		if (!names.insert(var.name).second) {
+			throw codegen_error{fmt::format("Duplicate variable '{}'", var.name)};
+		}
+		if (!members.insert(var.member).second) {
+			throw codegen_error{fmt::format("Duplicate member name '{}'", var.member)};
+		}
+		result.variables.push_back(std::move(var));
+	}
+	return result;
+}
+
+struct perfect_hash_table {
+	std::vector<std::uint32_t> displacements;
+	std::vector<std::size_t> slots;
+};
+
+[[nodiscard]] perfect_hash_table build_perfect_hash_table(const std::vector<std::string_view>& keys)
+{
+	auto table = perfect_hash_table{std::vector<std::uint32_t>(env::detail::perfect_hash_bucket_count(keys.size())),
+	                                std::vector<std::size_t>(env::detail::perfect_hash_table_size(keys.size()))};
+	auto scratch = std::vector<std::size_t>(env::detail::perfect_hash_scratch_size(keys.size()));
+	env::detail::build_perfect_hash(keys.data(), keys.size(), table.displacements.data(), table.slots.data(),
+	                                scratch.data());
+	return table;
+}
+
+template <typename T>
+[[nodiscard]] std::string join(const std::vector<T>& values, const std::string_view format_string)
+{
+	auto str = std::string();
+	for (const auto& value : values) {
+		if (!str.empty()) {
+			str += ", ";
+		}
+		str += fmt::format(fmt::runtime(format_string), value);
+	}
+	return str;
+}
+
+[[nodiscard]] std::string generate_header(const manifest& mf, const std::filesystem::path& manifest_path)
+{
+	auto full_names = std::vector<std::string_view>{};
+	auto required = std::vector<std::string_view>{};
+	for (const auto& var : mf.variables) {
+		full_names.push_back(var.full_name);
+		required.emplace_back(var.is_required ? "true" : "false");
+	}
+	const auto table = build_perfect_hash_table(full_names);
+	const auto schema_name = mf.struct_name + "_schema";
+
+	auto out = std::string();
+	out += fmt::format("// Generated by libenvpp_codegen from '{}', do not edit.\n\n",
+	                   manifest_path.filename().string());
+	out += "#pragma once\n\n";
+	out += "#include <array>\n#include <cstddef>\n#include <cstdint>\n#include <optional>\n#include <string>\n"
+	       "#include <string_view>\n#include <unordered_map>\n#include <utility>\n\n";
+	out += "#include <libenvpp/detail/perfect_hash.hpp>\n#include <libenvpp/detail/schema.hpp>\n";
+	if (!mf.includes.empty()) {
+		out += "\n";
+		for (const auto& include : mf.includes) {
+			out += fmt::format("#include {}\n", include);
+		}
+	}
+
+	out += fmt::format("\nnamespace {} {{\n\n", mf.name_space);
+
+	out += fmt::format("struct {} {{\n", mf.struct_name);
+	for (const auto& var : mf.variables) {
+		if (var.is_required) {
+			out += fmt::format("\t{} {}{{}};\n", var.type, var.member);
+		} else {
+			out += fmt::format("\tstd::optional<{}> {};\n", var.type, var.member);
+		}
+	}
+	out += "};\n\n";
+
+	out += fmt::format("struct {} {{\n", schema_name);
+	out += fmt::format("\tstatic constexpr auto prefix = std::string_view{{\"{}_\"}};\n", mf.prefix);
+	out += fmt::format("\tstatic constexpr auto size = std::size_t{{{}}};\n", mf.variables.size());
+	out += fmt::format("\tstatic constexpr auto names = std::array<std::string_view, size>{{{}}};\n",
+	                   join(full_names, "\"{}\""));
+	out += fmt::format("\tstatic constexpr auto required = std::array<bool, size>{{{}}};\n", join(required, "{}"));
+	out += fmt::format("\tstatic constexpr auto displacements = std::array<std::uint32_t, {}>{{{}}};\n",
+	                   table.displacements.size(), join(table.displacements, "{}"));
+	out += fmt::format("\tstatic constexpr auto slots = std::array<std::size_t, {}>{{{}}};\n", table.slots.size(),
+	                   join(table.slots, "{}"));
+	out += "\n";
+	out += "\t[[nodiscard]] static constexpr std::size_t find(const std::string_view name) noexcept\n"
+	       "\t{\n"
+	       "\t\treturn env::detail::perfect_hash_find(name, names.data(), size, displacements.data(), "
+	       "displacements.size(),\n"
+	       "\t\t                                      slots.data(), slots.size());\n"
+	       "\t}\n";
+	out += "};\n\n";
+
+	out += fmt::format("[[nodiscard]] inline env::parsed_config<{0}>\n"
+	                   "parse_{0}(const std::unordered_map<std::string, std::string>& environment = "
+	                   "env::detail::get_environment())\n",
+	                   mf.struct_name);
+	out += "{\n";
+	out += "\t// The testing environment is read through before the environment considered for parsing.\n";
+	out += fmt::format("\tauto parser = env::detail::schema_parser<{}>(environment);\n", schema_name);
+	out += fmt::format("\tauto config = ::{}::{}{{}};\n", mf.name_space, mf.struct_name);
+	for (std::size_t i = 0; i < mf.variables.size(); ++i) {
+		const auto& var = mf.variables[i];
+		out += fmt::format("\tparser.parse_{}<{}, {}>(config.{});\n",
+		                   var.is_required ? "required" : "optional", i, var.type, var.member);
+	}
+	out += "\treturn parser.finish(std::move(config));\n";
+	out += "}\n\n";
+
+	out += fmt::format("}} // namespace {}\n", mf.name_space);
+	return out;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3) {
+		std::cerr << "Usage: " << argv[0] << " <manifest.json> <output.hpp>" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const auto manifest_path = std::filesystem::path(argv[1]);
+	const auto output_path = std::filesystem::path(argv[2]);
+	try {
+		const auto header = generate_header(read_manifest(manifest_path), manifest_path);
+
+		if (output_path.has_parent_path()) {
+			std::filesystem::create_directories(output_path.parent_path());
+		}
+		auto output = std::ofstream(output_path, std::ios::binary | std::ios::trunc);
+		output << header;
+		if (!output) {
+			throw codegen_error{fmt::format("Failed to write '{}'", output_path.string())};
+		}
+	} catch (const std::exception& e) {
+		std::cerr << manifest_path.string() << ": error: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}